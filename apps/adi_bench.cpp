@@ -0,0 +1,91 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "fdm_world_lib"  // IWYU pragma: keep
+
+//	strong scaling of the ADI line sweeps: one heston rollback on a fixed
+//	size by size grid, serial and then on pools of 2 up to all the cores
+//	  adi_bench [size = 512] [steps = 50] [threads = all cores]
+
+namespace {
+
+//	heston generator in (log spot, variance)
+void hestonOperator(int size, FdmOperator2d& op) {
+  const double kappa = 1.5, theta = 0.04, sigma = 0.3, rho = -0.7, r = 0.02;
+  const FdmGrid x = FdmGrid::uniform(std::log(100.0) - 2.0,
+                                     std::log(100.0) + 2.0, size);
+  const FdmGrid v = FdmGrid::uniform(0.0, 1.0, size);
+
+  FdmCoefficients2d coeffs;
+  coeffs.resize(size, size);
+  for (int i = 0; i < size; ++i)
+    for (int j = 0; j < size; ++j) {
+      coeffs.axx(i, j) = 0.5 * v[j];
+      coeffs.ayy(i, j) = 0.5 * sigma * sigma * v[j];
+      coeffs.axy(i, j) = rho * sigma * v[j];
+      coeffs.bx(i, j) = r - 0.5 * v[j];
+      coeffs.by(i, j) = kappa * (theta - v[j]);
+      coeffs.r(i, j) = -r;
+    }
+  op = FdmOperator2d(x, v);
+  op.assemble(coeffs);
+}
+
+//	fastest of repeats rollbacks of the call payoff, the last result in u
+double timed(const FdmOperator2d& op, ThreadPool* pool, int steps,
+             int repeats, mMatrix<double>& u) {
+  const int n = op.xSize();
+  const int m = op.ySize();
+  double best = HUGE_VAL;
+  for (int k = 0; k < repeats; ++k) {
+    u.resize(n, m);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < m; ++j)
+        u(i, j) = max(0.0, std::exp(op.x()[i]) - 100.0);
+
+    AdiSolver solver(op, AdiScheme::HundsdorferVerwer, 0.0, pool);
+    const auto start = std::chrono::steady_clock::now();
+    solver.rollback(u, 1.0, steps, 1);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = min(best, elapsed.count());
+  }
+
+  //	done
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int size = argc > 1 ? std::atoi(argv[1]) : 512;
+  const int steps = argc > 2 ? std::atoi(argv[2]) : 50;
+  const int cores = max(1, (int)std::thread::hardware_concurrency());
+  const int threads = argc > 3 ? std::atoi(argv[3]) : cores;
+
+  FdmOperator2d op;
+  hestonOperator(size, op);
+
+  mMatrix<double> serial, u;
+  const double t1 = timed(op, nullptr, steps, 3, serial);
+  std::cout << size << "x" << size << ", " << steps << " HV steps, " << cores
+            << " cores\n";
+  std::cout << "threads  seconds  speedup  efficiency  max diff\n";
+  std::cout << "      1  " << t1 << "  1  1  0\n";
+
+  for (int t = 2; t <= threads; ++t) {
+    ThreadPool pool(t);
+    const double s = timed(op, &pool, steps, 3, u);
+    double diff = 0.0;
+    for (int k = 0; k < u.size(); ++k)
+      diff = max(diff, std::fabs(u[k] - serial[k]));
+    std::cout << "      " << t << "  " << s << "  " << t1 / s << "  "
+              << t1 / s / t << "  " << diff << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+
+#include "fdm_world_lib"  // IWYU pragma: keep
+
+//	observed orders of the compact operators against the second order ones
+//	  1d: black calls at 80, 100 and 120 from BlackFdm::prices with n nodes,
+//	      against the exact formula
+//	  2d: heston atm call from HestonFdm::price with n x n / 2 nodes and HV,
+//	      against the Lewis integral
+//	with n^2 / 10 steps so that the second order time error stays below the
+//	space error, the order is log2 of the error ratio between n / 2 and n
+
+namespace {
+
+//	black with the exact normal cdf, Black::call approximates it to 1e-7
+double blackCall(double expiry, double strike, double forward, double vol) {
+  const double sd = vol * std::sqrt(expiry);
+  const double d1 = std::log(forward / strike) / sd + 0.5 * sd;
+  auto n = [](double x) { return 0.5 * std::erfc(-x / std::sqrt(2.0)); };
+  return forward * n(d1) - strike * n(d1 - sd);
+}
+
+double seconds(const std::chrono::steady_clock::time_point& start) {
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  return elapsed.count();
+}
+
+void oneDimension() {
+  const double expiry = 1.0, forward = 100.0, vol = 0.2;
+  mVector<double> strikes(3);
+  strikes[0] = 80.0;
+  strikes[1] = 100.0;
+  strikes[2] = 120.0;
+
+  std::cout << "1d black, max error over the strikes\n";
+  std::cout << "n  compact  order  second order  order\n";
+  double last[2] = {0.0, 0.0};
+  for (int n = 50; n <= 400; n *= 2) {
+    std::cout << n;
+    for (int c = 0; c < 2; ++c) {
+      FdmSettings1d settings;
+      settings.xSize = n;
+      settings.timeSteps = n * n / 10;
+      settings.compact = c == 0;
+      mVector<double> prices;
+      BlackFdm::prices(expiry, strikes, forward, vol, true, settings, prices);
+
+      double error = 0.0;
+      for (int j = 0; j < strikes.size(); ++j)
+        error = max(error, std::fabs(prices[j] - blackCall(expiry, strikes[j],
+                                                           forward, vol)));
+      std::cout << "  " << error << "  ";
+      if (last[c] > 0.0)
+        std::cout << std::log2(last[c] / error);
+      else
+        std::cout << "-";
+      last[c] = error;
+    }
+    std::cout << "\n";
+  }
+}
+
+void twoDimensions() {
+  HestonParams params;
+  params.kappa = 1.5;
+  params.eta = 0.04;
+  params.sigma = 0.3;
+  params.rho = -0.7;
+  params.v0 = 0.04;
+  HestonFdmProduct product;
+  const double spot = 100.0;
+  const double exact = Heston::call(product.expiry, product.strike, spot,
+                                    params);
+
+  std::cout << "2d heston atm, error and seconds\n";
+  std::cout << "n  compact  order  seconds  second order  order  seconds\n";
+  double last[2] = {0.0, 0.0};
+  for (int n = 40; n <= 160; n *= 2) {
+    std::cout << n;
+    for (int c = 0; c < 2; ++c) {
+      HestonFdmSettings settings;
+      settings.sSize = n;
+      settings.vSize = n / 2;
+      settings.timeSteps = n * n / 10;
+      settings.compact = c == 0;
+      const auto start = std::chrono::steady_clock::now();
+      const double price =
+          HestonFdm::price(spot, 0.0, 0.0, params, product, settings);
+      const double t = seconds(start);
+
+      const double error = std::fabs(price - exact);
+      std::cout << "  " << error << "  ";
+      if (last[c] > 0.0)
+        std::cout << std::log2(last[c] / error);
+      else
+        std::cout << "-";
+      std::cout << "  " << t;
+      last[c] = error;
+    }
+    std::cout << "\n";
+  }
+}
+
+}  // namespace
+
+int main() {
+  oneDimension();
+  twoDimensions();
+
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "fdm_world_lib"  // IWYU pragma: keep
+
+//	heston surface pricing, Carr-Madan FFT against COS on a slice of
+//	strikes over +-0.6 sqrt(T) in log strike per expiry, errors against the
+//	Lewis integral on every 7th strike
+//	  fft_bench [strikes = 600] [fft size = 4096] [cos terms = 128]
+
+namespace {
+
+//	microseconds per call, fastest of repeats batches of runs
+template <class F>
+double timed(const F& func, int runs, int repeats = 3) {
+  double best = HUGE_VAL;
+  for (int k = 0; k < repeats; ++k) {
+    const auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < runs; ++r) func();
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    best = min(best, elapsed.count() / runs);
+  }
+
+  //	done
+  return 1e6 * best;
+}
+
+double maxError(double expiry, const mVector<double>& strikes,
+                double forward, const HestonParams& params,
+                const mVector<double>& calls) {
+  double res = 0.0;
+  for (int j = 0; j < strikes.size(); j += 7)
+    res = max(res, std::fabs(calls[j] - Heston::call(expiry, strikes[j],
+                                                     forward, params)));
+
+  //	done
+  return res;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int m = argc > 1 ? std::atoi(argv[1]) : 600;
+  CarrMadanSettings fft;
+  if (argc > 2) fft.size = std::atoi(argv[2]);
+  HestonCosSettings series;
+  if (argc > 3) series.terms = std::atoi(argv[3]);
+
+  HestonParams params;
+  params.kappa = 1.5;
+  params.eta = 0.04;
+  params.sigma = 0.5;
+  params.rho = -0.7;
+  params.v0 = 0.05;
+  const double forward = 100.0;
+
+  std::cout << m << " strikes, FFT " << fft.size << " points, COS "
+            << series.terms << " terms\n";
+  std::cout << "expiry  FFT us  FFT error  COS us  COS error\n";
+
+  for (const double expiry : {0.1, 1.0, 5.0}) {
+    mVector<double> strikes(m), a, b;
+    for (int j = 0; j < m; ++j)
+      strikes[j] = forward * std::exp(std::sqrt(expiry) *
+                                      (-0.6 + 1.2 * j / max(m - 1, 1)));
+    auto phi = [&](complex<double> u) {
+      return Heston::charFunc(u, expiry, params);
+    };
+
+    const double tFft =
+        timed([&] { CarrMadan::calls(phi, forward, strikes, a, fft); }, 20);
+    const double tCos = timed(
+        [&] { Heston::calls(expiry, strikes, forward, params, b, series); },
+        20);
+    std::cout << expiry << "  " << tFft << "  "
+              << maxError(expiry, strikes, forward, params, a) << "  " << tCos
+              << "  " << maxError(expiry, strikes, forward, params, b)
+              << "\n";
+  }
+
+  return 0;
+}
@@ -0,0 +1,77 @@
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+
+#include "fdm_world_lib"  // IWYU pragma: keep
+
+//	cycles of the standalone multigrid and iterations of BiCGStab on
+//	I - thetaDt A over the unit square, axx = ayy = 0.5, from 33^2 nodes up
+//	to size^2 and on the even size - 1, theta dt / h^2 up to thousands
+//	  case 0: dirichlet sides
+//	  case 1: linear sides
+//	  case 2: dirichlet sides, mixed term, convection and discounting
+//	  multigrid_bench [case = 0] [size = 1025] [theta dt = 0.005]
+
+namespace {
+
+void run(int n, int variant, double thetaDt) {
+  const FdmGrid x = FdmGrid::uniform(0.0, 1.0, n);
+  const FdmGrid y = FdmGrid::uniform(0.0, 1.0, n);
+  FdmOperator2d op(x, y);
+  const FdmBoundary side =
+      variant == 1 ? FdmBoundary::Linear : FdmBoundary::Dirichlet;
+  op.setBoundaries(side, side, side, side);
+
+  FdmCoefficients2d coeffs;
+  coeffs.resize(n, n);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j) {
+      coeffs.axx(i, j) = 0.5;
+      coeffs.ayy(i, j) = 0.5;
+      if (variant == 2) {
+        coeffs.axy(i, j) = 0.3;
+        coeffs.bx(i, j) = 0.5;
+        coeffs.by(i, j) = -0.3;
+        coeffs.r(i, j) = -0.05;
+      }
+    }
+  op.assemble(coeffs);
+
+  MultigridSettings settings;
+  settings.maxIterations = 60;
+  Multigrid2d mg(op, settings);
+  mg.setup(thetaDt);
+
+  mMatrix<double> f(n, n), u(n, n, 0.0), v(n, n, 0.0);
+  for (int i = 0; i < n; ++i)
+    for (int j = 0; j < n; ++j)
+      f(i, j) = 1.0 + std::sin(3.0 * x[i]) * std::cos(2.0 * y[j]);
+
+  const auto start = std::chrono::steady_clock::now();
+  const int cycles = mg.solve(f, u);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+  const double res = mg.residual();
+  const int iterations = mg.bicgstab(f, v);
+
+  std::cout << n << "  " << thetaDt * (n - 1) * (n - 1) << "  " << mg.levels()
+            << "  " << cycles << "  " << res << "  " << 1e3 * elapsed.count()
+            << "  " << iterations << "  " << mg.residual() << "\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  const int variant = argc > 1 ? std::atoi(argv[1]) : 0;
+  const int size = argc > 2 ? std::atoi(argv[2]) : 1025;
+  const double thetaDt = argc > 3 ? std::atof(argv[3]) : 0.005;
+
+  std::cout << "case " << variant << ", theta dt " << thetaDt << "\n";
+  std::cout << "n  theta dt / h^2  levels  V cycles  residual  ms  BiCGStab  "
+               "residual\n";
+  for (int n = 33; n <= size; n = 2 * n - 1) run(n, variant, thetaDt);
+  run(size - 1, variant, thetaDt);
+
+  return 0;
+}
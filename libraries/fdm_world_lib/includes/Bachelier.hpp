@@ -25,6 +25,11 @@ class Bachelier {
   //	implied
   static double implied(double expiry, double strike, double price,
                         double forward);
+
+  //	calls on every strike with its own volatility, e.g. from a smile
+  static void calls(double expiry, const mVector<double>& strikes,
+                    double forward, const mVector<double>& volatilities,
+                    mVector<double>& res);
 };
 
 //	call
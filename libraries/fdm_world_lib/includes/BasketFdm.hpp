@@ -0,0 +1,63 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_BASKET_FDM_HPP
+#define FDM_WORLD_LIB_BASKET_FDM_HPP
+
+#include "adi3d.hpp"
+#include "sparseGrid.hpp"
+
+//	european option on sum_i w_i S_i
+struct BasketFdmProduct {
+  double expiry{1.0};
+  double strike{100.0};
+  bool isCall{true};
+  mVector<double> weights;
+};
+
+//	sub-grid n_l = baseSize 2^l + 1 nodes per direction, combined up to
+//	level, the full grid of the same level has baseSize 2^level + 1 nodes
+//	per direction
+struct BasketFdmSettings {
+  int baseSize{8};
+  int level{4};
+  int timeSteps{50};
+  int dampingSteps{1};
+  AdiScheme scheme{AdiScheme::HundsdorferVerwer};
+  double theta{0.0};           //	<= 0: scheme default
+  double stdDevs{5.0};         //	grid half width in log spot
+  ThreadPool* pool{nullptr};  //	sub-grids in parallel when given
+};
+
+//	basket of two or three correlated black-scholes assets
+//	  dS_i = (r - q_i) S_i dt + sigma_i S_i dW_i,  dW_i dW_j = rho_ij dt
+//	in log spot with the 2d or 3d ADI engine, priced by the sparse grid
+//	combination technique
+//	the engines stop at three dimensions: solve() and price() throw a
+//	runtime_error for any other number of assets, or when the vols,
+//	dividends, weights, correlations or sizes do not match the spots
+class BasketFdm {
+ public:
+  //	uniform log spot grid of asset i, centred at the forward
+  static FdmGrid makeGrid(double spot, double volatility, double rate,
+                          double dividend, double expiry, double stdDevs,
+                          int size);
+
+  //	price on the full grid with sizes[i] nodes for asset i, the line
+  //	sweeps on the pool when given
+  static double solve(const mVector<double>& spots,
+                      const mVector<double>& vols,
+                      const mMatrix<double>& correlations, double rate,
+                      const mVector<double>& dividends,
+                      const BasketFdmProduct& product,
+                      const BasketFdmSettings& settings,
+                      const vector<int>& sizes, ThreadPool* pool = nullptr);
+
+  //	price by the combination technique, one serial solve() per sub-grid
+  static double price(const mVector<double>& spots,
+                      const mVector<double>& vols,
+                      const mMatrix<double>& correlations, double rate,
+                      const mVector<double>& dividends,
+                      const BasketFdmProduct& product,
+                      const BasketFdmSettings& settings);
+};
+
+#endif  // FDM_WORLD_LIB_BASKET_FDM_HPP
@@ -0,0 +1,158 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_BLACK_FDM_HPP
+#define FDM_WORLD_LIB_BLACK_FDM_HPP
+
+#include "fokkerPlanck.hpp"
+#include "thetaScheme.hpp"
+
+//	black model on the forward, dF = sigma F dW, by finite differences
+//	prices are undiscounted as in Black::call
+class BlackFdm {
+ public:
+  //	forward grid concentrated at the forward and wide enough for all strikes
+  static FdmGrid makeGrid(double expiry, double forward, double volatility,
+                          const mVector<double>& strikes,
+                          const FdmSettings1d& settings);
+
+  //	operator u_t = 1/2 sigma^2 F^2 u_FF on the grid
+  static void buildOperator(double volatility, FdmOperator1d& op);
+
+  //	calls or puts on every strike from a single grid solve, the strikes are
+  //	the columns of the terminal condition, with optional discrete events
+  //	(monitored barriers, dividends, exercise dates on makeGrid())
+  static void prices(double expiry, const mVector<double>& strikes,
+                     double forward, double volatility, bool isCall,
+                     const FdmSettings1d& settings, mVector<double>& prices,
+                     const FdmEventSchedule* events = nullptr);
+
+  //	calls on every strike (cols) and maturity (rows) from one forward
+  //	Fokker-Planck solve, consistent to rounding with the backward prices()
+  //	on the same grids below
+  static void callSurface(const mVector<double>& maturities,
+                          const mVector<double>& strikes, double forward,
+                          double volatility, const FdmSettings1d& settings,
+                          mMatrix<double>& surface);
+
+  //	calls or puts at one maturity of callSurface() from a backward solve on
+  //	its grids, x = makeGrid() at the last maturity and times =
+  //	FdmTimeGrid::make(maturities, timeSteps, theta, dampingSteps), equal to
+  //	the surface row to rounding, expiry must be a node of times
+  static void prices(const FdmGrid& x, const FdmTimeGrid& times,
+                     double expiry, const mVector<double>& strikes,
+                     double forward, double volatility, bool isCall,
+                     mVector<double>& prices);
+
+  //	grid greeks at the forward on every strike from one solve
+  static void greeks(double expiry, const mVector<double>& strikes,
+                     double forward, double volatility, bool isCall,
+                     const FdmSettings1d& settings, FdmGreeks& greeks,
+                     const FdmEventSchedule* events = nullptr);
+
+  //	call
+  static double call(double expiry,  //	in years
+                     double strike, double forward, double volatility,
+                     const FdmSettings1d& settings);
+};
+
+//	bump and reval context of one trade: the grid, the payoff, the events,
+//	the cached operator stencils and the base solution are kept between
+//	revaluations
+//	a rate bump only moves the forward and the discount, it re-reads the
+//	base solution without any solve; a volatility bump rescales the cached
+//	diffusion stencil and refactorises once for the whole solve
+class BlackFdmReval {
+ public:
+  //	c'tor, solves the base case
+  BlackFdmReval(double expiry, const mVector<double>& strikes, double forward,
+                double volatility, bool isCall, const FdmSettings1d& settings,
+                const FdmEventSchedule* events = nullptr);
+
+  BlackFdmReval(const BlackFdmReval&) = delete;
+  BlackFdmReval& operator=(const BlackFdmReval&) = delete;
+
+  //	base greeks at the forward
+  const FdmGreeks& greeks() const { return myGreeks; }
+
+  //	prices at a bumped volatility and forward on the same grid, the
+  //	solution of the last volatility is kept for the next call
+  void reval(double volatility, double forward, mVector<double>& prices);
+
+ private:
+  double myExpiry;
+  double myVolatility;
+  FdmSettings1d mySettings;
+  FdmEventSchedule myEvents;
+
+  FdmOperator1d myOp;
+  ThetaSolver mySolver;
+  mMatrix<double> myPayoff;
+
+  //	base and last bumped solutions at t = 0
+  mMatrix<double> myBase, myBumped;
+  double myBumpedVolatility{-1.0};
+
+  FdmGreeks myGreeks;
+};
+
+//	thresholds of the warm start, past them the trade is solved from scratch
+struct FdmWarmStartSettings {
+  double maxShift{0.5};      //	forward move in grid standard deviations
+  double maxVariance{0.25};  //	relative move of the total variance
+  int slices{10};            //	last time steps of a full solve kept
+};
+
+//	warm start context of one trade for intraday repricing: the grid, the
+//	operator with its factorisation and the last slices of the last full
+//	solve are kept between reprices
+//	the solution on the grid is the price as a function of the forward, a
+//	forward move within maxShift only re-reads it, the grid is re-centred by
+//	a full solve past it
+//	with the operator of the solved volatility s0, a volatility s and expiry
+//	T are the time T s^2 / s0^2 of the kept solve: a smaller one restarts
+//	from the nearest kept slice below it and a larger one from the last, and
+//	only the steps in between are solved
+class BlackFdmWarmStart {
+ public:
+  //	c'tor, nothing is solved before the first reprice
+  BlackFdmWarmStart(const mVector<double>& strikes, bool isCall,
+                    const FdmSettings1d& settings,
+                    const FdmWarmStartSettings& warm = {});
+
+  BlackFdmWarmStart(const BlackFdmWarmStart&) = delete;
+  BlackFdmWarmStart& operator=(const BlackFdmWarmStart&) = delete;
+
+  //	prices on every strike, incrementally when within the thresholds
+  void prices(double expiry, double forward, double volatility,
+              mVector<double>& prices);
+
+  //	funcs
+  int fullSolves() const { return myFullSolves; }
+  int warmSteps() const { return myWarmSteps; }
+
+ private:
+  //	new grid and operator around the forward, rolled back storing slices
+  void solve(double expiry, double forward, double volatility);
+
+  mVector<double> myStrikes;
+  bool myIsCall;
+  FdmSettings1d mySettings;
+  FdmWarmStartSettings myWarm;
+
+  //	state of the last full solve
+  double myExpiry{0.0}, myForward{0.0}, myVolatility{0.0};
+  FdmOperator1d myOp;
+  ThetaSolver mySolver;
+
+  //	slices at the times mySliceTimes, increasing, the last at myExpiry
+  vector<mMatrix<double>> mySlices;
+  vector<double> mySliceTimes;
+
+  //	last warm solution at the time myTime of the kept solve
+  mMatrix<double> myU;
+  double myTime{-1.0};
+
+  int myFullSolves{0};
+  int myWarmSteps{0};
+};
+
+#endif  // FDM_WORLD_LIB_BLACK_FDM_HPP
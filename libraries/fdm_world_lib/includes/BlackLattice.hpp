@@ -0,0 +1,41 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_BLACK_LATTICE_HPP
+#define FDM_WORLD_LIB_BLACK_LATTICE_HPP
+
+#include "mVector.hpp"
+
+enum class LatticeType {
+  CoxRossRubinstein,  //	u = exp(sigma sqrt(dt)), d = 1 / u
+  LeisenReimer,       //	binomial matched to the strike by Peizer-Pratt
+                      //	inversion, second order, odd steps
+  Trinomial           //	u = exp(sigma sqrt(3 dt)), Kamrad & Ritchken
+};
+
+struct LatticeSettings {
+  LatticeType type{LatticeType::LeisenReimer};
+  int steps{201};
+};
+
+//	black scholes on the spot with continuous rate and dividend yield by
+//	recombining lattices, a fast independent control for the european and
+//	american prices of the finite difference engine
+//	prices are discounted, unlike BlackFdm
+//	backward induction runs in place in one mVector of values next to one of
+//	spots, no allocation past the first strike, and each level is a
+//	contiguous loop without branches the compiler vectorises, max against
+//	exercise included
+class BlackLattice {
+ public:
+  //	call or put, american when exercisable at every step
+  static double price(double expiry, double strike, double spot, double rate,
+                      double dividend, double volatility, bool isCall,
+                      bool isAmerican, const LatticeSettings& settings = {});
+
+  //	same on every strike, with the buffers of the first one
+  static void prices(double expiry, const mVector<double>& strikes,
+                     double spot, double rate, double dividend,
+                     double volatility, bool isCall, bool isAmerican,
+                     const LatticeSettings& settings, mVector<double>& prices);
+};
+
+#endif  // FDM_WORLD_LIB_BLACK_LATTICE_HPP
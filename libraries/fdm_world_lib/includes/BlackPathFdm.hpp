@@ -0,0 +1,34 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_BLACK_PATH_FDM_HPP
+#define FDM_WORLD_LIB_BLACK_PATH_FDM_HPP
+
+#include "BlackFdm.hpp"
+#include "sliceSolver.hpp"
+
+//	discretely monitored path dependent options in the black model on the
+//	forward, one slice per node of the auxiliary state, undiscounted
+class BlackPathFdm {
+ public:
+  //	fixed strike option on the arithmetic average of the fixings, the last
+  //	fixing at expiry
+  static double asian(const mVector<double>& fixings, double strike,
+                      double forward, double volatility, bool isCall,
+                      const FdmSettings1d& settings, int stateSize = 50,
+                      ThreadPool* pool = nullptr);
+
+  //	fixed strike option on the maximum of the forward today and the
+  //	fixings, the last fixing at expiry
+  static double lookback(const mVector<double>& fixings, double strike,
+                         double forward, double volatility, bool isCall,
+                         const FdmSettings1d& settings, int stateSize = 50,
+                         ThreadPool* pool = nullptr);
+
+ private:
+  //	rolls the payoff on the state grid back and reads V(a0, forward)
+  static double price(const FdmGrid& a, const mVector<double>& fixings,
+                      double strike, double forward, double volatility,
+                      bool isCall, const FdmSettings1d& settings, double a0,
+                      const FdmFixing& update, ThreadPool* pool);
+};
+
+#endif  // FDM_WORLD_LIB_BLACK_PATH_FDM_HPP
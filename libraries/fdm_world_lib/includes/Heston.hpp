@@ -0,0 +1,57 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_HESTON_HPP
+#define FDM_WORLD_LIB_HESTON_HPP
+
+#include <complex>
+
+#include "specialFunctions.hpp"
+
+using std::complex;
+
+//	heston parameters
+//	  dS / S = (r - q) dt + sqrt(v) dW1
+//	  dv = kappa (eta - v) dt + sigma sqrt(v) dW2, <dW1, dW2> = rho dt
+struct HestonParams {
+  double kappa{1.0};
+  double eta{0.04};
+  double sigma{0.3};
+  double rho{-0.7};
+  double v0{0.04};
+};
+
+//	series of the COS method
+struct HestonCosSettings {
+  int terms{128};      //	cosine terms
+  double width{12.0};  //	half range in std devs of log(F_T / F_0)
+};
+
+//	class
+class Heston {
+ public:
+  //	characteristic function E[exp(i u log(F_T / F_0))]
+  static complex<double> charFunc(complex<double> u, double expiry,
+                                  const HestonParams& params);
+
+  //	call, undiscounted, semi analytic (Lewis formula)
+  static double call(double expiry,  //	in years
+                     double strike, double forward,
+                     const HestonParams& params);
+
+  //	mean and variance of log(F_T / F_0), the mean in closed form and the
+  //	variance from the characteristic function
+  static void cumulants(double expiry, const HestonParams& params, double& c1,
+                        double& c2);
+
+  //	calls on every strike, undiscounted, by the COS method of Fang &
+  //	Oosterlee (2008): puts from a cosine expansion of the density of
+  //	log(F_T / K) on one range covering all the strikes, then parity
+  //	the characteristic function is evaluated once per term for the whole
+  //	slice, each strike is then a Horner sum of the terms in powers of
+  //	exp(i pi log(F / K) / range), vectorised across the strikes
+  static void calls(double expiry, const mVector<double>& strikes,
+                    double forward, const HestonParams& params,
+                    mVector<double>& calls,
+                    const HestonCosSettings& settings = {});
+};
+
+#endif  // FDM_WORLD_LIB_HESTON_HPP
@@ -0,0 +1,83 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_HESTON_FDM_HPP
+#define FDM_WORLD_LIB_HESTON_FDM_HPP
+
+#include "Heston.hpp"
+#include "adiAdjoint.hpp"
+
+//	european option, optionally knocked out (no rebate) on continuous barriers
+struct HestonFdmProduct {
+  double expiry{1.0};
+  double strike{100.0};
+  bool isCall{true};
+  double lowerBarrier{0.0};  //	0 = none
+  double upperBarrier{0.0};  //	0 = none
+};
+
+//	grid and scheme
+struct HestonFdmSettings {
+  int sSize{100};
+  int vSize{50};
+  int timeSteps{50};
+  int dampingSteps{1};
+  AdiScheme scheme{AdiScheme::HundsdorferVerwer};
+  double theta{0.0};           //	<= 0: scheme default
+  ThreadPool* pool{nullptr};  //	parallel line sweeps when given
+  bool compact{false};         //	fourth order compact operator in price()
+  FdmConvection convection{FdmConvection::Central};  //	in price()
+};
+
+//	gradient of the price from one adjoint sweep
+struct HestonFdmGradient {
+  double spot{0.0}, rate{0.0}, dividend{0.0};
+  double kappa{0.0}, eta{0.0}, sigma{0.0}, rho{0.0}, v0{0.0};
+
+  //	with respect to the operator coefficients on every node
+  FdmCoefficients2d coefficients;
+
+  //	recomputation of the reverse sweep
+  RevolveStats checkpoints;
+};
+
+//	heston pricer on the (s, v) grid with ADI time stepping
+class HestonFdm {
+ public:
+  //	grids, s concentrated at the strike and v concentrated at zero as in
+  //	In 't Hout & Foulon (2010)
+  static void makeGrids(const HestonFdmProduct& product,
+                        const HestonFdmSettings& settings, FdmGrid& s,
+                        FdmGrid& v);
+
+  //	heston operator on the grids, barriers are dirichlet sides
+  static void buildOperator(double rate, double dividend,
+                            const HestonParams& params,
+                            const HestonFdmProduct& product, FdmOperator2d& op);
+
+  //	cell averaged payoff on the grid, smoothed to fourth order on compact
+  //	operators, zero on the barriers
+  static void payoff(const HestonFdmProduct& product, const FdmOperator2d& op,
+                     mMatrix<double>& u);
+
+  //	value at (s, v) interpolated from the grid
+  static double valueAt(const FdmOperator2d& op, const mMatrix<double>& u,
+                        double s, double v);
+
+  //	price, the solution on the grid is returned in values when given
+  static double price(double spot, double rate, double dividend,
+                      const HestonParams& params,
+                      const HestonFdmProduct& product,
+                      const HestonFdmSettings& settings,
+                      mMatrix<double>* values = nullptr);
+
+  //	price and its gradient with respect to the spot, rates, parameters and
+  //	every coefficient node at about the cost of three pricings, holding
+  //	budget solutions as in AdiAdjoint, serial
+  static double sensitivities(double spot, double rate, double dividend,
+                              const HestonParams& params,
+                              const HestonFdmProduct& product,
+                              const HestonFdmSettings& settings,
+                              HestonFdmGradient& gradient,
+                              int budget = 0);
+};
+
+#endif  // FDM_WORLD_LIB_HESTON_FDM_HPP
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_HESTON_HULL_WHITE_FDM_HPP
+#define FDM_WORLD_LIB_HESTON_HULL_WHITE_FDM_HPP
+
+#include "HestonFdm.hpp"
+#include "adi3d.hpp"
+#include "profiler.hpp"
+
+//	hull-white short rate dr = a (b - r) dt + sigma dW_r
+struct HullWhiteParams {
+  double a{0.05};
+  double b{0.03};
+  double sigma{0.01};
+  double r0{0.03};
+};
+
+//	grid and scheme
+struct HestonHullWhiteFdmSettings {
+  int sSize{60};
+  int vSize{30};
+  int rSize{20};
+  int timeSteps{50};
+  int dampingSteps{1};
+  AdiScheme scheme{AdiScheme::HundsdorferVerwer};
+  double theta{0.0};           //	<= 0: scheme default
+  ThreadPool* pool{nullptr};  //	parallel line sweeps when given
+};
+
+//	heston with hull-white rates on the (s, v, r) grid with 3d ADI
+//	  dS = (r - q) S dt + sqrt(v) S dW_s
+//	  dv = kappa (eta - v) dt + sigma sqrt(v) dW_v
+//	correlations rho (s, v) from the heston parameters, rhoSr and rhoVr
+//	with the rate, the price is discounted along the rate paths
+class HestonHullWhiteFdm {
+ public:
+  //	s and v grids as HestonFdm, r uniform over 5 standard deviations of
+  //	the rate at expiry around r0 and b
+  static void makeGrids(const HestonFdmProduct& product,
+                        const HullWhiteParams& rates,
+                        const HestonHullWhiteFdmSettings& settings,
+                        FdmGrid& s, FdmGrid& v, FdmGrid& r);
+
+  //	operator on the grids, every coefficient is one or two separable terms
+  static void buildOperator(double dividend, const HestonParams& params,
+                            const HullWhiteParams& rates, double rhoSr,
+                            double rhoVr, const HestonFdmProduct& product,
+                            FdmOperator3d& op);
+
+  //	value at (s, v, r) interpolated from the grid
+  static double valueAt(const FdmOperator3d& op, const mCube<double>& u,
+                        double s, double v, double r);
+
+  //	price, the rollback is timed as "rollback" when a profiler is given
+  static double price(double spot, double dividend, const HestonParams& params,
+                      const HullWhiteParams& rates, double rhoSr,
+                      double rhoVr, const HestonFdmProduct& product,
+                      const HestonHullWhiteFdmSettings& settings,
+                      Profiler* profiler = nullptr);
+};
+
+#endif  // FDM_WORLD_LIB_HESTON_HULL_WHITE_FDM_HPP
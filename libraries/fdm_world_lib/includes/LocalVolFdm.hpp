@@ -0,0 +1,67 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_LOCAL_VOL_FDM_HPP
+#define FDM_WORLD_LIB_LOCAL_VOL_FDM_HPP
+
+#include "fokkerPlanck.hpp"
+#include "localVolSurface.hpp"
+#include "profiler.hpp"
+#include "thetaAdjoint.hpp"
+#include "thetaScheme.hpp"
+
+//	local volatility on the forward, dF = sigma(t, F) F dW, by finite
+//	differences, prices are undiscounted as in Black::call
+//	the operator is assembled once with unit volatility, every step then
+//	samples the surface on the grid nodes and rescales the cached diffusion
+//	stencil, timed as "assembly" apart from the "solve" of the step
+class LocalVolFdm {
+ public:
+  //	forward grid as BlackFdm with the local volatility at the forward
+  static FdmGrid makeGrid(double expiry, double forward,
+                          const LocalVolSurface& surface,
+                          const mVector<double>& strikes,
+                          const FdmSettings1d& settings);
+
+  //	operator u_t = 1/2 F^2 u_FF, to be scaled by sigma^2(t, F)
+  static void buildOperator(FdmOperator1d& op);
+
+  //	calls or puts on every strike from one backward solve on the grid and
+  //	the time grid of callSurface(), the surface is sampled at the middle
+  //	of every step
+  static void prices(double expiry, const mVector<double>& strikes,
+                     double forward, const LocalVolSurface& surface,
+                     bool isCall, const FdmSettings1d& settings,
+                     mVector<double>& prices, Profiler* profiler = nullptr);
+
+  //	calls on every strike (cols) and maturity (rows) from one forward
+  //	Fokker-Planck solve
+  static void callSurface(const mVector<double>& maturities,
+                          const mVector<double>& strikes, double forward,
+                          const LocalVolSurface& surface,
+                          const FdmSettings1d& settings,
+                          mMatrix<double>& calls,
+                          Profiler* profiler = nullptr);
+
+  //	call or put discounted with the short rate r(t), linear in the rate
+  //	nodes and flat outside, the forward kept fixed
+  //	one adjoint sweep of the same backward solve gives the gradient with
+  //	respect to every lattice vol of the surface (times by strikes) and to
+  //	every rate node, returns the price
+  //	budget states are held as in ThetaAdjoint, the recomputation is
+  //	reported in checkpoints when given
+  static double sensitivities(double expiry, double strike, double forward,
+                              const LocalVolSurface& surface,
+                              const mVector<double>& rateTimes,
+                              const mVector<double>& rates, bool isCall,
+                              const FdmSettings1d& settings,
+                              mMatrix<double>& volGradient,
+                              mVector<double>& rateGradient,
+                              int budget = 0,
+                              RevolveStats* checkpoints = nullptr);
+
+ private:
+  //	sample the surface at t on the nodes and rescale the operator
+  static void refresh(const LocalVolSurface& surface, double t,
+                      mVector<double>& vols, FdmOperator1d& op);
+};
+
+#endif  // FDM_WORLD_LIB_LOCAL_VOL_FDM_HPP
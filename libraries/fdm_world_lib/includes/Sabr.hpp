@@ -0,0 +1,63 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_SABR_HPP
+#define FDM_WORLD_LIB_SABR_HPP
+
+#include "solver.hpp"
+
+//	sabr parameters, shifted by shift
+//	  dF = alpha C(F) dW1, C(F) = (F + shift)^beta
+//	  dalpha = nu alpha dW2, <dW1, dW2> = rho dt
+//	beta = 0 is the normal variant, F is then unbounded below
+struct SabrParams {
+  double alpha{0.2};
+  double beta{0.5};
+  double rho{-0.3};
+  double nu{0.4};
+  double shift{0.0};
+};
+
+//	hagan et al. (2002) closed form expansions
+class Sabr {
+ public:
+  //	lognormal volatility of the shifted forward and strike
+  static double blackVol(double expiry,  //	in years
+                         double strike, double forward,
+                         const SabrParams& params);
+
+  //	normal volatility
+  static double normalVol(double expiry,  //	in years
+                          double strike, double forward,
+                          const SabrParams& params);
+
+  //	call, undiscounted: bachelier on the normal volatility when beta = 0,
+  //	black on the shifted forward otherwise
+  static double call(double expiry,  //	in years
+                     double strike, double forward, const SabrParams& params);
+
+  //	on every strike, the volatility call() prices with: normal when beta =
+  //	0, lognormal of the shifted forward otherwise
+  static void vols(double expiry, const mVector<double>& strikes,
+                   double forward, const SabrParams& params,
+                   mVector<double>& res);
+
+  //	calls on every strike
+  static void calls(double expiry, const mVector<double>& strikes,
+                    double forward, const SabrParams& params,
+                    mVector<double>& res);
+
+  //	alpha, rho and nu fitted to a slice of vols() quotes by least squares
+  //	on the volatilities, beta and the shift kept, from params with alpha
+  //	first rescaled to the quote nearest the money, finite difference
+  //	jacobian
+  static bool fit(double expiry, const mVector<double>& strikes,
+                  double forward, const mVector<double>& vols,
+                  SabrParams& params,
+                  const LevenbergMarquardtSettings& settings = {},
+                  LevenbergMarquardtReport* report = nullptr);
+
+ private:
+  //	z / x(z)
+  static double zOverX(double z, double rho);
+};
+
+#endif  // FDM_WORLD_LIB_SABR_HPP
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_SABR_FDM_HPP
+#define FDM_WORLD_LIB_SABR_FDM_HPP
+
+#include "Sabr.hpp"
+#include "fokkerPlanck.hpp"
+#include "thetaScheme.hpp"
+
+//	arbitrage free sabr (hagan, kumar, lesniewski, woodward 2014)
+//	the density Q of the forward solves the effective 1d equation
+//	  Q_t = (1/2 D^2(F) E(t, F) Q)_FF
+//	  D(F) = sqrt(alpha^2 + 2 rho alpha nu y + nu^2 y^2) C(F),
+//	  y(F) = int_f^F du / C(u)
+//	  E(t, F) = exp(rho nu alpha G(F) t), G(F) = (C(F) - C(f)) / (F - f)
+//	discretised as the exact transpose of the backward operator on a grid
+//	uniform in the sabr distance z: total mass and the mean of F are kept to
+//	rounding, the boundary nodes absorb the mass that leaves the grid and
+//	calls are sums of positive probabilities, convex in the strike
+class SabrFdm {
+ public:
+  //	grid uniform in z over stdDevs sqrt(expiry), clipped at the barrier
+  //	F = -shift when 0 < beta < 1, with the forward on a node
+  static FdmGrid makeGrid(double expiry, double forward,
+                          const SabrParams& params,
+                          const FdmSettings1d& settings);
+
+  //	probabilities of the grid nodes at expiry, p[0] and p[n - 1] hold the
+  //	masses absorbed at the boundaries
+  static void density(double expiry, double forward, const SabrParams& params,
+                      const FdmSettings1d& settings, FdmGrid& x,
+                      mVector<double>& p);
+
+  //	calls or puts on every strike from one density solve, undiscounted
+  static void prices(double expiry, const mVector<double>& strikes,
+                     double forward, const SabrParams& params, bool isCall,
+                     const FdmSettings1d& settings, mVector<double>& prices);
+
+  //	call
+  static double call(double expiry,  //	in years
+                     double strike, double forward, const SabrParams& params,
+                     const FdmSettings1d& settings);
+};
+
+#endif  // FDM_WORLD_LIB_SABR_FDM_HPP
@@ -0,0 +1,72 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_SVI_HPP
+#define FDM_WORLD_LIB_SVI_HPP
+
+#include "solver.hpp"
+
+//	raw svi total variance in the log moneyness k = log(K / F), Gatheral
+//	(2004)
+//	  w(k) = a + b (rho (k - m) + sqrt((k - m)^2 + sigma^2))
+struct SviParams {
+  double a{0.04};
+  double b{0.0};
+  double rho{-0.3};
+  double m{0.0};
+  double sigma{0.1};
+};
+
+//	ssvi surface with the power law of Gatheral & Jacquier (2014), theta the
+//	atm total variance of each maturity
+//	  w(k, theta) = theta / 2 (1 + rho phi k + sqrt((phi k + rho)^2 + 1 -
+//	  rho^2)), phi(theta) = eta / (theta^gamma (1 + theta)^(1 - gamma))
+struct SsviParams {
+  double rho{-0.3};
+  double eta{1.0};
+  double gamma{0.5};
+};
+
+//	svi smiles, evaluation over strike slices and least squares fits on the
+//	Levenberg-Marquardt solver
+//	fits work on the black volatilities, residuals (w - w_quote) / (2 sigma
+//	T) are volatility errors to first order, and are arbitrage aware: the
+//	conditions below are penalised, or bounded where they are boxes
+//	  raw: a + b sigma sqrt(1 - rho^2) >= 0 (w >= 0), b (1 + |rho|) <= 2
+//	  (Lee's moment bound on the wings of the total variance)
+//	  ssvi: eta (1 + |rho|) <= 2 with gamma in (0, 1/2] (no butterfly) and
+//	  increasing thetas (no calendar spread)
+//	the bounds of the solver settings are replaced by those of the params
+class Svi {
+ public:
+  //	total variance
+  static double variance(double k, const SviParams& params);
+  static double variance(double k, double theta, const SsviParams& params);
+
+  //	black volatilities on every strike
+  static void vols(double expiry, const mVector<double>& strikes,
+                   double forward, const SviParams& params,
+                   mVector<double>& res);
+  static void vols(double expiry, double theta, const mVector<double>& strikes,
+                   double forward, const SsviParams& params,
+                   mVector<double>& res);
+
+  //	raw slice from params, the previous fit warm starts the next, params
+  //	with b = 0 (flat) start from a guess from the quotes instead, analytic
+  //	jacobian
+  static bool fit(double expiry, const mVector<double>& strikes,
+                  double forward, const mVector<double>& vols,
+                  SviParams& params,
+                  const LevenbergMarquardtSettings& settings = {},
+                  LevenbergMarquardtReport* report = nullptr);
+
+  //	ssvi surface, one row of strikes and vols per maturity, the thetas
+  //	are fitted with the params and start from the quotes nearest the money
+  //	when empty
+  static bool fit(const mVector<double>& expiries,
+                  const mVector<double>& forwards,
+                  const mMatrix<double>& strikes, const mMatrix<double>& vols,
+                  mVector<double>& thetas, SsviParams& params,
+                  const LevenbergMarquardtSettings& settings = {},
+                  LevenbergMarquardtReport* report = nullptr);
+};
+
+#endif  // FDM_WORLD_LIB_SVI_HPP
@@ -0,0 +1,95 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_ADI_HPP
+#define FDM_WORLD_LIB_ADI_HPP
+
+#include "fdmOperator2d.hpp"
+#include "threadPool.hpp"
+
+//	ADI splitting schemes, see In 't Hout & Welfert (2009)
+enum class AdiScheme {
+  Douglas,
+  CraigSneyd,
+  ModifiedCraigSneyd,
+  HundsdorferVerwer
+};
+
+//	ADI time stepper for a 2d operator with mixed derivative term
+//	u is rolled in time to maturity, i.e. u_t = A u from the payoff at t = 0
+//	with a pool, the x lines are split in column blocks and the y lines and
+//	explicit parts in row blocks, one block per thread
+//	rows are not cache line aligned, so the x lines of a column block are
+//	solved in a slab of its own and copied back by the next row sweep: y is
+//	written in whole rows and two threads share at most the one line at the
+//	boundary of their row blocks
+class AdiSolver {
+ public:
+  //	theta <= 0 picks the default theta of the scheme
+  AdiSolver(const FdmOperator2d& op, AdiScheme scheme, double theta = 0.0,
+            ThreadPool* pool = nullptr);
+
+  //	default theta per scheme
+  static double defaultTheta(AdiScheme scheme);
+
+  //	one step of size dt
+  void step(mMatrix<double>& u, double dt);
+
+  //	timeSteps equal steps over expiry, the first dampingSteps steps are each
+  //	replaced by two implicit Douglas half steps to smooth the payoff
+  void rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                int dampingSteps = 0);
+
+  //	funcs
+  AdiScheme scheme() const { return myScheme; }
+  double theta() const { return myTheta; }
+
+ private:
+  //	refresh line factors when theta * dt changes
+  void factorize(double thetaDt, FdmLineFactors& factors);
+
+  //	y0 = u + dt A u and the Douglas predictor y, stores A_k u
+  void predict(const mMatrix<double>& u, double dt,
+               const FdmLineFactors& factors);
+
+  //	implicit corrections y <- (I - thetaDt A_k)^-1 (y - thetaDt A_k v)
+  void correct(mMatrix<double>& y, const mMatrix<double>& a1v,
+               const mMatrix<double>& a2v, const FdmLineFactors& factors);
+
+  //	out = A_k v for the three parts
+  void applyAll(const mMatrix<double>& v, mMatrix<double>& a0v,
+                mMatrix<double>& a1v, mMatrix<double>& a2v);
+
+  //	x lines of v - thetaDt av (v when av is null): solve(thread, begin,
+  //	end, lines, offset) solves the columns [begin, end) held in lines from
+  //	column offset, in place on one thread and otherwise in the slabs, to
+  //	be gathered back into v
+  void sweepX(
+      mMatrix<double>& v, const mMatrix<double>* av, double thetaDt,
+      const function<void(int, int, int, mMatrix<double>&, int)>& solve);
+
+  //	row i of the slabs back into u, nothing after an in place sweep
+  void gatherSlabs(mMatrix<double>& u, int i) const;
+
+  //	func(thread, begin, end) over [0, size), on the pool when there is one
+  void parallelFor(int size, const function<void(int, int, int)>& func,
+                   int align = 1);
+
+  const FdmOperator2d* myOp;
+  AdiScheme myScheme;
+  double myTheta;
+  ThreadPool* myPool;
+
+  //	per thread x line blocks, and slabs (xSize by the block width) of
+  //	the column blocks from mySlabBegin, -1 when unused
+  vector<mMatrix<double>> myScratch;
+  vector<mMatrix<double>> mySlabs;
+  vector<int> mySlabBegin;
+
+  FdmLineFactors myFactors, myDampingFactors;
+
+  //	preallocated stages
+  mMatrix<double> myA0U, myA1U, myA2U;
+  mMatrix<double> myA0Y, myA1Y, myA2Y;
+  mMatrix<double> myY0, myY;
+};
+
+#endif  // FDM_WORLD_LIB_ADI_HPP
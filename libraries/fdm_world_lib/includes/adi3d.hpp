@@ -0,0 +1,65 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_ADI_3D_HPP
+#define FDM_WORLD_LIB_ADI_3D_HPP
+
+#include "adi.hpp"
+#include "fdmOperator3d.hpp"
+
+//	ADI time stepper for a 3d operator with mixed derivative terms, the
+//	schemes of AdiSolver with A = A0 + A1 + A2 + A3, see In 't Hout and
+//	Welfert (2007)
+//	u is rolled in time to maturity, i.e. u_t = A u from the payoff at t = 0
+//	the explicit parts are fused into one pass per stage and re-evaluated
+//	instead of stored, so a step holds the solution and two stages
+//	with a pool, the x lines are split in column blocks, the y and z lines
+//	and explicit parts in slab blocks, one block per thread
+class AdiSolver3d {
+ public:
+  //	theta <= 0 picks the default theta of the scheme
+  AdiSolver3d(const FdmOperator3d& op, AdiScheme scheme, double theta = 0.0,
+              ThreadPool* pool = nullptr);
+
+  //	one step of size dt
+  void step(mCube<double>& u, double dt);
+
+  //	timeSteps equal steps over expiry, the first dampingSteps steps are each
+  //	replaced by two implicit Douglas half steps to smooth the payoff
+  void rollback(mCube<double>& u, double expiry, int timeSteps,
+                int dampingSteps = 0);
+
+  //	funcs
+  AdiScheme scheme() const { return myScheme; }
+  double theta() const { return myTheta; }
+
+  //	bytes held by the stages and work space for a solution of the
+  //	operator's size, the solution itself included
+  size_t bytes() const;
+
+ private:
+  //	out = base + sum_m w[m] A_m u
+  void apply(const mCube<double>& u, double w0, double w1, double w2,
+             double w3, const mCube<double>& base, mCube<double>& out);
+
+  //	y <- (I - thetaDt A_k)^-1 (y - thetaDt A_k v) for k = 1, 2, 3 from
+  //	y = base, base may be y
+  void correct(const mCube<double>& base, const mCube<double>& v,
+               double thetaDt, mCube<double>& y);
+
+  //	Douglas stage from u into myY, keeps y0 = u + dt A u in myY0
+  void predict(const mCube<double>& u, double dt, double thetaDt);
+
+  //	func(thread, begin, end) over [0, size), on the pool when there is one
+  void parallelFor(int size, const function<void(int, int, int)>& func);
+
+  const FdmOperator3d* myOp;
+  AdiScheme myScheme;
+  double myTheta;
+  ThreadPool* myPool;
+
+  //	per thread work space
+  vector<mVector<double>> myWork;
+
+  mCube<double> myY0, myY;
+};
+
+#endif  // FDM_WORLD_LIB_ADI_3D_HPP
@@ -0,0 +1,84 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_ADI_ADJOINT_HPP
+#define FDM_WORLD_LIB_ADI_ADJOINT_HPP
+
+#include "adi.hpp"
+#include "revolve.hpp"
+
+//	discrete adjoint of AdiSolver::rollback() on a fixed operator
+//	every ADI step is linear in u and in the assembled coefficients, the
+//	reverse sweep runs its stages backwards with the transposed line solves
+//	and adds up the gradient of the output with respect to every coefficient
+//	on every node
+//	the forward sweep keeps budget solutions on a Revolve schedule, the
+//	reverse sweep recomputes the others from them and records the stages of
+//	one step at a time
+class AdiAdjoint {
+ public:
+  //	theta <= 0 picks the default theta of the scheme, budget <= 0:
+  //	2 sqrt(steps) solutions
+  AdiAdjoint(const FdmOperator2d& op, AdiScheme scheme, double theta = 0.0,
+             int budget = 0);
+
+  //	same steps as AdiSolver::rollback(), keeps the checkpoints
+  void rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                int dampingSteps = 0);
+
+  //	reverse sweep from the adjoint of the final solution, lambda ends as
+  //	the adjoint of the payoff, adds to gradient
+  void adjoint(mMatrix<double>& lambda, FdmCoefficients2d& gradient);
+
+  //	funcs
+  int steps() const { return (int)myDts.size(); }
+  int budget() const { return myRevolve.budget(); }
+
+  //	recomputation of the reverse sweep, set by rollback()
+  const Revolve& schedule() const { return myRevolve; }
+
+ private:
+  //	stages of one step
+  struct Stages {
+    mMatrix<double> u, y1, y2, w1;
+  };
+
+  //	one forward step from s.u into out, keeps the stages
+  void step(int k, Stages& s, mMatrix<double>& out);
+
+  //	from step from to step to in place
+  void advance(mMatrix<double>& u, int from, int to);
+
+  //	reverse of step k, lambda is the adjoint of out
+  void reverse(int k, const Stages& s, const mMatrix<double>& out,
+               mMatrix<double>& lambda, FdmCoefficients2d& gradient);
+
+  //	weights of A0, A1, A2 in the second stage of the scheme
+  void stageWeights(double* c) const;
+
+  const FdmLineFactors& factors(int k) const {
+    return myDamping[k] ? myDampingFactors : myFactors;
+  }
+
+  const FdmOperator2d* myOp;
+  AdiScheme myScheme;
+  double myTheta;
+  int myBudget;
+
+  //	per step size and whether it is a Douglas damping half step
+  vector<double> myDts;
+  vector<bool> myDamping;
+
+  FdmLineFactors myFactors, myDampingFactors;
+
+  Revolve myRevolve;
+  vector<mMatrix<double>> myCheckpoints;
+
+  //	the current state and the step recorded for the reverse
+  mMatrix<double> myState, myOut;
+  Stages myTape;
+
+  //	work space
+  mMatrix<double> myY0, myA, myB, myC, myD;
+  mMatrix<double> myY0Bar, myUBar, myVBar, myRBar;
+};
+
+#endif  // FDM_WORLD_LIB_ADI_ADJOINT_HPP
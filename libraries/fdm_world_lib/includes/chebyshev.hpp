@@ -0,0 +1,147 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_CHEBYSHEV_HPP
+#define FDM_WORLD_LIB_CHEBYSHEV_HPP
+
+#include "fdmGrid.hpp"
+#include "fdmOperator1d.hpp"
+#include "fdmOperator2d.hpp"
+
+//	chebyshev gauss-lobatto nodes x_j = c - h cos(pi j / n), j = 0..n, on
+//	[xMin, xMax] in increasing order with the dense differentiation matrices
+//	of the interpolating polynomial, see Trefethen (2000)
+//	the error of smooth functions decays exponentially in the node count,
+//	kinks (vanilla payoffs) fall back to second order and need finite
+//	differences
+class ChebyshevGrid {
+ public:
+  //	c'tors
+  ChebyshevGrid() = default;
+  ChebyshevGrid(double xMin, double xMax, int size);
+
+  //	funcs
+  int size() const { return myPoints.size(); }
+  double operator[](int i) const { return myPoints[i]; }
+  const mVector<double>& points() const { return myPoints; }
+  double xMin() const { return myPoints[0]; }
+  double xMax() const { return myPoints[size() - 1]; }
+
+  //	first and second derivative matrices, (D u)_i = u'(x_i)
+  const mMatrix<double>& d1() const { return myD1; }
+  const mMatrix<double>& d2() const { return myD2; }
+
+  //	barycentric interpolation of the polynomial through the values at x
+  double interpolate(const mVectorView<double>& values, double x) const;
+
+  //	same on every column, the rows are the nodes
+  void interpolate(const mMatrix<double>& values, double x,
+                   mVector<double>& res) const;
+
+ private:
+  //	barycentric weights at x, exact node hits give a unit vector
+  void weights(double x, mVector<double>& res) const;
+
+  mVector<double> myPoints;
+  mMatrix<double> myD1, myD2;
+};
+
+//	1d or 2d operator collocated on chebyshev grids as one dense matrix L
+//	over the nodes i * ySize + j, the layout of a mMatrix with x along rows
+//	and y along cols, so that the 1d operator acts on the columns of a
+//	strike ladder and the 2d one on a single function of (x, y)
+//	the coefficients and the boundary treatment are those of FdmOperator1d
+//	and FdmOperator2d: linear sides drop the second derivatives of their
+//	direction (and the mixed one), dirichlet sides freeze their nodes
+class ChebyshevOperator {
+ public:
+  //	c'tors
+  ChebyshevOperator() = default;
+  explicit ChebyshevOperator(const ChebyshevGrid& x);
+  ChebyshevOperator(const ChebyshevGrid& x, const ChebyshevGrid& y);
+
+  //	boundary treatment, to be set before assemble()
+  void setBoundaries(FdmBoundary lower, FdmBoundary upper);
+  void setBoundaries(FdmBoundary xLower, FdmBoundary xUpper,
+                     FdmBoundary yLower, FdmBoundary yUpper);
+
+  //	collocate the coefficients on the nodes
+  void assemble(const FdmCoefficients1d& coeffs);
+  void assemble(const FdmCoefficients2d& coeffs);
+
+  //	res = L u on every column of u seen as size() rows
+  void apply(const mMatrix<double>& u, mMatrix<double>& res) const;
+
+  //	value of u at x (1d, one per column) or at (x, y) (2d)
+  void value(const mMatrix<double>& u, double x, mVector<double>& res) const;
+  double value(const mMatrix<double>& u, double x, double y) const;
+
+  //	bumped by every assemble(), solvers refactorise when it moves
+  int version() const { return myVersion; }
+
+  //	funcs
+  const ChebyshevGrid& x() const { return myX; }
+  const ChebyshevGrid& y() const { return myY; }
+  int xSize() const { return myX.size(); }
+  int ySize() const { return myYSize; }
+  int size() const { return myX.size() * myYSize; }
+  const mMatrix<double>& matrix() const { return myMatrix; }
+
+ private:
+  ChebyshevGrid myX, myY;
+  int myYSize{1};
+  FdmBoundary myXLower{FdmBoundary::Linear}, myXUpper{FdmBoundary::Linear};
+  FdmBoundary myYLower{FdmBoundary::Linear}, myYUpper{FdmBoundary::Linear};
+
+  mMatrix<double> myMatrix;
+  int myVersion{0};
+};
+
+//	theta scheme on a chebyshev operator with the interface of ThetaSolver
+//	u is rolled in time to maturity, u_t = L u from the payoff at t = 0, the
+//	explicit part is a dense product and the implicit one a blocked LU solve
+//	of I - theta dt L for all the columns at once
+//	LU factors are cached per (size, theta dt) and operator version, the
+//	Rannacher half steps and the main steps of a rollback, or the uneven
+//	steps between events, then factorise once each for the whole solve
+//	a step throws a runtime_error when I - theta dt L is singular
+class ChebyshevSolver {
+ public:
+  //	c'tor
+  ChebyshevSolver(const ChebyshevOperator& op, double theta = 0.5,
+                  int cacheSize = 4);
+
+  //	one step of size dt, with the solver theta or a given one
+  void step(mMatrix<double>& u, double dt);
+  void step(mMatrix<double>& u, double dt, double theta);
+
+  //	timeSteps equal steps over expiry, the first dampingSteps steps are each
+  //	replaced by two implicit half steps (Rannacher)
+  void rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                int dampingSteps = 0);
+
+  //	funcs
+  double theta() const { return myTheta; }
+  int factorizations() const { return myFactorizations; }
+
+ private:
+  //	factors of I - thetaDt L, from the cache or computed
+  struct Factors {
+    int size{0};
+    int version{-1};
+    double thetaDt{0.0};
+    mMatrix<double> lu;
+    vector<int> pivots;
+  };
+  const Factors& factorize(double thetaDt);
+
+  const ChebyshevOperator* myOp;
+  double myTheta;
+
+  //	most recent first
+  vector<Factors> myCache;
+  int myCacheSize;
+  int myFactorizations{0};
+
+  mMatrix<double> myU, myRhs;
+};
+
+#endif  // FDM_WORLD_LIB_CHEBYSHEV_HPP
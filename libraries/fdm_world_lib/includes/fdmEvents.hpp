@@ -0,0 +1,70 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FDM_EVENTS_HPP
+#define FDM_WORLD_LIB_FDM_EVENTS_HPP
+
+#include "fdmGrid.hpp"
+
+//	transforms of the solution at a given date
+enum class FdmEventType {
+  Barrier,  //	knock out outside [lower, upper], the value becomes the rebate
+  Jump,     //	u(x) <- u(x - amount - proportion x), cash or proportional
+            //	dividend
+  Exercise  //	u <- max(u, exercise values)
+};
+
+//	one event, made by the static factories
+struct FdmEvent {
+  double time{0.0};
+  FdmEventType type{FdmEventType::Barrier};
+
+  //	barrier
+  double lower{0.0}, upper{0.0}, rebate{0.0};
+
+  //	jump
+  double amount{0.0}, proportion{0.0};
+
+  //	exercise values on the grid nodes (rows), one column per column of the
+  //	solution
+  mMatrix<double> values;
+
+  //	one sided barriers take -HUGE_VAL or HUGE_VAL on the open side
+  static FdmEvent barrier(double time, double lower, double upper,
+                          double rebate = 0.0);
+  static FdmEvent jump(double time, double amount, double proportion = 0.0);
+  static FdmEvent exercise(double time, const mMatrix<double>& values);
+};
+
+//	events sorted by time, applied in place on the solution u whose rows are
+//	the grid nodes and whose columns are independent terminal conditions:
+//	every transform works row by row on contiguous columns
+class FdmEventSchedule {
+ public:
+  //	add
+  void add(const FdmEvent& event);
+
+  //	funcs
+  bool empty() const { return myEvents.empty(); }
+  int size() const { return myEvents.size(); }
+
+  //	distinct event times
+  mVector<double> times() const;
+
+  //	apply the events at time t in the order they were added, returns true
+  //	when one of them breaks the smoothness of u (barrier or jump), after
+  //	which steppers restart their damping
+  //	jumps copy u into scratch first, kept by the stepper so that repeated
+  //	events reuse its storage
+  bool apply(double t, const FdmGrid& x, mMatrix<double>& u,
+             mMatrix<double>& scratch) const;
+
+ private:
+  static void applyBarrier(const FdmEvent& event, const FdmGrid& x,
+                           mMatrix<double>& u);
+  static void applyJump(const FdmEvent& event, const FdmGrid& x,
+                        mMatrix<double>& u, mMatrix<double>& scratch);
+  static void applyExercise(const FdmEvent& event, mMatrix<double>& u);
+
+  vector<FdmEvent> myEvents;
+};
+
+#endif  // FDM_WORLD_LIB_FDM_EVENTS_HPP
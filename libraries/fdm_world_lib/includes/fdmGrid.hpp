@@ -0,0 +1,107 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FDM_GRID_HPP
+#define FDM_WORLD_LIB_FDM_GRID_HPP
+
+#include "mMatrix.hpp"
+
+//	boundary treatment of one side of a grid direction
+enum class FdmBoundary {
+  Linear,    //	no second derivative, one sided first derivative
+  Dirichlet  //	value frozen at its initial condition
+};
+
+//	stencil of the convection term b u_x on the interior nodes
+enum class FdmConvection {
+  Central,  //	second order, oscillates once |b| h > 2 a
+  Upwind,   //	central blended with one sided differences in the direction of
+            //	b just enough to keep the off diagonals non negative
+  Fitted    //	central with the diffusion fitted exponentially, a (b h / 2 a)
+            //	coth(b h / 2 a), see Il'in (1969) and Duffy (2004)
+};
+
+//	1d grid, possibly non-uniform, with the three point finite difference
+//	weights of the first and second derivatives precomputed on every node
+//	interior nodes use central differences, boundary nodes use one sided two
+//	point first derivatives and no second derivative (linear boundary)
+class FdmGrid {
+ public:
+  //	c'tors
+  FdmGrid() = default;
+  explicit FdmGrid(const mVector<double>& points);
+
+  //	uniform grid on [xMin, xMax]
+  static FdmGrid uniform(double xMin, double xMax, int size);
+
+  //	grid concentrated around centre by a sinh transform, density is the
+  //	width of the concentration region as a fraction of xMax - xMin
+  static FdmGrid concentrated(double xMin, double xMax, int size,
+                              double centre, double density);
+
+  //	funcs
+  int size() const { return myPoints.size(); }
+  double operator[](int i) const { return myPoints[i]; }
+  const mVector<double>& points() const { return myPoints; }
+  double front() const { return myPoints[0]; }
+  double back() const { return myPoints[size() - 1]; }
+
+  //	first derivative weights on nodes i-1, i and i+1
+  double d1Minus(int i) const { return myD1Minus[i]; }
+  double d1Centre(int i) const { return myD1Centre[i]; }
+  double d1Plus(int i) const { return myD1Plus[i]; }
+
+  //	second derivative weights on nodes i-1, i and i+1
+  double d2Minus(int i) const { return myD2Minus[i]; }
+  double d2Centre(int i) const { return myD2Centre[i]; }
+  double d2Plus(int i) const { return myD2Plus[i]; }
+
+  //	weights of a u_xx + b u_x on nodes i-1, i and i+1 with the given
+  //	convection stencil, central on the ends, fitted and upwind rows are
+  //	monotone for any a >= 0
+  void stencil(int i, double a, double b, FdmConvection scheme, double& low,
+               double& diag, double& up) const;
+
+  //	index i of the cell [x_i, x_i+1] containing x, clamped to the grid
+  int locate(double x) const;
+
+  //	cubic lagrange interpolation of nodal values at x
+  double interpolate(const mVectorView<double>& values, double x) const;
+
+  //	same for every column of values, rows are the nodes
+  void interpolate(const mMatrix<double>& values, double x,
+                   mVector<double>& out) const;
+
+  //	weights of the interpolation at x on the nodes i0..i0+order-1, returns
+  //	i0
+  int lagrangeWeights(double x, double* weights, int& order) const;
+
+  //	same with the weights of the first and second derivatives of the
+  //	interpolant at x, the second derivative is zero when linear
+  int lagrangeWeights(double x, double* weights, double* d1, double* d2,
+                      int& order) const;
+
+  //	vanilla payoff averaged over the cell around node i, which removes the
+  //	grid dependence of the kink at the strike
+  double vanillaAverage(int i, double strike, bool isCall) const;
+
+  //	vanilla payoff smoothed around node i by the fourth order kernel of
+  //	Kreiss et al. (1970) on the index grid, keeps the fourth order of
+  //	compact schemes where the cell average limits it to second
+  double vanillaSmoothed(int i, double strike, bool isCall) const;
+
+  //	first and second derivatives of the nodes with respect to their index,
+  //	the grid seen as a smooth map of a uniform one, fourth order inside and
+  //	second order next to the ends
+  void mapDerivatives(mVector<double>& d1, mVector<double>& d2) const;
+
+ private:
+  void computeWeights();
+
+  //	node position at a fractional index by cubic interpolation
+  double position(double xi) const;
+
+  mVector<double> myPoints;
+  mVector<double> myD1Minus, myD1Centre, myD1Plus;
+  mVector<double> myD2Minus, myD2Centre, myD2Plus;
+};
+
+#endif  // FDM_WORLD_LIB_FDM_GRID_HPP
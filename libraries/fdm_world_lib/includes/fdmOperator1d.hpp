@@ -0,0 +1,109 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FDM_OPERATOR_1D_HPP
+#define FDM_WORLD_LIB_FDM_OPERATOR_1D_HPP
+
+#include <limits>
+
+#include "fdmGrid.hpp"
+#include "tridiagonal.hpp"
+
+//	coefficients of u_t = a u_xx + b u_x + r u on every node
+struct FdmCoefficients1d {
+  mVector<double> a, b, r;
+
+  void resize(int size) {
+    a.assign(size, 0.0);
+    b.assign(size, 0.0);
+    r.assign(size, 0.0);
+  }
+};
+
+//	1d operator discretised on a grid as a tridiagonal matrix
+//	assemble() keeps the diffusion stencil a d2 apart from the rest, so time
+//	dependent diffusion (local volatility) only rescales the cached stencil
+//	rows per step, the grid weights are never recomputed
+//	compact operators are fourth order M u_t = L u with a tridiagonal mass
+//	matrix M, the identity otherwise, on a grid that is a smooth map of a
+//	uniform one, see Spotz & Carey (2001)
+//	the theta scheme solves them at the cost of the second order scheme, the
+//	Fokker-Planck, adjoint and greeks engines assume M = I
+class FdmOperator1d {
+ public:
+  //	c'tors
+  FdmOperator1d() = default;
+  explicit FdmOperator1d(const FdmGrid& x);
+
+  //	boundary treatment, to be set before assemble()
+  void setBoundaries(FdmBoundary lower, FdmBoundary upper);
+
+  //	convection stencil on the nodes in [xMin, xMax], to be set before
+  //	assemble(), central by default, compact operators ignore it
+  void setConvection(FdmConvection scheme,
+                     double xMin = -std::numeric_limits<double>::infinity(),
+                     double xMax = std::numeric_limits<double>::infinity());
+
+  //	fourth order compact discretisation, to be set before assemble()
+  void setCompact(bool compact) { myCompact = compact; }
+  bool compact() const { return myCompact; }
+
+  //	compact rows of u_t = a u_xx + b u_x + r u on the grid: mass M and
+  //	operator L, second order rows with M = I on the ends and where the
+  //	cell Peclet number breaks the diagonal dominance of M
+  static void compactStencil(const FdmGrid& x, const mVector<double>& a,
+                             const mVector<double>& b,
+                             const mVector<double>& r,
+                             Tridiagonal<double>& mass,
+                             Tridiagonal<double>& res);
+
+  //	discretise the coefficients on the grid
+  void assemble(const FdmCoefficients1d& coeffs);
+
+  //	L = diag(scale) D + R - discount I with D the diffusion stencil and R
+  //	the convection and discount stencil of the last assemble(), 3
+  //	multiply-adds per node, discount is a time dependent short rate
+  //	compact operators and nodes with upwind or fitted stencils, which
+  //	depend on the ratio of convection to diffusion, are reassembled with
+  //	the scaled coefficients
+  void scaleDiffusion(const mVector<double>& scale, double discount = 0.0);
+
+  //	row i kept at its initial condition by a dirichlet side
+  bool frozen(int i) const {
+    return (i == 0 && myLower == FdmBoundary::Dirichlet) ||
+           (i == size() - 1 && myUpper == FdmBoundary::Dirichlet);
+  }
+
+  //	res = D z with the unit diffusion stencil
+  void applyDiffusion(const mVector<double>& z, mVector<double>& res) const;
+
+  //	bumped by every assemble() or scaleDiffusion(), solvers refactorise
+  //	when it moves
+  int version() const { return myVersion; }
+
+  //	funcs
+  const FdmGrid& x() const { return myX; }
+  int size() const { return myX.size(); }
+  const Tridiagonal<double>& matrix() const { return myMatrix; }
+  const Tridiagonal<double>& mass() const { return myMass; }
+
+  //	M - thetaDt L, factorised
+  void implicitMatrix(double thetaDt, Tridiagonal<double>& res) const;
+
+ private:
+  FdmGrid myX;
+  FdmBoundary myLower{FdmBoundary::Linear}, myUpper{FdmBoundary::Linear};
+  Tridiagonal<double> myMatrix, myMass;
+  int myVersion{0};
+
+  //	coefficients of the last assemble() when compact or not central
+  bool myCompact{false};
+  FdmCoefficients1d myCoeffs;
+
+  //	convection stencil per node, empty when central everywhere
+  vector<FdmConvection> myConvection;
+
+  //	cached stencils, rows (lower, diag, upper)
+  mVector<double> myDLow, myDDiag, myDUp;
+  mVector<double> myRLow, myRDiag, myRUp;
+};
+
+#endif  // FDM_WORLD_LIB_FDM_OPERATOR_1D_HPP
@@ -0,0 +1,172 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FDM_OPERATOR_2D_HPP
+#define FDM_WORLD_LIB_FDM_OPERATOR_2D_HPP
+
+#include <limits>
+
+#include "fdmGrid.hpp"
+#include "mMatrix.hpp"
+
+//	coefficients of
+//	  u_t = axx u_xx + ayy u_yy + axy u_xy + bx u_x + by u_y + r u
+//	on every node of an x (rows) by y (cols) grid
+struct FdmCoefficients2d {
+  mMatrix<double> axx, ayy, axy, bx, by, r;
+
+  void resize(int xSize, int ySize) {
+    axx.resize(xSize, ySize, 0.0);
+    ayy.resize(xSize, ySize, 0.0);
+    axy.resize(xSize, ySize, 0.0);
+    bx.resize(xSize, ySize, 0.0);
+    by.resize(xSize, ySize, 0.0);
+    r.resize(xSize, ySize, 0.0);
+  }
+};
+
+//	Thomas factors of the line systems I - thetaDt A_x and I - thetaDt A_y
+struct FdmLineFactors {
+  double thetaDt{0.0};
+  mMatrix<double> xPivots, xUppers;
+  mMatrix<double> yPivots, yUppers;
+};
+
+//	2d operator split as A = A0 + A1 + A2 for ADI schemes
+//	  A0: mixed derivative term
+//	  A1: x derivatives and half the source term, tridiagonal along columns
+//	  A2: y derivatives and half the source term, tridiagonal along rows
+//	functions on the grid are mMatrix with x along rows and y along cols
+//	compact operators are fourth order with A_k = M_k^-1 K_k, M_k the
+//	tridiagonal masses of FdmOperator1d::compactStencil() on the lines and A0
+//	on five point stencils, the line solves stay tridiagonal, the transposes
+//	and gradient() are second order only
+class FdmOperator2d {
+ public:
+  //	c'tors
+  FdmOperator2d() = default;
+  FdmOperator2d(const FdmGrid& x, const FdmGrid& y);
+
+  //	boundary treatment, to be set before assemble()
+  void setBoundaries(FdmBoundary xLower, FdmBoundary xUpper,
+                     FdmBoundary yLower, FdmBoundary yUpper);
+
+  //	convection stencils of both directions on the nodes in the rectangle,
+  //	to be set before assemble(), central by default, compact operators
+  //	ignore them, gradient() assumes central
+  void setConvection(FdmConvection scheme,
+                     double xMin = -std::numeric_limits<double>::infinity(),
+                     double xMax = std::numeric_limits<double>::infinity(),
+                     double yMin = -std::numeric_limits<double>::infinity(),
+                     double yMax = std::numeric_limits<double>::infinity());
+
+  //	fourth order compact discretisation, to be set before assemble()
+  void setCompact(bool compact) { myCompact = compact; }
+  bool compact() const { return myCompact; }
+
+  //	discretise the coefficients on the grid
+  void assemble(const FdmCoefficients2d& coeffs);
+
+  //	funcs
+  const FdmGrid& x() const { return myX; }
+  const FdmGrid& y() const { return myY; }
+  int xSize() const { return myX.size(); }
+  int ySize() const { return myY.size(); }
+
+  //	out = A0 u, A1 u, A2 u
+  void applyMixed(const mMatrix<double>& u, mMatrix<double>& out) const;
+  void applyX(const mMatrix<double>& u, mMatrix<double>& out) const;
+  void applyY(const mMatrix<double>& u, mMatrix<double>& out) const;
+
+  //	same on rows [iBegin, iEnd) only, out must be sized, compact operators
+  //	give K_k u here and need the mass solves below on all the lines
+  void applyMixed(const mMatrix<double>& u, mMatrix<double>& out, int iBegin,
+                  int iEnd) const;
+  void applyX(const mMatrix<double>& u, mMatrix<double>& out, int iBegin,
+              int iEnd) const;
+  void applyY(const mMatrix<double>& u, mMatrix<double>& out, int iBegin,
+              int iEnd) const;
+
+  //	nine point stencil of A = A0 + A1 + A2, res[3 (di + 1) + dj + 1](i, j)
+  //	the weight of u(i + di, j + dj) in (A u)(i, j), zero rows on dirichlet
+  //	nodes, second order operators only
+  void stencil(vector<mMatrix<double>>& res) const;
+
+  //	factorise the line systems for a given theta * dt
+  void factorize(double thetaDt, FdmLineFactors& factors) const;
+
+  //	u <- (I - thetaDt A1)^-1 u and u <- (I - thetaDt A2)^-1 u in place
+  void solveX(const FdmLineFactors& factors, mMatrix<double>& u) const;
+  void solveY(const FdmLineFactors& factors, mMatrix<double>& u) const;
+
+  //	x lines are strided: columns [jBegin, jEnd) are swept lineBlock at a
+  //	time through scratch (xSize by lineBlock) so that u is read and written
+  //	once per line, column j of the grid is column j - offset of u, so that
+  //	u may be a slab of the columns from offset
+  static constexpr int lineBlock = 8;
+  void solveX(const FdmLineFactors& factors, mMatrix<double>& u, int jBegin,
+              int jEnd, mMatrix<double>& scratch, int offset = 0) const;
+
+  //	y lines are the contiguous rows [iBegin, iEnd), solved in place
+  void solveY(const FdmLineFactors& factors, mMatrix<double>& u, int iBegin,
+              int iEnd) const;
+
+  //	u <- M1^-1 u on the x lines of the columns [jBegin, jEnd) and
+  //	u <- M2^-1 u on the y lines of the rows [iBegin, iEnd), compact only
+  void massSolveX(mMatrix<double>& u, int jBegin, int jEnd,
+                  mMatrix<double>& scratch, int offset = 0) const;
+  void massSolveY(mMatrix<double>& u, int iBegin, int iEnd) const;
+
+  //	transposes for adjoint sweeps: out = Ak^T u and
+  //	u <- (I - thetaDt Ak)^-T u against the same factors
+  void applyMixedTranspose(const mMatrix<double>& u,
+                           mMatrix<double>& out) const;
+  void applyXTranspose(const mMatrix<double>& u, mMatrix<double>& out) const;
+  void applyYTranspose(const mMatrix<double>& u, mMatrix<double>& out) const;
+  void solveXTranspose(const FdmLineFactors& factors,
+                       mMatrix<double>& u) const;
+  void solveYTranspose(const FdmLineFactors& factors,
+                       mMatrix<double>& u) const;
+
+  //	adds to res the gradient of a^T (w0 A0 + w1 A1 + w2 A2) b with respect
+  //	to the coefficients given to assemble()
+  void gradient(const mMatrix<double>& a, const mMatrix<double>& b,
+                double w0, double w1, double w2,
+                FdmCoefficients2d& res) const;
+
+ private:
+  //	compact parts of assemble() and the sweeps
+  void assembleCompact(const FdmCoefficients2d& coeffs);
+  void applyMixedCompact(const mMatrix<double>& u, mMatrix<double>& out,
+                         int iBegin, int iEnd) const;
+  void factorizeCompact(double thetaDt, FdmLineFactors& factors) const;
+  void solveXCompact(const FdmLineFactors& factors, mMatrix<double>& u,
+                     int jBegin, int jEnd, mMatrix<double>& scratch,
+                     int offset) const;
+  void solveYCompact(const FdmLineFactors& factors, mMatrix<double>& u,
+                     int iBegin, int iEnd) const;
+
+  FdmGrid myX, myY;
+  FdmBoundary myXLower{FdmBoundary::Linear}, myXUpper{FdmBoundary::Linear};
+  FdmBoundary myYLower{FdmBoundary::Linear}, myYUpper{FdmBoundary::Linear};
+
+  //	tridiagonal coefficients per node
+  mMatrix<double> myXLow, myXDiag, myXUp;
+  mMatrix<double> myYLow, myYDiag, myYUp;
+
+  //	mixed derivative coefficient per node, zero on the boundaries
+  mMatrix<double> myMixed;
+
+  //	nodes on dirichlet sides, their coefficients are not used
+  mMatrix<double> myFrozen;
+
+  //	convection stencil per node, row major, empty when central everywhere
+  vector<FdmConvection> myConvection;
+
+  //	compact: masses per node and their Thomas factors
+  bool myCompact{false};
+  mMatrix<double> myXMassLow, myXMassDiag, myXMassUp;
+  mMatrix<double> myYMassLow, myYMassDiag, myYMassUp;
+  mMatrix<double> myXMassPivots, myXMassUppers;
+  mMatrix<double> myYMassPivots, myYMassUppers;
+};
+
+#endif  // FDM_WORLD_LIB_FDM_OPERATOR_2D_HPP
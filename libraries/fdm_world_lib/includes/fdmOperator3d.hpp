@@ -0,0 +1,105 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FDM_OPERATOR_3D_HPP
+#define FDM_WORLD_LIB_FDM_OPERATOR_3D_HPP
+
+#include "fdmGrid.hpp"
+#include "mCube.hpp"
+
+//	coefficient as a sum of separable products f(x) g(y) h(z), an empty
+//	factor is one
+//	the coefficients of hybrid models are of this form with one or two terms
+//	and cost O(n) memory instead of a cube each
+struct FdmSeparable {
+  struct Term {
+    mVector<double> x, y, z;
+  };
+  vector<Term> terms;
+
+  void add(const mVector<double>& x, const mVector<double>& y,
+           const mVector<double>& z) {
+    terms.push_back(Term{x, y, z});
+  }
+
+  //	values on the line (i, j) for every k, size depth
+  void line(int i, int j, int depth, double* res) const;
+};
+
+//	coefficients of
+//	  u_t = axx u_xx + ayy u_yy + azz u_zz + axy u_xy + axz u_xz + ayz u_yz
+//	        + bx u_x + by u_y + bz u_z + r u
+//	on an x (rows) by y (cols) by z (depth) grid
+struct FdmCoefficients3d {
+  FdmSeparable axx, ayy, azz, axy, axz, ayz, bx, by, bz, r;
+};
+
+//	3d operator split as A = A0 + A1 + A2 + A3 for ADI schemes
+//	  A0: mixed derivative terms, zero on the boundaries
+//	  A1, A2, A3: x, y, z derivatives and a third of the source term each
+//	functions on the grid are mCube with z contiguous
+//	nothing is assembled per node: the coefficients are evaluated line by
+//	line in the sweeps and the line systems are factorised on the fly, so
+//	the operator holds O(n) memory and every sweep reads and writes the
+//	solution once
+class FdmOperator3d {
+ public:
+  //	c'tors
+  FdmOperator3d() = default;
+  FdmOperator3d(const FdmGrid& x, const FdmGrid& y, const FdmGrid& z);
+
+  //	boundary treatment, dirichlet sides keep their initial condition
+  void setBoundaries(FdmBoundary xLower, FdmBoundary xUpper,
+                     FdmBoundary yLower, FdmBoundary yUpper,
+                     FdmBoundary zLower, FdmBoundary zUpper);
+
+  //	keep the coefficients
+  void assemble(const FdmCoefficients3d& coeffs);
+
+  //	funcs
+  const FdmGrid& x() const { return myX; }
+  const FdmGrid& y() const { return myY; }
+  const FdmGrid& z() const { return myZ; }
+  int xSize() const { return myX.size(); }
+  int ySize() const { return myY.size(); }
+  int zSize() const { return myZ.size(); }
+
+  //	doubles of per thread work space for apply() and the solves
+  int workSize() const;
+
+  //	bytes held by the grids and coefficients
+  size_t bytes() const;
+
+  //	out = base + sum_m w[m] A_m u on the slabs [iBegin, iEnd), base may be
+  //	out, out must be sized
+  void apply(const mCube<double>& u, const double* w,
+             const mCube<double>& base, mCube<double>& out, int iBegin,
+             int iEnd, double* work) const;
+
+  //	u <- (I - thetaDt A1)^-1 u on the x lines of the columns [jBegin, jEnd)
+  void solveX(double thetaDt, mCube<double>& u, int jBegin, int jEnd,
+              double* work) const;
+
+  //	u <- (I - thetaDt A2)^-1 u and (I - thetaDt A3)^-1 u on the slabs
+  //	[iBegin, iEnd)
+  void solveY(double thetaDt, mCube<double>& u, int iBegin, int iEnd,
+              double* work) const;
+  void solveZ(double thetaDt, mCube<double>& u, int iBegin, int iEnd,
+              double* work) const;
+
+ private:
+  //	directional coefficients on the line (i, j): second and first order
+  //	and a third of the source, zero where frozen
+  void directional(int i, int j, const FdmSeparable& a, const FdmSeparable& b,
+                   double* aLine, double* bLine, double* rLine) const;
+
+  //	line (i, j) frozen by a dirichlet side in x or y
+  bool frozen(int i, int j) const;
+
+  FdmGrid myX, myY, myZ;
+  FdmBoundary myXLower{FdmBoundary::Linear}, myXUpper{FdmBoundary::Linear};
+  FdmBoundary myYLower{FdmBoundary::Linear}, myYUpper{FdmBoundary::Linear};
+  FdmBoundary myZLower{FdmBoundary::Linear}, myZUpper{FdmBoundary::Linear};
+
+  FdmCoefficients3d myCoeffs;
+};
+
+#endif  // FDM_WORLD_LIB_FDM_OPERATOR_3D_HPP
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FDM_TIME_GRID_HPP
+#define FDM_WORLD_LIB_FDM_TIME_GRID_HPP
+
+#include "mVector.hpp"
+
+//	calendar time grid 0 = t_0 < t_1 < ... < t_n with the theta of each step
+//	(t_k, t_k+1], shared by the backward and forward 1d engines so that both
+//	run the exact same (transposed) sequence of steps
+class FdmTimeGrid {
+ public:
+  //	c'tors
+  FdmTimeGrid() = default;
+
+  //	about timeSteps equal steps up to the last mandatory time, refined so
+  //	that every mandatory time is a node, the first dampingSteps steps from
+  //	t = 0 are each replaced by two implicit half steps
+  static FdmTimeGrid make(const mVector<double>& mandatory, int timeSteps,
+                          double theta, int dampingSteps);
+
+  //	funcs
+  int steps() const { return myThetas.size(); }
+  double time(int k) const { return myTimes[k]; }
+  double dt(int k) const { return myTimes[k + 1] - myTimes[k]; }
+  double theta(int k) const { return myThetas[k]; }
+  const mVector<double>& times() const { return myTimes; }
+
+  //	node index of time t, -1 when t is not a node
+  int index(double t) const;
+
+ private:
+  mVector<double> myTimes;
+  mVector<double> myThetas;
+};
+
+#endif  // FDM_WORLD_LIB_FDM_TIME_GRID_HPP
@@ -0,0 +1,74 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FFT_HPP
+#define FDM_WORLD_LIB_FFT_HPP
+
+#include <complex>
+#include <functional>
+
+#include "mVector.hpp"
+
+using std::complex;
+using std::function;
+
+//	mixed radix complex FFT of any size, recursive decimation in time as in
+//	kiss fft: n is split into radix 4 and 2 factors first, then odd primes,
+//	with dedicated radix 2 and 4 butterflies and a generic one for the rest
+//	the twiddles of both directions are computed once per size and the
+//	plans are cached per size
+class Fft {
+ public:
+  //	c'tor
+  explicit Fft(int size);
+
+  //	shared plan of a size, built on first use, thread safe
+  static const Fft& plan(int size);
+
+  //	out_k = sum_j in_j exp(-/+ 2 pi i j k / n), unscaled, out != in
+  void forward(const complex<double>* in, complex<double>* out) const;
+  void inverse(const complex<double>* in, complex<double>* out) const;
+
+  //	funcs
+  int size() const { return mySize; }
+
+ private:
+  //	transform of the n / fstride points of in at stride fstride into out,
+  //	from the factor pair f on
+  void work(complex<double>* out, const complex<double>* in, int fstride,
+            int f, const vector<complex<double>>& twiddles,
+            complex<double>* scratch, bool inverse) const;
+
+  int mySize;
+
+  //	pairs (radix p, remaining length m)
+  vector<int> myFactors;
+  int myMaxFactor{1};
+
+  //	exp(-/+ 2 pi i k / n)
+  vector<complex<double>> myForward, myInverse;
+};
+
+//	discretisation of Carr & Madan (1999)
+struct CarrMadanSettings {
+  int size{4096};     //	FFT points, powers of 2 fastest
+  double eta{0.25};   //	frequency spacing, 2 pi / (size eta) in k
+  double alpha{1.5};  //	damping exp(alpha k) of the call in log strike
+};
+
+//	calls of a model with known characteristic function by one FFT, Carr &
+//	Madan (1999) with Simpson weights
+//	the log strikes k = log(K / F) form a uniform grid of size points
+//	centred on the requested strikes, the calls on it are interpolated at
+//	the strikes by cubics in k
+class CarrMadan {
+ public:
+  //	phi(u) = E[exp(i u log(F_T / F))], calls undiscounted, the whole grid
+  //	is returned in gridStrikes and gridCalls when given
+  static void calls(const function<complex<double>(complex<double>)>& phi,
+                    double forward, const mVector<double>& strikes,
+                    mVector<double>& calls,
+                    const CarrMadanSettings& settings = {},
+                    mVector<double>* gridStrikes = nullptr,
+                    mVector<double>* gridCalls = nullptr);
+};
+
+#endif  // FDM_WORLD_LIB_FFT_HPP
@@ -0,0 +1,47 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_FOKKER_PLANCK_HPP
+#define FDM_WORLD_LIB_FOKKER_PLANCK_HPP
+
+#include "fdmOperator1d.hpp"
+#include "fdmTimeGrid.hpp"
+
+//	forward (Fokker-Planck) engine for 1d operators
+//	the discrete density p evolves with the transpose of the backward theta
+//	step, p <- E^T B^-T p with B = I - theta dt L, E = I + (1 - theta) dt L,
+//	so p . g at t_k is the backward price of the terminal condition g rolled
+//	back from t_k by ThetaSolver on the same grids, for every g at once
+class FokkerPlanckSolver {
+ public:
+  //	c'tor
+  explicit FokkerPlanckSolver(const FdmOperator1d& op);
+
+  //	one step of size dt
+  void step(mVector<double>& p, double dt, double theta);
+
+  //	discrete density at t = 0: the interpolation weights at x0, the adjoint
+  //	of FdmGrid::interpolate()
+  static void dirac(const FdmGrid& x, double x0, mVector<double>& p);
+
+  //	undiscounted calls p . g_K with the cell averaged payoffs g_K of
+  //	FdmGrid::vanillaAverage(), from suffix sums of p
+  static void calls(const FdmGrid& x, const mVector<double>& p,
+                    const mVector<double>& strikes, mVector<double>& prices);
+
+  //	rolls the density from x0 over the time grid and fills the calls on
+  //	every strike (cols) at every maturity (rows), maturities must be nodes
+  void callSurface(double x0, const FdmTimeGrid& times,
+                   const mVector<double>& maturities,
+                   const mVector<double>& strikes, mMatrix<double>& surface);
+
+ private:
+  const FdmOperator1d* myOp;
+
+  //	I - thetaDt L, factorised
+  Tridiagonal<double> myImplicit;
+  double myThetaDt{0.0};
+  int myVersion{-1};
+
+  mVector<double> myTmp;
+};
+
+#endif  // FDM_WORLD_LIB_FOKKER_PLANCK_HPP
@@ -0,0 +1,100 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_GRID_TUNER_HPP
+#define FDM_WORLD_LIB_GRID_TUNER_HPP
+
+#include <functional>
+#include <string>
+
+#include "HestonFdm.hpp"
+#include "thetaScheme.hpp"
+
+using std::function;
+using std::string;
+
+//	search space of the tuner, sizes relative to the settings passed in
+struct GridTunerSettings {
+  double minScale{0.25};       //	coarsest candidate
+  double maxScale{2.0};        //	finest candidate
+  double step{1.41421356};     //	between successive candidates
+  double referenceScale{2.0};  //	reference from this scale and twice it
+  int order{2};                //	convergence order of the extrapolation
+  int repeats{3};              //	timed runs of a candidate, fastest kept
+};
+
+//	outcome of a search
+struct GridTunerReport {
+  mVector<double> reference;   //	extrapolated outputs
+  double referenceError{0.0};  //	its estimate over the tolerance, max
+  mVector<double> errors;      //	of the chosen setting against the reference
+  double seconds{0.0};         //	per pricing with the chosen setting
+  int candidates{0};           //	settings priced during the search
+};
+
+//	pricing of a product family on a setting, the outputs are the prices and
+//	greeks the tolerances apply to
+using GridPricer1d = function<void(const FdmSettings1d&, mVector<double>&)>;
+using GridPricer2d = function<void(const HestonFdmSettings&, mVector<double>&)>;
+
+//	accuracy targeted grid selection: the cheapest setting whose outputs all
+//	lie within their tolerance of a Richardson extrapolated reference
+//	  ref = f(h) + (f(h) - f(2h)) / (2^p - 1)
+//	with f(2h) and f(h) from the settings scaled by referenceScale and twice
+//	that, all sizes and time steps together
+//	candidates are the settings scaled from minScale to maxScale, times
+//	0.5, 1 or 2 the time steps, for every scheme option (compact operator,
+//	ADI scheme), each ladder is climbed until it meets the tolerance or
+//	gets slower than the best so far, and the winner is timed repeats times
+//	tolerances are absolute, one per output, the last one repeated
+class GridTuner {
+ public:
+  //	the chosen setting replaces settings, false when the reference is not
+  //	within tolerance itself or no candidate meets it, settings then stay
+  static bool tune(const GridPricer1d& pricer,
+                   const mVector<double>& tolerances, FdmSettings1d& settings,
+                   const GridTunerSettings& tuner = {},
+                   GridTunerReport* report = nullptr);
+  static bool tune(const GridPricer2d& pricer,
+                   const mVector<double>& tolerances,
+                   HestonFdmSettings& settings,
+                   const GridTunerSettings& tuner = {},
+                   GridTunerReport* report = nullptr);
+};
+
+//	tuned settings per product family, persisted as lines
+//	  family key value
+//	with # comments, to be loaded once at startup and read by the pricers
+//	keys are the members of the settings structs, enums as their index, and
+//	keys missing from the file keep the value of the settings passed to get()
+class GridConfig {
+ public:
+  //	replaces the entries, false when the file cannot be opened or a line
+  //	is malformed
+  bool load(const string& path);
+  bool save(const string& path) const;
+
+  //	store every member of the settings under family
+  void set(const string& family, const FdmSettings1d& settings);
+  void set(const string& family, const HestonFdmSettings& settings);
+
+  //	overwrite settings with the stored members, false for unknown families
+  bool get(const string& family, FdmSettings1d& settings) const;
+  bool get(const string& family, HestonFdmSettings& settings) const;
+
+  //	single entries
+  void set(const string& family, const string& key, double value);
+  bool get(const string& family, const string& key, double& value) const;
+  bool has(const string& family) const;
+
+  //	funcs
+  int size() const { return myKeys.size(); }
+  void clear();
+
+ private:
+  int find(const string& family, const string& key) const;
+
+  vector<string> myFamilies;
+  vector<string> myKeys;
+  vector<double> myValues;
+};
+
+#endif  // FDM_WORLD_LIB_GRID_TUNER_HPP
@@ -0,0 +1,99 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_INTERPOLATION_HPP
+#define FDM_WORLD_LIB_INTERPOLATION_HPP
+
+#include "mMatrix.hpp"
+
+//	piecewise linear, cubic splines with natural (zero curvature) or clamped
+//	(given slope) ends, and the monotone cubic of Fritsch & Carlson (1980)
+//	which keeps the shape of monotone data
+enum class InterpolationType { Linear, NaturalCubic, ClampedCubic, Monotone };
+
+//	interpolation of values on increasing knots, extrapolated flat
+//	the cubic of every interval is stored once as its 4 coefficients in
+//	x - x_j, contiguous interval after interval, evaluation is then a
+//	Horner sum
+//	knots are located in O(1) when uniform and by bisection otherwise,
+//	batches of increasing queries walk the knots instead
+class Interpolator1d {
+ public:
+  //	c'tors, the slopes are the end slopes of clamped splines
+  Interpolator1d() = default;
+  Interpolator1d(const mVector<double>& x, const mVector<double>& y,
+                 InterpolationType type = InterpolationType::NaturalCubic,
+                 double leftSlope = 0.0, double rightSlope = 0.0);
+
+  //	single point
+  double value(double x) const;
+  double derivative(double x) const;
+
+  //	every point of x
+  void values(const mVector<double>& x, mVector<double>& res) const;
+  void derivatives(const mVector<double>& x, mVector<double>& res) const;
+
+  //	funcs
+  const mVector<double>& knots() const { return myKnots; }
+  int size() const { return myKnots.size(); }
+  bool empty() const { return myKnots.empty(); }
+
+  //	interval j holding x, clamped to the knots
+  int locate(double x) const;
+
+  //	coefficients c_j0..c_j3 of interval j, the value at x is
+  //	  c_j0 + c_j1 u + c_j2 u^2 + c_j3 u^3, u = x - x_j
+  const double* coefficients(int j) const { return &myCoeffs[4 * j]; }
+
+ private:
+  mVector<double> myKnots;
+  vector<double> myCoeffs;
+
+  //	1 / step of uniform knots, 0 otherwise
+  double myUniform{0.0};
+};
+
+//	tensor product interpolation of values on a lattice of increasing x
+//	(rows) and y (cols) knots, extrapolated flat: bilinear for Linear,
+//	bicubic Hermite otherwise, with the slopes and cross derivatives at the
+//	knots taken from the 1d interpolation of the given type along each
+//	direction (zero end slopes for ClampedCubic)
+//	the 16 coefficients of every cell are stored once, contiguous cell
+//	after cell along the rows
+class Interpolator2d {
+ public:
+  //	c'tors
+  Interpolator2d() = default;
+  Interpolator2d(const mVector<double>& x, const mVector<double>& y,
+                 const mMatrix<double>& z,
+                 InterpolationType type = InterpolationType::NaturalCubic);
+
+  //	single point
+  double value(double x, double y) const;
+
+  //	at the points (x_i, y_i)
+  void values(const mVector<double>& x, const mVector<double>& y,
+              mVector<double>& res) const;
+
+  //	on the lattice x by y, res(i, j) at (x_i, y_j)
+  void grid(const mVector<double>& x, const mVector<double>& y,
+            mMatrix<double>& res) const;
+
+  //	funcs
+  const mVector<double>& xKnots() const { return myX; }
+  const mVector<double>& yKnots() const { return myY; }
+  bool empty() const { return myCoeffs.empty(); }
+
+ private:
+  //	cell (i, j) at local u = x - x_i, v = y - y_j
+  double cell(int i, int j, double u, double v) const;
+
+  mVector<double> myX, myY;
+  vector<double> myCoeffs;
+
+  //	cells in y, at least one
+  int myCells{1};
+
+  //	1 / step of uniform knots, 0 otherwise
+  double myUniformX{0.0}, myUniformY{0.0};
+};
+
+#endif  // FDM_WORLD_LIB_INTERPOLATION_HPP
@@ -0,0 +1,88 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_LOCAL_VOL_SURFACE_HPP
+#define FDM_WORLD_LIB_LOCAL_VOL_SURFACE_HPP
+
+#include "tridiagonal.hpp"
+
+//	local volatility sigma(t, x) on a lattice of times (rows) and strikes
+//	(cols), interpolated by a tensor product natural cubic spline and
+//	extrapolated flat
+//	a pde samples the surface on the same space nodes every step: fixing the
+//	nodes with setPoints() evaluates the strike splines once and stores for
+//	every node the coefficients of its spline in time, after which
+//	volatilities(t) is one cubic per node with weights shared by all nodes
+class LocalVolSurface {
+ public:
+  //	c'tors
+  LocalVolSurface() = default;
+  LocalVolSurface(const mVector<double>& times, const mVector<double>& strikes,
+                  const mMatrix<double>& vols);
+
+  //	flat surface
+  static LocalVolSurface flat(double volatility);
+
+  //	single point, solves the time spline on the fly
+  double volatility(double t, double x) const;
+
+  //	fix the space nodes
+  void setPoints(const mVector<double>& x);
+
+  //	sigma(t, x_i) on every node fixed by setPoints()
+  void volatilities(double t, mVector<double>& res) const;
+
+  //	adjoint of volatilities(): adds the gradient of an output with respect
+  //	to sigma(t, x_i) on the fixed nodes
+  void volatilitiesAdjoint(double t, const mVector<double>& gradient);
+
+  //	gradient with respect to the lattice vols (times by strikes, as given
+  //	to the c'tor) of all the adjoints added since setPoints()
+  void gradient(mMatrix<double>& res) const;
+
+  //	funcs
+  const mVector<double>& times() const { return myTimes; }
+  const mVector<double>& strikes() const { return myStrikes; }
+
+ private:
+  //	knot interval holding x, clamped
+  static int locate(const mVector<double>& knots, double x);
+
+  //	natural spline system on the knots, factorised
+  static void splineMatrix(const mVector<double>& knots,
+                           Tridiagonal<double>& res);
+
+  //	second derivatives of the natural splines through the columns of y
+  static void splineCurvatures(const mVector<double>& knots,
+                               const Tridiagonal<double>& matrix,
+                               const mMatrix<double>& y, mMatrix<double>& res);
+
+  //	transpose of the right hand side of splineCurvatures(), adds to yBar
+  static void splineRhsAdjoint(const mVector<double>& knots,
+                               const mMatrix<double>& rBar,
+                               mMatrix<double>& yBar);
+
+  //	cubic weights of the values and curvatures on knots j and j + 1 at x
+  static void splineWeights(const mVector<double>& knots, int j, double x,
+                            double* weights);
+
+  //	strike splines of every time row at x
+  void rowValues(double x, mVector<double>& res) const;
+
+  mVector<double> myTimes, myStrikes;
+  int myInputTimes{0}, myInputStrikes{0};
+
+  //	strikes (rows) by times (cols): vols and their curvatures in strike
+  mMatrix<double> myVols, myVolCurvatures;
+  Tridiagonal<double> myStrikeMatrix, myTimeMatrix;
+
+  //	nodes fixed by setPoints()
+  mVector<double> myPoints;
+
+  //	times (rows) by nodes (cols): values at the nodes and their curvatures
+  //	in time
+  mMatrix<double> myNodeVols, myNodeCurvatures;
+
+  //	adjoints of the node values and curvatures
+  mMatrix<double> myNodeVolsBar, myNodeCurvaturesBar;
+};
+
+#endif  // FDM_WORLD_LIB_LOCAL_VOL_SURFACE_HPP
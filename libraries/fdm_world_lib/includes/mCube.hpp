@@ -0,0 +1,136 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_MCUBE_HPP
+#define FDM_WORLD_LIB_MCUBE_HPP
+
+#include "mMatrix.hpp"
+
+//	3d array on the conventions of mMatrix: element (i, j, k) at
+//	(i * cols + j) * depth + k, so that every slab i is a cols by depth
+//	mMatrix in memory and every line (i, j) a contiguous vector
+//	the layout is plain row major, not tiled: cache blocking is done by the
+//	sweeps instead, those along i and j run on blocks of contiguous k lines,
+//	which keeps the working set of a sweep to one slab, while the k lines
+//	stay contiguous for the z sweeps and views
+template <typename T = double>
+class mCube {
+ public:
+  //	declarations
+  using Container = vector<T>;
+  using value_type = T;
+
+  //	trivi c'tors
+  mCube() = default;
+  mCube(size_t rows, size_t cols, size_t depth)
+      : myData(rows * cols * depth),
+        myRows((int)rows),
+        myCols((int)cols),
+        myDepth((int)depth) {}
+  mCube(size_t rows, size_t cols, size_t depth, T t0)
+      : myData(rows * cols * depth, t0),
+        myRows((int)rows),
+        myCols((int)cols),
+        myDepth((int)depth) {}
+  mCube(const mCube& rhs) = default;
+  mCube(mCube&& rhs) noexcept = default;
+  ~mCube() noexcept = default;
+
+  //	trivi assign
+  mCube& operator=(const mCube& rhs) = default;
+  mCube& operator=(mCube&& rhs) = default;
+
+  //	assign from single value
+  mCube& operator=(const T& t) {
+    const int s = (int)myData.size();
+    for (int i = 0; i < s; ++i) myData[i] = t;
+    return *this;
+  }
+
+  //	funcs
+  int rows() const { return myRows; }
+  int cols() const { return myCols; }
+  int depth() const { return myDepth; }
+  int size() const { return (int)myData.size(); }
+  bool empty() const { return size() == 0; }
+
+  //	row,col,layer to idx
+  int ijkToIdx(int i, int j, int k) const {
+    return (i * myCols + j) * myDepth + k;
+  }
+  int ijToIdx(int i, int j) const { return (i * myCols + j) * myDepth; }
+  int iToIdx(int i) const { return i * myCols * myDepth; }
+
+  //	get element
+  const T& operator()(int i, int j, int k) const {
+#ifdef _DEBUG
+    if (i < 0 || i >= myRows || j < 0 || j >= myCols || k < 0 ||
+        k >= myDepth)
+      throw std::runtime_error("mCube subscript out of range");
+#endif
+    return myData[ijkToIdx(i, j, k)];
+  }
+  T& operator()(int i, int j, int k) {
+#ifdef _DEBUG
+    if (i < 0 || i >= myRows || j < 0 || j >= myCols || k < 0 ||
+        k >= myDepth)
+      throw std::runtime_error("mCube subscript out of range");
+#endif
+    return myData[ijkToIdx(i, j, k)];
+  }
+
+  const T& operator[](int i) const {
+#ifdef _DEBUG
+    if (i < 0 || i >= size())
+      throw std::runtime_error("mCube subscript out of range");
+#endif
+    return myData[i];
+  }
+  T& operator[](int i) {
+#ifdef _DEBUG
+    if (i < 0 || i >= size())
+      throw std::runtime_error("mCube subscript out of range");
+#endif
+    return myData[i];
+  }
+
+  //	resize, the content is not kept unless the shape is unchanged
+  void resize(size_t rows, size_t cols, size_t depth) {
+    myData.resize(rows * cols * depth);
+    myRows = (int)rows;
+    myCols = (int)cols;
+    myDepth = (int)depth;
+  }
+  void clear() { resize(0, 0, 0); }
+
+  //	data
+  const Container& data() const { return myData; }
+  Container& data() { return myData; }
+
+  //	get cube as vector view
+  const mVectorView<T> asVector() const { return mVectorView<T>(myData); }
+  mVectorView<T> asVector() { return mVectorView<T>(myData); }
+
+  //	get slab i as a cols by depth matrix view
+  const mMatrixView<T> operator()(int i) const {
+    return mMatrixView<T>(&myData[iToIdx(i)], myCols, myDepth);
+  }
+  mMatrixView<T> operator()(int i) {
+    return mMatrixView<T>(&myData[iToIdx(i)], myCols, myDepth);
+  }
+
+  //	get line (i, j) as a vector view
+  const mVectorView<T> operator()(int i, int j) const {
+    T* t = &(const_cast<mCube*>(this)->myData[ijToIdx(i, j)]);
+    return mVectorView<T>(t, myDepth);
+  }
+  mVectorView<T> operator()(int i, int j) {
+    return mVectorView<T>(&myData[ijToIdx(i, j)], myDepth);
+  }
+
+ private:
+  Container myData;
+  int myRows{0};
+  int myCols{0};
+  int myDepth{0};
+};
+
+#endif  // FDM_WORLD_LIB_MCUBE_HPP
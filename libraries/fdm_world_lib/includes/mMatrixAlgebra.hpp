@@ -2,6 +2,9 @@
 #ifndef FDM_WORLD_LIB_MMATRIX_ALGEBRA_HPP
 #define FDM_WORLD_LIB_MMATRIX_ALGEBRA_HPP
 
+#include <cmath>
+#include <utility>
+
 #include "mMatrix.hpp"
 
 namespace mMatrixAlgebra {
@@ -25,6 +28,153 @@ void mmult(const mMatrix<U>& a, const mMatrix<V>& b, mMatrix<W>& ab) {
   //	done
   return;
 }
+
+//	in place LU factors with partial pivoting, P A = L U with unit L below
+//	the diagonal and U on and above it, rows k and pivots[k] swapped in turn
+//	right looking by panels of block columns: the panel is factorised alone,
+//	then the block row of U and the rank block update of the trailing matrix
+//	run row by row over contiguous memory
+//	returns false on a zero pivot
+template <class T>
+bool lu(mMatrix<T>& a, vector<int>& pivots, int block = 64) {
+  const int n = a.rows();
+  pivots.resize(n);
+
+  for (int kb = 0; kb < n; kb += block) {
+    const int ke = min(kb + block, n);
+
+    //	panel, whole rows swapped
+    for (int k = kb; k < ke; ++k) {
+      int p = k;
+      for (int i = k + 1; i < n; ++i)
+        if (std::abs(a(i, k)) > std::abs(a(p, k))) p = i;
+      pivots[k] = p;
+      if (a(p, k) == T(0.0)) return false;
+      if (p != k)
+        for (int j = 0; j < n; ++j) std::swap(a(k, j), a(p, j));
+
+      const T pivot = T(1.0) / a(k, k);
+      const T* uk = &a(k, 0);
+      for (int i = k + 1; i < n; ++i) {
+        T* ai = &a(i, 0);
+        const T l = ai[k] *= pivot;
+        for (int j = k + 1; j < ke; ++j) ai[j] -= l * uk[j];
+      }
+    }
+
+    //	block row of U
+    for (int i = kb + 1; i < ke; ++i) {
+      T* ai = &a(i, 0);
+      for (int p = kb; p < i; ++p) {
+        const T l = ai[p];
+        const T* up = &a(p, 0);
+        for (int j = ke; j < n; ++j) ai[j] -= l * up[j];
+      }
+    }
+
+    //	trailing update
+    for (int i = ke; i < n; ++i) {
+      T* ai = &a(i, 0);
+      for (int p = kb; p < ke; ++p) {
+        const T l = ai[p];
+        const T* up = &a(p, 0);
+        for (int j = ke; j < n; ++j) ai[j] -= l * up[j];
+      }
+    }
+  }
+
+  //	done
+  return true;
+}
+
+//	solve A X = B for all columns of B in place with the factors of lu()
+template <class T>
+void luSolve(const mMatrix<T>& lu, const vector<int>& pivots,
+             mMatrix<T>& b) {
+  const int n = lu.rows();
+  const int m = b.cols();
+  for (int k = 0; k < n; ++k)
+    if (pivots[k] != k)
+      for (int j = 0; j < m; ++j) std::swap(b(k, j), b(pivots[k], j));
+
+  for (int i = 1; i < n; ++i) {
+    T* bi = &b(i, 0);
+    for (int p = 0; p < i; ++p) {
+      const T l = lu(i, p);
+      const T* bp = &b(p, 0);
+      for (int j = 0; j < m; ++j) bi[j] -= l * bp[j];
+    }
+  }
+
+  for (int i = n - 1; i >= 0; --i) {
+    T* bi = &b(i, 0);
+    for (int p = i + 1; p < n; ++p) {
+      const T u = lu(i, p);
+      const T* bp = &b(p, 0);
+      for (int j = 0; j < m; ++j) bi[j] -= u * bp[j];
+    }
+    const T pivot = T(1.0) / lu(i, i);
+    for (int j = 0; j < m; ++j) bi[j] *= pivot;
+  }
+}
+
+//	in place Cholesky factor A = L L^T of a symmetric positive definite
+//	matrix, L on and below the diagonal from the lower half of A, the upper
+//	half is left as is
+//	row by row over contiguous memory, returns false on a non positive pivot
+template <class T>
+bool cholesky(mMatrix<T>& a) {
+  const int n = a.rows();
+  for (int i = 0; i < n; ++i) {
+    T* li = &a(i, 0);
+    for (int j = 0; j <= i; ++j) {
+      const T* lj = &a(j, 0);
+      T s = li[j];
+      for (int k = 0; k < j; ++k) s -= li[k] * lj[k];
+      if (j < i) {
+        li[j] = s / lj[j];
+      } else {
+        if (!(s > T(0.0))) return false;
+        li[i] = std::sqrt(s);
+      }
+    }
+  }
+
+  //	done
+  return true;
+}
+
+//	solve A X = B for all columns of B in place with the factor of
+//	cholesky()
+template <class T>
+void choleskySolve(const mMatrix<T>& l, mMatrix<T>& b) {
+  const int n = l.rows();
+  const int m = b.cols();
+
+  //	L Y = B
+  for (int i = 0; i < n; ++i) {
+    T* bi = &b(i, 0);
+    for (int p = 0; p < i; ++p) {
+      const T lip = l(i, p);
+      const T* bp = &b(p, 0);
+      for (int j = 0; j < m; ++j) bi[j] -= lip * bp[j];
+    }
+    const T pivot = T(1.0) / l(i, i);
+    for (int j = 0; j < m; ++j) bi[j] *= pivot;
+  }
+
+  //	L^T X = Y
+  for (int i = n - 1; i >= 0; --i) {
+    T* bi = &b(i, 0);
+    for (int p = i + 1; p < n; ++p) {
+      const T lpi = l(p, i);
+      const T* bp = &b(p, 0);
+      for (int j = 0; j < m; ++j) bi[j] -= lpi * bp[j];
+    }
+    const T pivot = T(1.0) / l(i, i);
+    for (int j = 0; j < m; ++j) bi[j] *= pivot;
+  }
+}
 }  // namespace mMatrixAlgebra
 
 #endif  // FDM_WORLD_LIB_MMATRIX_ALGEBRA_HPP
\ No newline at end of file
@@ -0,0 +1,198 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_MULTIGRID_HPP
+#define FDM_WORLD_LIB_MULTIGRID_HPP
+
+#include <functional>
+
+#include "fdmOperator2d.hpp"
+
+using std::function;
+
+//	V cycles visit every coarse level once, W cycles twice
+enum class MultigridCycle { V, W };
+
+struct MultigridSettings {
+  MultigridCycle cycle{MultigridCycle::V};
+  int preSmooth{1};         //	zebra line sweeps in both directions
+  int postSmooth{1};        //	before and after the coarse correction
+  double tolerance{1e-10};  //	on the residual relative to the rhs
+  int maxIterations{50};    //	cycles, or BiCGStab iterations
+};
+
+//	geometric multigrid for the implicit systems (I - thetaDt A) u = f of a
+//	second order FdmOperator2d, mixed term included, see Trottenberg et al
+//	(2001)
+//	the nine point stencil is coarsened by vertex coarsening, the coarse
+//	nodes of a direction are every other node and the last one, n -> n / 2 +
+//	1 down to 3 nodes, so that the last coarse cell of an even size spans a
+//	single fine one
+//	the corrections vanish on the sides: the line sweeps solve the side
+//	nodes with their lines and the coarse problems are posed on the interior
+//	only, with identity rows on the sides, as Galerkin products over the
+//	one sided boundary rows (dirichlet rows against the full rows next to
+//	them) diverge once theta dt / h^2 >> 1
+//	bilinear prolongation P between the interior nodes, restriction P^T and
+//	Galerkin coarse operators P^T M P, which stay nine point and need no
+//	grid or coefficients on the coarse levels
+//	Galerkin operators of convection dominated problems with a mixed term
+//	(heston at large theta dt) lose the diagonal weight the line smoother
+//	needs, a rebuild function then rediscretises the operator on the coarse
+//	grids instead, typically with upwind convection, see Clarke & Parrott
+//	(1999)
+//	the smoother is zebra line Gauss-Seidel alternating x and y lines, every
+//	line of a colour solved at once as a vectorised Thomas sweep, robust for
+//	the anisotropy of stretched grids
+//	cycles may diverge where even the fine rows lose their diagonal weight,
+//	e.g. downwind outflow rows of linear sides once theta dt |b| / h passes
+//	about 1 / 2, the BiCGStab wrapper still converges up to about 1
+//	the coarsest level is solved by a dense LU up to 1024 nodes, by a few
+//	extra sweeps otherwise or when its matrix is singular, every cycle is
+//	then O(nodes)
+class Multigrid2d {
+ public:
+  //	c'tor, rebuild assembles a coarse operator constructed on the coarse
+  //	grids, as the fine one was
+  explicit Multigrid2d(
+      const FdmOperator2d& op, const MultigridSettings& settings = {},
+      const function<void(FdmOperator2d&)>& rebuild = nullptr);
+
+  Multigrid2d(const Multigrid2d&) = delete;
+  Multigrid2d& operator=(const Multigrid2d&) = delete;
+
+  //	build the hierarchy of I - thetaDt A, again after the operator is
+  //	reassembled
+  void setup(double thetaDt);
+
+  //	one cycle on u from its current value
+  void cycle(const mMatrix<double>& f, mMatrix<double>& u);
+
+  //	cycles to tolerance from the current u, standalone solver, returns the
+  //	number of cycles
+  int solve(const mMatrix<double>& f, mMatrix<double>& u);
+
+  //	right preconditioned BiCGStab from the current u, one cycle from zero
+  //	per preconditioner application, returns the number of iterations
+  int bicgstab(const mMatrix<double>& f, mMatrix<double>& u);
+
+  //	res = (I - thetaDt A) u
+  void apply(const mMatrix<double>& u, mMatrix<double>& res) const;
+
+  //	funcs
+  int levels() const { return (int)myLevels.size(); }
+  double thetaDt() const { return myThetaDt; }
+
+  //	max norm of the last residual relative to the rhs
+  double residual() const { return myResidual; }
+
+  //	the last setup() found the dense coarsest matrix singular and sweeps
+  //	it instead
+  bool singular() const { return mySingular; }
+
+ private:
+  struct Level {
+    int nx{0}, ny{0};
+
+    //	grids and scale of I - thetaDt A in the stencil, rediscretised only
+    FdmGrid x, y;
+    double scale{1.0};
+
+    //	how the next coarser level halves this one
+    bool coarsenX{false}, coarsenY{false};
+
+    //	stencil as in FdmOperator2d::stencil()
+    vector<mMatrix<double>> stencil;
+
+    //	rhs, solution and residual of the cycle, Thomas scratch
+    mMatrix<double> f, u, r, cp, dp;
+
+    //	coarsest: dense factors over the nodes i * ny + j
+    mMatrix<double> lu;
+    vector<int> pivots;
+  };
+
+  //	r = f - M u on a level, an empty f for zero
+  static void residual(const Level& level, const mMatrix<double>& f,
+                       const mMatrix<double>& u, mMatrix<double>& r);
+
+  //	zebra line sweeps on x lines (columns) and y lines (rows)
+  static void smoothX(Level& level, const mMatrix<double>& f,
+                      mMatrix<double>& u);
+  static void smoothY(Level& level, const mMatrix<double>& f,
+                      mMatrix<double>& u);
+
+  //	x then y lines before the coarse correction, y then x after
+  static void smooth(Level& level, bool pre);
+
+  //	P^T r and u += P e between a level and the next coarser one
+  static void restriction(const Level& fine, const Level& coarse,
+                          const mMatrix<double>& r, mMatrix<double>& res);
+  static void prolongate(const Level& fine, const Level& coarse,
+                         const mMatrix<double>& e, mMatrix<double>& u);
+
+  //	node on a side of the level, out of the coarse correction
+  static bool side(const Level& level, int i, int j) {
+    return i == 0 || j == 0 || i == level.nx - 1 || j == level.ny - 1;
+  }
+
+  //	coarse stencil P^T M P
+  static void galerkin(const Level& fine, Level& coarse);
+
+  //	coarse stencil rediscretised on every other node of the fine grids,
+  //	scaled as P^T M P
+  void rediscretise(const Level& fine, Level& coarse) const;
+
+  //	recursive cycle on level k with its f and u
+  void cycle(int k);
+
+  const FdmOperator2d* myOp;
+  MultigridSettings mySettings;
+  function<void(FdmOperator2d&)> myRebuild;
+  double myThetaDt{0.0};
+  double myResidual{0.0};
+  bool mySingular{false};
+
+  vector<Level> myLevels;
+
+  //	BiCGStab vectors
+  mMatrix<double> myR, myRHat, myP, myV, myS, myT, myY, myZ;
+};
+
+//	fully implicit theta scheme for a 2d operator, the whole operator with
+//	the mixed term solved at once by multigrid, alone or as the
+//	preconditioner of BiCGStab, the interface of AdiSolver
+//	u is rolled in time to maturity, u_t = A u from the payoff at t = 0, the
+//	previous solution is the initial guess of every solve
+class ImplicitSolver2d {
+ public:
+  //	c'tor
+  ImplicitSolver2d(const FdmOperator2d& op, double theta = 0.5,
+                   bool krylov = false, const MultigridSettings& settings = {},
+                   const function<void(FdmOperator2d&)>& rebuild = nullptr);
+
+  //	one step of size dt, with the solver theta or a given one
+  void step(mMatrix<double>& u, double dt);
+  void step(mMatrix<double>& u, double dt, double theta);
+
+  //	timeSteps equal steps over expiry, the first dampingSteps steps are each
+  //	replaced by two implicit half steps (Rannacher)
+  void rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                int dampingSteps = 0);
+
+  //	funcs
+  double theta() const { return myTheta; }
+
+  //	cycles or iterations of all the solves so far
+  int iterations() const { return myIterations; }
+
+ private:
+  const FdmOperator2d* myOp;
+  double myTheta;
+  bool myKrylov;
+  Multigrid2d myMultigrid;
+  bool mySetup{false};
+  int myIterations{0};
+
+  mMatrix<double> myRhs, myA0, myA1, myA2;
+};
+
+#endif  // FDM_WORLD_LIB_MULTIGRID_HPP
@@ -0,0 +1,58 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_PROFILER_HPP
+#define FDM_WORLD_LIB_PROFILER_HPP
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+using std::string;
+using std::vector;
+
+//	named wall clock sections accumulated over calls, reported in the order
+//	they were first hit
+class Profiler {
+ public:
+  //	add seconds to a section
+  void add(const string& section, double seconds);
+
+  //	funcs
+  double seconds(const string& section) const;
+  int calls(const string& section) const;
+  void reset();
+
+  //	one line per section: name, total ms, calls, ms per call
+  string report() const;
+
+ private:
+  int find(const string& section) const;
+
+  vector<string> myNames;
+  vector<double> mySeconds;
+  vector<int> myCalls;
+};
+
+//	adds its lifetime to a profiler section, does nothing without profiler
+class ProfilerScope {
+ public:
+  ProfilerScope(Profiler* profiler, const char* section)
+      : myProfiler(profiler), mySection(section) {
+    if (myProfiler) myStart = std::chrono::steady_clock::now();
+  }
+  ~ProfilerScope() {
+    if (!myProfiler) return;
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - myStart;
+    myProfiler->add(mySection, elapsed.count());
+  }
+
+  ProfilerScope(const ProfilerScope&) = delete;
+  ProfilerScope& operator=(const ProfilerScope&) = delete;
+
+ private:
+  Profiler* myProfiler;
+  const char* mySection;
+  std::chrono::steady_clock::time_point myStart;
+};
+
+#endif  // FDM_WORLD_LIB_PROFILER_HPP
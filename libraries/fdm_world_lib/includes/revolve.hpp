@@ -0,0 +1,94 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_REVOLVE_HPP
+#define FDM_WORLD_LIB_REVOLVE_HPP
+
+#include <algorithm>
+#include <functional>
+#include <string>
+
+using std::function;
+using std::max;
+using std::min;
+using std::string;
+
+//	counts of a checkpointing schedule
+struct RevolveStats {
+  int steps{0};
+  int budget{0};      //	states held at once, the initial one included
+  int repetitions{0};  //	most times a step is advanced in the reverse
+  int advances{0};     //	steps recomputed in the reverse sweep
+  int stores{0};       //	states written to a slot, forward sweep included
+  int restores{0};     //	states read back from a slot
+
+  //	recomputed steps per step of the forward sweep
+  double overhead() const { return steps ? (double)advances / steps : 0.0; }
+};
+
+//	binomial checkpointing (Griewank 1992, "revolve") for the reverse sweep
+//	of a time stepping adjoint
+//	with budget states held, slot 0 being the initial state, the reverse of
+//	steps steps advances each step at most r times where r is the smallest
+//	integer with C(budget + r, budget) >= steps, which is the least total
+//	recomputation for that budget
+//	the schedule drives the caller through callbacks
+//	  store(slot): keep the current state in slot
+//	  restore(slot): make the state in slot current
+//	  advance(from, to): step the current state from step from to step to
+//	  reverse(k): the current state is the one before step k, record step k
+//	              and run its adjoint
+//	the forward sweep is the pricing itself: it stores the checkpoints of the
+//	first branch and leaves the final state current, the reverse sweep then
+//	calls reverse(k) for k = steps - 1 down to 0
+class Revolve {
+ public:
+  //	c'tors, budget < 1 is taken as 1, which gives quadratic recomputation
+  Revolve() = default;
+  Revolve(int steps, int budget);
+
+  //	steps reversible with free checkpoints besides the initial one and
+  //	at most repetitions advances per step, C(free + r + 1, free + 1)
+  static double reversible(int free, int repetitions);
+
+  //	forward sweep
+  void forward(const function<void(int)>& store,
+               const function<void(int, int)>& advance) const;
+
+  //	reverse sweep after forward()
+  void reverse(const function<void(int)>& store,
+               const function<void(int)>& restore,
+               const function<void(int, int)>& advance,
+               const function<void(int)>& reverse) const;
+
+  //	funcs
+  int steps() const { return myStats.steps; }
+  int budget() const { return myStats.budget; }
+
+  //	counts of the schedule, known before it runs
+  const RevolveStats& stats() const { return myStats; }
+
+  //	one line report
+  string report() const;
+
+ private:
+  //	least r with reversible(free, r) >= n
+  static int repetitions(int n, int free);
+
+  //	length of the left part of n steps with free checkpoints
+  static int split(int n, int free);
+
+  //	forward sweep, returns the number of states stored
+  int firstBranch(const function<void(int)>* store,
+                  const function<void(int, int)>* advance) const;
+
+  //	reverse of [a, b) from the state of a in slot, current when it is also
+  //	the current state, spine on the first branch
+  void run(int a, int b, int slot, int free, bool spine, bool current,
+           const function<void(int)>* store,
+           const function<void(int)>* restore,
+           const function<void(int, int)>* advance,
+           const function<void(int)>* reverse, RevolveStats& stats) const;
+
+  RevolveStats myStats;
+};
+
+#endif  // FDM_WORLD_LIB_REVOLVE_HPP
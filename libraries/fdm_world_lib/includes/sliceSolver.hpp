@@ -0,0 +1,64 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_SLICE_SOLVER_HPP
+#define FDM_WORLD_LIB_SLICE_SOLVER_HPP
+
+#include "fdmOperator1d.hpp"
+#include "fdmTimeGrid.hpp"
+#include "threadPool.hpp"
+
+//	state update at fixing number k (from 0): a+ = update(k, a-, x)
+using FdmFixing = function<double(int, double, double)>;
+
+//	theta scheme on a stack of 1d solutions sharing one operator, one slice
+//	per node a_j of an auxiliary state (running average, running maximum)
+//	that only moves at fixing dates
+//	the slices are the rows of one contiguous matrix u(j, i) = V(a_j, x_i):
+//	between fixings they are independent and stepped in parallel chunks of
+//	rows against one factorisation, at a fixing every slice is interpolated
+//	across the others, V(a_j, x_i) <- V(update(a_j, x_i), x_i)
+//	memory is u, one copy of it for the fixings and one row per thread
+class SliceSolver {
+ public:
+  //	c'tor, serial without pool
+  SliceSolver(const FdmOperator1d& op, double theta = 0.5,
+              ThreadPool* pool = nullptr);
+
+  //	one step of size dt of every slice
+  void step(mMatrix<double>& u, double dt, double theta);
+
+  //	fixing number k on the state grid a
+  void fix(const FdmGrid& a, int k, const FdmFixing& update,
+           mMatrix<double>& u);
+
+  //	from the payoff at expiry to 0 with steps landing on the sorted
+  //	fixing dates, a fixing applied once the step reaching it is done, the
+  //	first dampingSteps steps as two implicit half steps
+  void rollback(mMatrix<double>& u, const FdmGrid& a, double expiry,
+                int timeSteps, int dampingSteps,
+                const mVector<double>& fixings, const FdmFixing& update);
+
+  //	V(a0, x0) by interpolation across slices and nodes
+  static double valueAt(const FdmGrid& a, const FdmGrid& x,
+                        const mMatrix<double>& u, double a0, double x0);
+
+ private:
+  //	refactorise I - thetaDt L when thetaDt or the operator changes
+  void factorize(double thetaDt);
+
+  //	serial without pool
+  void parallelFor(int size, const function<void(int, int, int)>& func);
+
+  const FdmOperator1d* myOp;
+  double myTheta;
+  ThreadPool* myPool;
+
+  Tridiagonal<double> myImplicit;
+  double myThetaDt{0.0};
+  int myVersion{-1};
+
+  //	one explicit row per thread, fixing target
+  mMatrix<double> myRows;
+  mMatrix<double> myFixed;
+};
+
+#endif  // FDM_WORLD_LIB_SLICE_SOLVER_HPP
@@ -6,6 +6,7 @@
 
 #include "mMatrix.hpp"
 #include "mVector.hpp"
+#include "threadPool.hpp"
 
 using std::string;
 
@@ -16,11 +17,58 @@ class SolverObjective {
   virtual double deriv(double x) { return 0.0; }
 };
 
+//	residuals r(x) of a least squares fit
+class LeastSquaresObjective {
+ public:
+  virtual ~LeastSquaresObjective() = default;
+
+  //	r(x), called concurrently from the threads of the pool for finite
+  //	difference jacobians
+  virtual void values(const mVector<double>& x, mVector<double>& res) = 0;
+
+  //	dr / dx with one row per residual, false to use finite differences
+  virtual bool jacobian(const mVector<double>& /*x*/,
+                        mMatrix<double>& /*res*/) {
+    return false;
+  }
+};
+
+struct LevenbergMarquardtSettings {
+  int maxIterations{100};
+  double tolerance{1e-10};    //	on the gradient and the relative step
+  double lambda{1e-3};        //	initial damping, relative to diag(J^T J)
+  double bump{1e-6};          //	relative finite difference bump
+  ThreadPool* pool{nullptr};  //	jacobian columns in parallel when given
+  mVector<double> lower;      //	box bounds, empty for none
+  mVector<double> upper;
+};
+
+struct LevenbergMarquardtReport {
+  int iterations{0};
+  int evaluations{0};   //	residual vectors, jacobian columns included
+  double cost{0.0};     //	|r|^2 / 2 at the solution
+  double lambda{0.0};   //	last damping, to warm start the next fit
+  double seconds{0.0};  //	total wall clock
+  double secondsPerIteration{0.0};
+  bool converged{false};
+};
+
 //	solver
 class Solver {
  public:
   static bool newtonRaphson(SolverObjective& obj, double& x, int& numIter,
                             double& epsilon, string* error);
+
+  //	least squares fit from x, warm started by the previous solution and
+  //	the damping of its report
+  //	damped normal equations (J^T J + lambda diag(J^T J)) dx = -J^T r by
+  //	dense Cholesky, lambda updated from the gain ratio as in Nielsen
+  //	(1999), trial points clamped to the bounds
+  //	returns true on convergence, x is the best point either way
+  static bool levenbergMarquardt(
+      LeastSquaresObjective& obj, mVector<double>& x,
+      const LevenbergMarquardtSettings& settings = {},
+      LevenbergMarquardtReport* report = nullptr);
 };
 
 #endif  // FDM_WORLD_LIB_SOLVER_HPP
\ No newline at end of file
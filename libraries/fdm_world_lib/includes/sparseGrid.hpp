@@ -0,0 +1,36 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_SPARSE_GRID_HPP
+#define FDM_WORLD_LIB_SPARSE_GRID_HPP
+
+#include "mVector.hpp"
+#include "threadPool.hpp"
+
+//	one sub-grid of the combination technique: level l_i in every direction
+//	and its weight in the combination
+struct SparseGridTerm {
+  vector<int> levels;
+  double coefficient{0.0};
+};
+
+//	sparse grid combination technique, Griebel, Schneider & Zenger (1992)
+//	the solution on the sparse grid of level n in d dimensions is
+//	  sum_q (-1)^q C(d - 1, q) sum_{|l| = n - q} u_l,  q = 0 .. d - 1
+//	where u_l is solved on the anisotropic full grid with levels l, l_i >= 0
+//	the sub-grid solves are independent: they are pulled one at a time by
+//	the threads of a pool, largest first, and each runs serially
+class SparseGrid {
+ public:
+  //	sub-grids of level n in dim dimensions, largest first
+  static void terms(int dim, int level, vector<SparseGridTerm>& res);
+
+  //	sum of the coefficients times solve(levels) over the terms, the
+  //	sub-grid values are returned in values when given, in the order of
+  //	terms()
+  //	solve is called concurrently with a pool and must not use it
+  static double combine(int dim, int level,
+                        const function<double(const vector<int>&)>& solve,
+                        ThreadPool* pool = nullptr,
+                        mVector<double>* values = nullptr);
+};
+
+#endif  // FDM_WORLD_LIB_SPARSE_GRID_HPP
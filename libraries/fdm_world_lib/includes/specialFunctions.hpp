@@ -5,6 +5,7 @@
 #include <cmath>
 
 #include "constants.hpp"
+#include "mVector.hpp"
 
 class SpecialFunctions {
  public:
@@ -16,6 +17,11 @@ class SpecialFunctions {
 
   template <class T>
   static T normalCdf(T x, T& pdf);
+
+  //	n point Gauss-Legendre nodes and weights on [a, b]
+  template <class T>
+  static void gaussLegendre(int n, T a, T b, mVector<T>& nodes,
+                            mVector<T>& weights);
 };
 
 template <class T>
@@ -50,4 +56,38 @@ T SpecialFunctions::normalCdf(T x, T& pdf) {
   return result;
 }
 
+template <class T>
+void SpecialFunctions::gaussLegendre(int n, T a, T b, mVector<T>& nodes,
+                                     mVector<T>& weights) {
+  nodes.resize(n);
+  weights.resize(n);
+
+  //	roots of P_n by Newton from the Chebyshev guess, symmetric in [-1, 1]
+  const int m = (n + 1) / 2;
+  for (int i = 0; i < m; ++i) {
+    T z = std::cos(Constants::pi() * (i + 0.75) / (n + 0.5));
+    T dp = 0.0;
+    for (int iter = 0; iter < 100; ++iter) {
+      T p0 = 1.0, p1 = 0.0;
+      for (int k = 1; k <= n; ++k) {
+        T p2 = p1;
+        p1 = p0;
+        p0 = ((2.0 * k - 1.0) * z * p1 - (k - 1.0) * p2) / k;
+      }
+      dp = n * (z * p0 - p1) / (z * z - 1.0);
+      T dz = p0 / dp;
+      z -= dz;
+      if (fabs(dz) <= Constants::dblPrecision()) break;
+    }
+
+    //	map to [a, b]
+    const T half = 0.5 * (b - a);
+    const T mid = 0.5 * (b + a);
+    const T w = 2.0 * half / ((1.0 - z * z) * dp * dp);
+    nodes[i] = mid - half * z;
+    nodes[n - 1 - i] = mid + half * z;
+    weights[i] = weights[n - 1 - i] = w;
+  }
+}
+
 #endif  // FDM_WORLD_LIB_SPECIAL_FUNCTIONS_HPP
\ No newline at end of file
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_THETA_ADJOINT_HPP
+#define FDM_WORLD_LIB_THETA_ADJOINT_HPP
+
+#include "fdmOperator1d.hpp"
+#include "revolve.hpp"
+#include "threadPool.hpp"
+
+//	gradient of the output with respect to the diffusion scale s_k on every
+//	node and to the discount r_k of step k, handed over in the reverse sweep
+using FdmStepGradient = function<void(int, const mVector<double>&, double)>;
+
+//	discrete adjoint of a sequence of theta steps on a time dependent 1d
+//	operator
+//	  u_k+1 = B_k^-1 E_k u_k, B_k = I - theta_k dt_k L_k,
+//	  E_k = I + (1 - theta_k) dt_k L_k, L_k = diag(s_k) D + R - r_k I
+//	where refresh(k) sets L_k on the shared operator
+//	the forward sweep keeps budget states on a Revolve schedule, the reverse
+//	sweep recomputes the others from them and propagates
+//	lambda_k = E_k^T B_k^-T lambda_k+1, the gradient with respect to every
+//	s_k and r_k then costs about three pricings with the default budget
+class ThetaAdjoint {
+ public:
+  //	budget <= 0: 2 sqrt(steps) states
+  ThetaAdjoint(FdmOperator1d& op, const mVector<double>& dts,
+               const mVector<double>& thetas,
+               const function<void(int)>& refresh, int budget = 0);
+
+  //	forward sweep over every step, keeps the checkpoints
+  void rollback(mVector<double>& u);
+
+  //	reverse sweep from the adjoint of the final state, lambda ends as the
+  //	adjoint of the initial state
+  void adjoint(mVector<double>& lambda, const FdmStepGradient& gradient);
+
+  //	funcs
+  int steps() const { return myDts.size(); }
+  int budget() const { return myRevolve.budget(); }
+
+  //	recomputation of the reverse sweep
+  const Revolve& schedule() const { return myRevolve; }
+
+ private:
+  //	y = B_k^-1 E_k v
+  void step(int k, const double* v, double* y);
+
+  //	from step from to step to in place, through myNext
+  void advance(mVector<double>& u, int from, int to);
+
+  //	refactorise I - thetaDt L when thetaDt or the operator changes
+  void factorize(double thetaDt);
+
+  FdmOperator1d* myOp;
+  mVector<double> myDts, myThetas;
+  function<void(int)> myRefresh;
+  Revolve myRevolve;
+
+  Tridiagonal<double> myImplicit;
+  double myThetaDt{0.0};
+  int myVersion{-1};
+
+  //	budget states (rows), the current state and the step recorded for the
+  //	reverse
+  mMatrix<double> myCheckpoints;
+  mVector<double> myState, myNext;
+
+  mVector<double> myMu, myZ, myDz, myTmp;
+};
+
+#endif  // FDM_WORLD_LIB_THETA_ADJOINT_HPP
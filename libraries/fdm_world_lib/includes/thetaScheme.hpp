@@ -0,0 +1,83 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_THETA_SCHEME_HPP
+#define FDM_WORLD_LIB_THETA_SCHEME_HPP
+
+#include "fdmEvents.hpp"
+#include "fdmOperator1d.hpp"
+#include "fdmTimeGrid.hpp"
+
+//	grid and scheme of the 1d pricers
+struct FdmSettings1d {
+  int xSize{200};
+  int timeSteps{100};
+  int dampingSteps{1};
+  double theta{0.5};
+  double stdDevs{5.0};  //	grid width in standard deviations
+  double density{0.1};  //	concentration around the forward
+  bool compact{false};  //	fourth order compact operator in prices()
+};
+
+//	greeks at one point from the solution at t = 0, one entry per column,
+//	theta is the calendar time decay dV/dt = -L V
+struct FdmGreeks {
+  mVector<double> value, delta, gamma, theta;
+};
+
+//	theta scheme time stepper for a 1d operator
+//	u is rolled in time to maturity, i.e. M u_t = L u from the payoff at t = 0
+//	with M = I unless the operator is compact
+//	the columns of u are independent terminal conditions (a strike ladder or
+//	a set of payoffs): every step applies the explicit part and back
+//	substitutes all columns against one factorisation of M - theta dt L
+class ThetaSolver {
+ public:
+  //	c'tor
+  ThetaSolver(const FdmOperator1d& op, double theta = 0.5);
+
+  //	one step of size dt, with the solver theta or a given one
+  void step(mMatrix<double>& u, double dt);
+  void step(mMatrix<double>& u, double dt, double theta);
+
+  //	timeSteps equal steps over expiry, the first dampingSteps steps are each
+  //	replaced by two implicit half steps (Rannacher)
+  void rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                int dampingSteps = 0);
+
+  //	as above with steps landing on every event time before expiry: the
+  //	events at a date are applied once the step reaching it is done, those
+  //	at expiry to the payoff, and damping restarts after a barrier or a
+  //	jump, the factors are reused between events while the step is unchanged
+  void rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                int dampingSteps, const FdmEventSchedule& events);
+
+  //	from node lastNode of a calendar time grid back to t = 0, the exact
+  //	transpose of FokkerPlanckSolver::rollForward() on the same grid
+  void rollback(mMatrix<double>& u, const FdmTimeGrid& times, int lastNode);
+
+  //	grid greeks at x0 by cubic interpolation of u, L u and their
+  //	derivatives
+  static void greeks(const FdmOperator1d& op, const mMatrix<double>& u,
+                     double x0, FdmGreeks& res);
+
+  //	funcs
+  double theta() const { return myTheta; }
+
+ private:
+  //	refactorise M - thetaDt L when thetaDt or the operator changes
+  void factorize(double thetaDt);
+
+  const FdmOperator1d* myOp;
+  double myTheta;
+
+  //	M - thetaDt L, factorised
+  Tridiagonal<double> myImplicit;
+  double myThetaDt{0.0};
+  int myVersion{-1};
+
+  mMatrix<double> myRhs;
+
+  //	pre jump values of the event transforms
+  mMatrix<double> myEventScratch;
+};
+
+#endif  // FDM_WORLD_LIB_THETA_SCHEME_HPP
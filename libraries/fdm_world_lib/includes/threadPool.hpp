@@ -0,0 +1,56 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_THREAD_POOL_HPP
+#define FDM_WORLD_LIB_THREAD_POOL_HPP
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using std::function;
+using std::vector;
+
+//	fixed pool of worker threads for data parallel loops
+//	the calling thread takes part as thread 0, parallelFor() is not reentrant
+class ThreadPool {
+ public:
+  //	numThreads <= 0: hardware concurrency
+  explicit ThreadPool(int numThreads = 0);
+  ~ThreadPool();
+
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+
+  //	funcs
+  int numThreads() const { return (int)myWorkers.size() + 1; }
+
+  //	calls func(thread, begin, end) on one contiguous chunk of [0, size) per
+  //	thread and returns when all chunks are done, chunk bounds are multiples
+  //	of align
+  void parallelFor(int size, const function<void(int, int, int)>& func,
+                   int align = 1);
+
+  //	chunk [begin, end) of thread out of numThreads
+  static void chunk(int size, int numThreads, int align, int thread,
+                    int& begin, int& end);
+
+ private:
+  void workerLoop(int thread);
+  void runChunk(int thread);
+
+  vector<std::thread> myWorkers;
+  std::mutex myMutex;
+  std::condition_variable myStart;
+  std::condition_variable myDone;
+
+  //	current job
+  const function<void(int, int, int)>* myJob{nullptr};
+  int mySize{0};
+  int myAlign{1};
+  long myGeneration{0};
+  int myPending{0};
+  bool myStop{false};
+};
+
+#endif  // FDM_WORLD_LIB_THREAD_POOL_HPP
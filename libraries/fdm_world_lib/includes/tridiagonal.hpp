@@ -0,0 +1,177 @@
+#pragma once
+#ifndef FDM_WORLD_LIB_TRIDIAGONAL_HPP
+#define FDM_WORLD_LIB_TRIDIAGONAL_HPP
+
+#include "mMatrix.hpp"
+
+//	tridiagonal matrix, row i is lower(i) x_i-1 + diag(i) x_i + upper(i) x_i+1
+//	factorize() computes the Thomas LU factors once so that the matrix can be
+//	solved against many right hand sides, either one at a time or as the
+//	columns of a matrix whose rows are the unknowns
+template <class T = double>
+class Tridiagonal {
+ public:
+  //	c'tors
+  Tridiagonal() = default;
+  explicit Tridiagonal(int size) { resize(size); }
+
+  //	funcs
+  void resize(int size) {
+    myLower.assign(size, T(0.0));
+    myDiag.assign(size, T(0.0));
+    myUpper.assign(size, T(0.0));
+    myPivots.assign(size, T(0.0));
+    myUppers.assign(size, T(0.0));
+    myFactorized = false;
+  }
+  int size() const { return myDiag.size(); }
+  bool factorized() const { return myFactorized; }
+
+  //	coefficients, writing through these invalidates the factors
+  T& lower(int i) {
+    myFactorized = false;
+    return myLower[i];
+  }
+  T& diag(int i) {
+    myFactorized = false;
+    return myDiag[i];
+  }
+  T& upper(int i) {
+    myFactorized = false;
+    return myUpper[i];
+  }
+  const T& lower(int i) const { return myLower[i]; }
+  const T& diag(int i) const { return myDiag[i]; }
+  const T& upper(int i) const { return myUpper[i]; }
+
+  //	y = A x
+  void apply(const mVectorView<T>& x, mVectorView<T> y) const {
+    const int n = size();
+    if (n == 1) {
+      y[0] = myDiag[0] * x[0];
+      return;
+    }
+    y[0] = myDiag[0] * x[0] + myUpper[0] * x[1];
+    for (int i = 1; i < n - 1; ++i)
+      y[i] = myLower[i] * x[i - 1] + myDiag[i] * x[i] + myUpper[i] * x[i + 1];
+    y[n - 1] = myLower[n - 1] * x[n - 2] + myDiag[n - 1] * x[n - 1];
+  }
+
+  //	y = A^T x
+  void applyTranspose(const mVectorView<T>& x, mVectorView<T> y) const {
+    const int n = size();
+    if (n == 1) {
+      y[0] = myDiag[0] * x[0];
+      return;
+    }
+    y[0] = myDiag[0] * x[0] + myLower[1] * x[1];
+    for (int i = 1; i < n - 1; ++i)
+      y[i] = myUpper[i - 1] * x[i - 1] + myDiag[i] * x[i] +
+             myLower[i + 1] * x[i + 1];
+    y[n - 1] = myUpper[n - 2] * x[n - 2] + myDiag[n - 1] * x[n - 1];
+  }
+
+  //	Y = A X on every column of X
+  void apply(const mMatrixView<T>& x, mMatrixView<T> y) const {
+    const int n = size();
+    const int m = x.cols();
+    for (int i = 0; i < n; ++i) {
+      const T* xc = &x(i, 0);
+      T* yc = &y(i, 0);
+      for (int k = 0; k < m; ++k) yc[k] = myDiag[i] * xc[k];
+      if (i > 0) {
+        const T* xm = &x(i - 1, 0);
+        for (int k = 0; k < m; ++k) yc[k] += myLower[i] * xm[k];
+      }
+      if (i < n - 1) {
+        const T* xp = &x(i + 1, 0);
+        for (int k = 0; k < m; ++k) yc[k] += myUpper[i] * xp[k];
+      }
+    }
+  }
+
+  //	Thomas factors: pivot_i = 1 / (d_i - l_i u'_i-1), u'_i = u_i pivot_i
+  void factorize() {
+    const int n = size();
+    myPivots[0] = T(1.0) / myDiag[0];
+    myUppers[0] = myUpper[0] * myPivots[0];
+    for (int i = 1; i < n; ++i) {
+      myPivots[i] = T(1.0) / (myDiag[i] - myLower[i] * myUppers[i - 1]);
+      myUppers[i] = myUpper[i] * myPivots[i];
+    }
+    myFactorized = true;
+  }
+
+  //	solve A x = rhs in place, factorize() must have been called
+  void solve(mVectorView<T> rhs) const {
+    const int n = size();
+    rhs[0] *= myPivots[0];
+    for (int i = 1; i < n; ++i)
+      rhs[i] = (rhs[i] - myLower[i] * rhs[i - 1]) * myPivots[i];
+    for (int i = n - 2; i >= 0; --i) rhs[i] -= myUppers[i] * rhs[i + 1];
+  }
+
+  //	solve A^T x = rhs in place with the same factors, A = L U gives
+  //	A^T = U^T L^T: a unit lower sweep then an upper sweep
+  void solveTranspose(mVectorView<T> rhs) const {
+    const int n = size();
+    for (int i = 1; i < n; ++i) rhs[i] -= myUppers[i - 1] * rhs[i - 1];
+    rhs[n - 1] *= myPivots[n - 1];
+    for (int i = n - 2; i >= 0; --i)
+      rhs[i] = (rhs[i] - myLower[i + 1] * rhs[i + 1]) * myPivots[i];
+  }
+
+  //	solve A^T X = rhs for all columns in place
+  void solveTranspose(mMatrixView<T> rhs) const {
+    const int n = size();
+    const int m = rhs.cols();
+    for (int i = 1; i < n; ++i) {
+      const T u = myUppers[i - 1];
+      const T* rm = &rhs(i - 1, 0);
+      T* rc = &rhs(i, 0);
+      for (int k = 0; k < m; ++k) rc[k] -= u * rm[k];
+    }
+    {
+      T* rc = &rhs(n - 1, 0);
+      for (int k = 0; k < m; ++k) rc[k] *= myPivots[n - 1];
+    }
+    for (int i = n - 2; i >= 0; --i) {
+      const T l = myLower[i + 1];
+      const T p = myPivots[i];
+      const T* rp = &rhs(i + 1, 0);
+      T* rc = &rhs(i, 0);
+      for (int k = 0; k < m; ++k) rc[k] = (rc[k] - l * rp[k]) * p;
+    }
+  }
+
+  //	solve A X = rhs for all columns in place, the sweeps run along the rows
+  //	so the inner loop is over the contiguous columns
+  void solve(mMatrixView<T> rhs) const {
+    const int n = size();
+    const int m = rhs.cols();
+    {
+      T* rc = &rhs(0, 0);
+      for (int k = 0; k < m; ++k) rc[k] *= myPivots[0];
+    }
+    for (int i = 1; i < n; ++i) {
+      const T l = myLower[i];
+      const T p = myPivots[i];
+      const T* rm = &rhs(i - 1, 0);
+      T* rc = &rhs(i, 0);
+      for (int k = 0; k < m; ++k) rc[k] = (rc[k] - l * rm[k]) * p;
+    }
+    for (int i = n - 2; i >= 0; --i) {
+      const T u = myUppers[i];
+      const T* rp = &rhs(i + 1, 0);
+      T* rc = &rhs(i, 0);
+      for (int k = 0; k < m; ++k) rc[k] -= u * rp[k];
+    }
+  }
+
+ private:
+  mVector<T> myLower, myDiag, myUpper;
+  mVector<T> myPivots, myUppers;
+  bool myFactorized{false};
+};
+
+#endif  // FDM_WORLD_LIB_TRIDIAGONAL_HPP
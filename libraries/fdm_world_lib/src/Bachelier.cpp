@@ -61,3 +61,12 @@ double Bachelier::implied(double expiry, double strike, double price,
   //	done
   return volatility;
 }
+
+void Bachelier::calls(double expiry, const mVector<double>& strikes,
+                      double forward, const mVector<double>& volatilities,
+                      mVector<double>& res) {
+  const int m = strikes.size();
+  res.resize(m);
+  for (int j = 0; j < m; ++j)
+    res[j] = call(expiry, strikes[j], forward, volatilities[j]);
+}
@@ -0,0 +1,227 @@
+#include "BasketFdm.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+namespace {
+
+//	basket payoff averaged over the cell [x_a - h_a, x_a + h_a] of every
+//	direction by a tensor 3 point gauss rule, smooths the kink for the
+//	combination
+double basketPayoff(const BasketFdmProduct& product, const double* x,
+                    const double* h, int n) {
+  static constexpr double nodes[3] = {-0.7745966692414834, 0.0,
+                                      0.7745966692414834};
+  static constexpr double weights[3] = {5.0 / 18.0, 8.0 / 18.0, 5.0 / 18.0};
+
+  int count = 1;
+  for (int a = 0; a < n; ++a) count *= 3;
+
+  double res = 0.0;
+  for (int c = 0; c < count; ++c) {
+    double basket = 0.0, weight = 1.0;
+    for (int a = 0, m = c; a < n; ++a, m /= 3) {
+      basket += product.weights[a] * std::exp(x[a] + nodes[m % 3] * h[a]);
+      weight *= weights[m % 3];
+    }
+    res += weight * (product.isCall ? max(0.0, basket - product.strike)
+                                    : max(0.0, product.strike - basket));
+  }
+
+  //	done
+  return res;
+}
+
+//	half cell widths around node i
+double halfCell(const FdmGrid& x, int i) {
+  const int n = x.size();
+  return 0.25 * (x[min(i + 1, n - 1)] - x[max(i - 1, 0)]);
+}
+
+double solve2d(const vector<FdmGrid>& grids, const mVector<double>& vols,
+               const mMatrix<double>& correlations, double rate,
+               const mVector<double>& dividends,
+               const BasketFdmProduct& product,
+               const BasketFdmSettings& settings, const double* at,
+               ThreadPool* pool) {
+  const FdmGrid& x = grids[0];
+  const FdmGrid& y = grids[1];
+  const int nx = x.size();
+  const int ny = y.size();
+
+  FdmCoefficients2d coeffs;
+  coeffs.resize(nx, ny);
+  const double bx = rate - dividends[0] - 0.5 * vols[0] * vols[0];
+  const double by = rate - dividends[1] - 0.5 * vols[1] * vols[1];
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      coeffs.axx(i, j) = 0.5 * vols[0] * vols[0];
+      coeffs.ayy(i, j) = 0.5 * vols[1] * vols[1];
+      coeffs.axy(i, j) = correlations(0, 1) * vols[0] * vols[1];
+      coeffs.bx(i, j) = bx;
+      coeffs.by(i, j) = by;
+      coeffs.r(i, j) = -rate;
+    }
+  }
+  FdmOperator2d op(x, y);
+  op.assemble(coeffs);
+
+  mMatrix<double> u(nx, ny);
+  double node[2], h[2];
+  for (int i = 0; i < nx; ++i) {
+    node[0] = x[i];
+    h[0] = halfCell(x, i);
+    for (int j = 0; j < ny; ++j) {
+      node[1] = y[j];
+      h[1] = halfCell(y, j);
+      u(i, j) = basketPayoff(product, node, h, 2);
+    }
+  }
+
+  AdiSolver solver(op, settings.scheme, settings.theta, pool);
+  solver.rollback(u, product.expiry, settings.timeSteps,
+                  settings.dampingSteps);
+
+  mVector<double> col(nx);
+  for (int i = 0; i < nx; ++i) col[i] = y.interpolate(u(i), at[1]);
+
+  //	done
+  return x.interpolate(col, at[0]);
+}
+
+double solve3d(const vector<FdmGrid>& grids, const mVector<double>& vols,
+               const mMatrix<double>& correlations, double rate,
+               const mVector<double>& dividends,
+               const BasketFdmProduct& product,
+               const BasketFdmSettings& settings, const double* at,
+               ThreadPool* pool) {
+  const FdmGrid& x = grids[0];
+  const FdmGrid& y = grids[1];
+  const FdmGrid& z = grids[2];
+  const int nx = x.size();
+  const int ny = y.size();
+  const int nz = z.size();
+
+  //	constant coefficients, one term each as a function of z
+  const mVector<double> one;
+  auto constant = [&](double c) {
+    FdmSeparable res;
+    res.add(one, one, mVector<double>(nz, c));
+    return res;
+  };
+  FdmCoefficients3d coeffs;
+  coeffs.axx = constant(0.5 * vols[0] * vols[0]);
+  coeffs.ayy = constant(0.5 * vols[1] * vols[1]);
+  coeffs.azz = constant(0.5 * vols[2] * vols[2]);
+  coeffs.axy = constant(correlations(0, 1) * vols[0] * vols[1]);
+  coeffs.axz = constant(correlations(0, 2) * vols[0] * vols[2]);
+  coeffs.ayz = constant(correlations(1, 2) * vols[1] * vols[2]);
+  coeffs.bx = constant(rate - dividends[0] - 0.5 * vols[0] * vols[0]);
+  coeffs.by = constant(rate - dividends[1] - 0.5 * vols[1] * vols[1]);
+  coeffs.bz = constant(rate - dividends[2] - 0.5 * vols[2] * vols[2]);
+  coeffs.r = constant(-rate);
+  FdmOperator3d op(x, y, z);
+  op.assemble(coeffs);
+
+  mCube<double> u(nx, ny, nz);
+  double node[3], h[3];
+  for (int i = 0; i < nx; ++i) {
+    node[0] = x[i];
+    h[0] = halfCell(x, i);
+    for (int j = 0; j < ny; ++j) {
+      node[1] = y[j];
+      h[1] = halfCell(y, j);
+      for (int k = 0; k < nz; ++k) {
+        node[2] = z[k];
+        h[2] = halfCell(z, k);
+        u(i, j, k) = basketPayoff(product, node, h, 3);
+      }
+    }
+  }
+
+  AdiSolver3d solver(op, settings.scheme, settings.theta, pool);
+  solver.rollback(u, product.expiry, settings.timeSteps,
+                  settings.dampingSteps);
+
+  mVector<double> col(nx), row(ny);
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) row[j] = z.interpolate(u(i, j), at[2]);
+    col[i] = y.interpolate(row, at[1]);
+  }
+
+  //	done
+  return x.interpolate(col, at[0]);
+}
+
+//	two or three assets with their vols, dividends, correlations and weights
+void checkAssets(const mVector<double>& spots, const mVector<double>& vols,
+                 const mMatrix<double>& correlations,
+                 const mVector<double>& dividends,
+                 const BasketFdmProduct& product) {
+  const int n = spots.size();
+  if (n < 2 || n > 3)
+    throw std::runtime_error("BasketFdm: two or three assets only");
+  if (vols.size() != n || dividends.size() != n ||
+      product.weights.size() != n || correlations.rows() != n ||
+      correlations.cols() != n)
+    throw std::runtime_error("BasketFdm: inconsistent asset sizes");
+}
+
+}  // namespace
+
+FdmGrid BasketFdm::makeGrid(double spot, double volatility, double rate,
+                            double dividend, double expiry, double stdDevs,
+                            int size) {
+  const double centre = std::log(spot) +
+                        (rate - dividend - 0.5 * volatility * volatility) *
+                            expiry;
+  const double width = stdDevs * volatility * std::sqrt(expiry);
+  return FdmGrid::uniform(centre - width, centre + width, size);
+}
+
+double BasketFdm::solve(const mVector<double>& spots,
+                        const mVector<double>& vols,
+                        const mMatrix<double>& correlations, double rate,
+                        const mVector<double>& dividends,
+                        const BasketFdmProduct& product,
+                        const BasketFdmSettings& settings,
+                        const vector<int>& sizes, ThreadPool* pool) {
+  checkAssets(spots, vols, correlations, dividends, product);
+  const int n = spots.size();
+  if ((int)sizes.size() != n)
+    throw std::runtime_error("BasketFdm: inconsistent asset sizes");
+
+  vector<FdmGrid> grids(n);
+  double at[3];
+  for (int a = 0; a < n; ++a) {
+    grids[a] = makeGrid(spots[a], vols[a], rate, dividends[a],
+                        product.expiry, settings.stdDevs, sizes[a]);
+    at[a] = std::log(spots[a]);
+  }
+
+  //	done
+  return n == 2 ? solve2d(grids, vols, correlations, rate, dividends,
+                          product, settings, at, pool)
+                : solve3d(grids, vols, correlations, rate, dividends,
+                          product, settings, at, pool);
+}
+
+double BasketFdm::price(const mVector<double>& spots,
+                        const mVector<double>& vols,
+                        const mMatrix<double>& correlations, double rate,
+                        const mVector<double>& dividends,
+                        const BasketFdmProduct& product,
+                        const BasketFdmSettings& settings) {
+  checkAssets(spots, vols, correlations, dividends, product);
+  const int n = spots.size();
+  auto solveLevels = [&](const vector<int>& levels) {
+    vector<int> sizes(n);
+    for (int a = 0; a < n; ++a)
+      sizes[a] = (settings.baseSize << levels[a]) + 1;
+    return solve(spots, vols, correlations, rate, dividends, product,
+                 settings, sizes);
+  };
+
+  //	done
+  return SparseGrid::combine(n, settings.level, solveLevels, settings.pool);
+}
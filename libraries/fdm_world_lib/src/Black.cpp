@@ -0,0 +1,76 @@
+#include "Black.hpp"
+
+#include "solver.hpp"
+
+class BlackObj : public SolverObjective {
+ public:
+  //	constructor
+  BlackObj(double expiry, double strike, double price, double forward)
+      : SolverObjective(),
+        myExpiry(expiry),
+        myStrike(strike),
+        myPrice(price),
+        myForward(forward) {}
+
+  //	value
+  virtual double value(double x) {
+    double res = Black::call(myExpiry, myStrike, myForward, x) - myPrice;
+
+    //	done
+    return res;
+  }
+
+  //	deriv
+  virtual double deriv(double x) {
+    double res = Black::vega(myExpiry, myStrike, myForward, x);
+
+    //	done
+    return res;
+  }
+
+  //	private parts
+ private:
+  double myExpiry;
+  double myStrike;
+  double myPrice;
+  double myForward;
+};
+
+//	implied
+double Black::implied(double expiry, double strike, double price,
+                      double forward) {
+  //	calc intrinsic
+  double intrinc = max(0.0, forward - strike);
+  if (price <= intrinc || price >= forward || expiry <= 0.0) return 0.0;
+
+  //	objective
+  BlackObj obj(expiry, strike, price, forward);
+
+  //	start guess at the inflexion point of the price in the volatility,
+  //	Newton then converges monotonically from either side, Brenner &
+  //	Subrahmanyam (1988) at the money where the price is concave
+  const double logFK = std::fabs(std::log(forward / strike));
+  double volatility =
+      logFK > 0.0 ? std::sqrt(2.0 * logFK / expiry)
+                  : std::sqrt(2.0 * Constants::pi() / expiry) * price / forward;
+  int numIter = 50;
+  double epsilon = (price - intrinc) * Constants::epsilon();
+
+  //	solve
+  Solver::newtonRaphson(obj, volatility, numIter, epsilon, nullptr);
+
+  //	bound
+  volatility = max(0.0, volatility);
+
+  //	done
+  return volatility;
+}
+
+void Black::calls(double expiry, const mVector<double>& strikes,
+                  double forward, const mVector<double>& volatilities,
+                  mVector<double>& res) {
+  const int m = strikes.size();
+  res.resize(m);
+  for (int j = 0; j < m; ++j)
+    res[j] = call(expiry, strikes[j], forward, volatilities[j]);
+}
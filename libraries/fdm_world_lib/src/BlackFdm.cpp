@@ -0,0 +1,285 @@
+#include "BlackFdm.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+FdmGrid BlackFdm::makeGrid(double expiry, double forward, double volatility,
+                           const mVector<double>& strikes,
+                           const FdmSettings1d& settings) {
+  double kMin = forward, kMax = forward;
+  for (int k = 0; k < strikes.size(); ++k) {
+    kMin = min(kMin, strikes[k]);
+    kMax = max(kMax, strikes[k]);
+  }
+
+  const double width = settings.stdDevs * volatility * std::sqrt(expiry);
+  const double xMin = kMin * std::exp(-width);
+  const double xMax = kMax * std::exp(width);
+
+  //	done
+  return FdmGrid::concentrated(xMin, xMax, settings.xSize, forward,
+                               settings.density);
+}
+
+void BlackFdm::buildOperator(double volatility, FdmOperator1d& op) {
+  const FdmGrid& x = op.x();
+  const int n = x.size();
+
+  FdmCoefficients1d coeffs;
+  coeffs.resize(n);
+  for (int i = 0; i < n; ++i)
+    coeffs.a[i] = 0.5 * volatility * volatility * x[i] * x[i];
+
+  op.assemble(coeffs);
+}
+
+void BlackFdm::prices(double expiry, const mVector<double>& strikes,
+                      double forward, double volatility, bool isCall,
+                      const FdmSettings1d& settings, mVector<double>& prices,
+                      const FdmEventSchedule* events) {
+  const int m = strikes.size();
+  prices.resize(m);
+  if (m == 0) return;
+
+  if (expiry <= 0.0) {
+    for (int k = 0; k < m; ++k)
+      prices[k] = isCall ? max(0.0, forward - strikes[k])
+                         : max(0.0, strikes[k] - forward);
+    return;
+  }
+
+  FdmOperator1d op(makeGrid(expiry, forward, volatility, strikes, settings));
+  op.setCompact(settings.compact);
+  buildOperator(volatility, op);
+
+  //	one column per strike
+  const FdmGrid& x = op.x();
+  const int n = x.size();
+  mMatrix<double> u(n, m);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < m; ++k)
+      u(i, k) = settings.compact
+                    ? x.vanillaSmoothed(i, strikes[k], isCall)
+                    : x.vanillaAverage(i, strikes[k], isCall);
+
+  ThetaSolver solver(op, settings.theta);
+  if (events && !events->empty())
+    solver.rollback(u, expiry, settings.timeSteps, settings.dampingSteps,
+                    *events);
+  else
+    solver.rollback(u, expiry, settings.timeSteps, settings.dampingSteps);
+
+  x.interpolate(u, forward, prices);
+}
+
+void BlackFdm::callSurface(const mVector<double>& maturities,
+                           const mVector<double>& strikes, double forward,
+                           double volatility, const FdmSettings1d& settings,
+                           mMatrix<double>& surface) {
+  double expiry = 0.0;
+  for (int l = 0; l < maturities.size(); ++l)
+    expiry = max(expiry, maturities[l]);
+
+  FdmOperator1d op(makeGrid(expiry, forward, volatility, strikes, settings));
+  buildOperator(volatility, op);
+
+  const FdmTimeGrid times = FdmTimeGrid::make(
+      maturities, settings.timeSteps, settings.theta, settings.dampingSteps);
+
+  FokkerPlanckSolver solver(op);
+  solver.callSurface(forward, times, maturities, strikes, surface);
+}
+
+void BlackFdm::prices(const FdmGrid& x, const FdmTimeGrid& times,
+                      double expiry, const mVector<double>& strikes,
+                      double forward, double volatility, bool isCall,
+                      mVector<double>& prices) {
+  const int node = times.index(expiry);
+  if (node < 0)
+    throw std::runtime_error("BlackFdm: expiry not on the time grid");
+
+  FdmOperator1d op(x);
+  buildOperator(volatility, op);
+
+  //	cell averaged payoffs, the terminal conditions of the surface calls
+  const int n = x.size();
+  const int m = strikes.size();
+  mMatrix<double> u(n, m);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < m; ++k)
+      u(i, k) = x.vanillaAverage(i, strikes[k], isCall);
+
+  ThetaSolver solver(op);
+  solver.rollback(u, times, node);
+
+  x.interpolate(u, forward, prices);
+}
+
+void BlackFdm::greeks(double expiry, const mVector<double>& strikes,
+                      double forward, double volatility, bool isCall,
+                      const FdmSettings1d& settings, FdmGreeks& greeks,
+                      const FdmEventSchedule* events) {
+  const BlackFdmReval reval(expiry, strikes, forward, volatility, isCall,
+                            settings, events);
+  greeks = reval.greeks();
+}
+
+double BlackFdm::call(double expiry, double strike, double forward,
+                      double volatility, const FdmSettings1d& settings) {
+  mVector<double> strikes(1, strike), res;
+  prices(expiry, strikes, forward, volatility, true, settings, res);
+
+  //	done
+  return res[0];
+}
+
+BlackFdmReval::BlackFdmReval(double expiry, const mVector<double>& strikes,
+                             double forward, double volatility, bool isCall,
+                             const FdmSettings1d& settings,
+                             const FdmEventSchedule* events)
+    : myExpiry(expiry),
+      myVolatility(volatility),
+      mySettings(settings),
+      myOp(BlackFdm::makeGrid(expiry, forward, volatility, strikes, settings)),
+      mySolver(myOp, settings.theta) {
+  if (events) myEvents = *events;
+  BlackFdm::buildOperator(volatility, myOp);
+
+  const FdmGrid& x = myOp.x();
+  const int n = x.size();
+  const int m = strikes.size();
+  myPayoff.resize(n, m);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < m; ++k)
+      myPayoff(i, k) = x.vanillaAverage(i, strikes[k], isCall);
+
+  myBase = myPayoff;
+  if (myEvents.empty())
+    mySolver.rollback(myBase, expiry, settings.timeSteps,
+                      settings.dampingSteps);
+  else
+    mySolver.rollback(myBase, expiry, settings.timeSteps,
+                      settings.dampingSteps, myEvents);
+
+  ThetaSolver::greeks(myOp, myBase, forward, myGreeks);
+}
+
+void BlackFdmReval::reval(double volatility, double forward,
+                          mVector<double>& prices) {
+  const FdmGrid& x = myOp.x();
+  if (volatility == myVolatility) {
+    x.interpolate(myBase, forward, prices);
+    return;
+  }
+
+  if (volatility != myBumpedVolatility) {
+    //	sigma^2 scales the unit diffusion of the base volatility
+    const double s = volatility / myVolatility;
+    myOp.scaleDiffusion(mVector<double>(x.size(), s * s));
+
+    myBumped = myPayoff;
+    if (myEvents.empty())
+      mySolver.rollback(myBumped, myExpiry, mySettings.timeSteps,
+                        mySettings.dampingSteps);
+    else
+      mySolver.rollback(myBumped, myExpiry, mySettings.timeSteps,
+                        mySettings.dampingSteps, myEvents);
+    myBumpedVolatility = volatility;
+  }
+
+  x.interpolate(myBumped, forward, prices);
+}
+
+BlackFdmWarmStart::BlackFdmWarmStart(const mVector<double>& strikes,
+                                     bool isCall, const FdmSettings1d& settings,
+                                     const FdmWarmStartSettings& warm)
+    : myStrikes(strikes),
+      myIsCall(isCall),
+      mySettings(settings),
+      myWarm(warm),
+      mySolver(myOp, settings.theta) {}
+
+void BlackFdmWarmStart::solve(double expiry, double forward,
+                              double volatility) {
+  myExpiry = expiry;
+  myForward = forward;
+  myVolatility = volatility;
+
+  myOp = FdmOperator1d(
+      BlackFdm::makeGrid(expiry, forward, volatility, myStrikes, mySettings));
+  myOp.setCompact(mySettings.compact);
+  BlackFdm::buildOperator(volatility, myOp);
+  mySolver = ThetaSolver(myOp, mySettings.theta);
+
+  const FdmGrid& x = myOp.x();
+  const int n = x.size();
+  const int m = myStrikes.size();
+  myU.resize(n, m);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < m; ++k)
+      myU(i, k) = mySettings.compact
+                      ? x.vanillaSmoothed(i, myStrikes[k], myIsCall)
+                      : x.vanillaAverage(i, myStrikes[k], myIsCall);
+
+  //	the steps of ThetaSolver::rollback(), the solutions after the last
+  //	kept steps are stored
+  const int steps = mySettings.timeSteps;
+  const int damping = min(mySettings.dampingSteps, steps);
+  const int kept = max(0, min(myWarm.slices, steps - damping));
+  const double dt = expiry / steps;
+  mySlices.resize(kept + 1);
+  mySliceTimes.resize(kept + 1);
+
+  for (int k = 0; k < 2 * damping; ++k) mySolver.step(myU, 0.5 * dt, 1.0);
+  for (int k = damping; k <= steps; ++k) {
+    if (k > damping) mySolver.step(myU, dt);
+    if (k < steps - kept) continue;
+    mySlices[k - steps + kept] = myU;
+    mySliceTimes[k - steps + kept] = k * dt;
+  }
+  mySliceTimes[kept] = expiry;
+  myTime = expiry;
+  ++myFullSolves;
+}
+
+void BlackFdmWarmStart::prices(double expiry, double forward,
+                               double volatility, mVector<double>& prices) {
+  const int m = myStrikes.size();
+  prices.resize(m);
+  if (m == 0) return;
+
+  if (expiry <= 0.0) {
+    for (int k = 0; k < m; ++k)
+      prices[k] = myIsCall ? max(0.0, forward - myStrikes[k])
+                           : max(0.0, myStrikes[k] - forward);
+    return;
+  }
+
+  //	time of the kept solve giving the same total variance
+  const double s = myFullSolves ? volatility / myVolatility : 1.0;
+  const double time = expiry * s * s;
+  const double stdDev = myVolatility * std::sqrt(myExpiry);
+  const bool cold =
+      !myFullSolves ||
+      std::fabs(std::log(forward / myForward)) > myWarm.maxShift * stdDev ||
+      std::fabs(time / myExpiry - 1.0) > myWarm.maxVariance ||
+      time < mySliceTimes[0];
+
+  if (cold) {
+    solve(expiry, forward, volatility);
+  } else if (time != myTime) {
+    //	from the latest kept slice before time
+    int l = mySliceTimes.size() - 1;
+    while (l > 0 && mySliceTimes[l] > time) --l;
+    myU = mySlices[l];
+
+    const double span = time - mySliceTimes[l];
+    const double dt = myExpiry / mySettings.timeSteps;
+    const int steps = (int)std::ceil(span / dt - 1e-9);
+    for (int k = 0; k < steps; ++k) mySolver.step(myU, span / steps);
+    myWarmSteps += steps;
+    myTime = time;
+  }
+
+  myOp.x().interpolate(myU, forward, prices);
+}
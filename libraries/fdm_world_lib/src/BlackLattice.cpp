@@ -0,0 +1,153 @@
+#include "BlackLattice.hpp"
+
+#include <cmath>
+
+namespace {
+
+//	Peizer-Pratt method 2 inversion of the normal cdf on n steps
+double peizerPratt(double z, int n) {
+  const double a = z / (n + 1.0 / 3.0 + 0.1 / (n + 1.0));
+  const double h = 0.5 * std::sqrt(1.0 - std::exp(-a * a * (n + 1.0 / 6.0)));
+
+  //	done
+  return z < 0.0 ? 0.5 - h : 0.5 + h;
+}
+
+//	binomial tree on steps levels with up and down factors and probability p
+//	of the up move, values and spots hold the last level on entry
+double binomial(double strike, double sign, bool isAmerican, int steps,
+                double d, double p, double discount, mVector<double>& values,
+                mVector<double>& spots) {
+  double* v = values.data().data();
+  double* x = spots.data().data();
+  const double pu = discount * p;
+  const double pd = discount * (1.0 - p);
+  const double back = 1.0 / d;
+
+  for (int i = steps - 1; i >= 0; --i) {
+    //	node j of level i is node j of level i + 1 moved back down
+    for (int j = 0; j <= i; ++j) v[j] = pd * v[j] + pu * v[j + 1];
+    if (!isAmerican) continue;
+    for (int j = 0; j <= i; ++j) {
+      x[j] *= back;
+      v[j] = max(v[j], sign * (x[j] - strike));
+    }
+  }
+
+  //	done
+  return v[0];
+}
+
+//	trinomial tree, level i has the nodes spot u^k, k = -i .. i, stored from
+//	index 0, at index k + steps in spots
+double trinomial(double strike, double sign, bool isAmerican, int steps,
+                 double pu, double pm, double pd, double discount,
+                 mVector<double>& values, const mVector<double>& spots) {
+  double* v = values.data().data();
+  const double* x = spots.data().data();
+  pu *= discount;
+  pm *= discount;
+  pd *= discount;
+
+  for (int i = steps - 1; i >= 0; --i) {
+    const int n = 2 * i + 1;
+    for (int j = 0; j < n; ++j)
+      v[j] = pd * v[j] + pm * v[j + 1] + pu * v[j + 2];
+    if (!isAmerican) continue;
+    const double* xi = x + steps - i;
+    for (int j = 0; j < n; ++j) v[j] = max(v[j], sign * (xi[j] - strike));
+  }
+
+  //	done
+  return v[0];
+}
+
+double price(double expiry, double strike, double spot, double rate,
+             double dividend, double volatility, bool isCall, bool isAmerican,
+             const LatticeSettings& settings, mVector<double>& values,
+             mVector<double>& spots) {
+  const double sign = isCall ? 1.0 : -1.0;
+  if (expiry <= 0.0 || volatility <= 0.0 || settings.steps < 1) {
+    const double forward = spot * std::exp((rate - dividend) * expiry);
+    const double df = std::exp(-rate * expiry);
+    const double european = df * max(0.0, sign * (forward - strike));
+    return isAmerican ? max(european, sign * (spot - strike)) : european;
+  }
+
+  int n = settings.steps;
+  if (settings.type == LatticeType::LeisenReimer && n % 2 == 0) ++n;
+  const double dt = expiry / n;
+  const double growth = std::exp((rate - dividend) * dt);
+  const double discount = std::exp(-rate * dt);
+
+  if (settings.type == LatticeType::Trinomial) {
+    const double lu = volatility * std::sqrt(3.0 * dt);
+    const double nu = (rate - dividend - 0.5 * volatility * volatility) * dt;
+    const double pu = 1.0 / 6.0 + 0.5 * nu / lu;
+    const double pd = 1.0 / 6.0 - 0.5 * nu / lu;
+
+    values.resize(2 * n + 1);
+    spots.resize(2 * n + 1);
+    for (int k = 0; k <= 2 * n; ++k) {
+      spots[k] = spot * std::exp((k - n) * lu);
+      values[k] = max(0.0, sign * (spots[k] - strike));
+    }
+
+    //	done
+    return trinomial(strike, sign, isAmerican, n, pu, 2.0 / 3.0, pd, discount,
+                     values, spots);
+  }
+
+  double lu, ld, p;
+  if (settings.type == LatticeType::LeisenReimer) {
+    const double sd = volatility * std::sqrt(expiry);
+    const double mu = (rate - dividend) * expiry;
+    const double d1 = (std::log(spot / strike) + mu) / sd + 0.5 * sd;
+    p = peizerPratt(d1 - sd, n);
+    const double up = growth * peizerPratt(d1, n) / p;
+    lu = std::log(up);
+    ld = std::log((growth - p * up) / (1.0 - p));
+  } else {
+    lu = volatility * std::sqrt(dt);
+    ld = -lu;
+    p = (growth - std::exp(ld)) / (std::exp(lu) - std::exp(ld));
+  }
+
+  values.resize(n + 1);
+  spots.resize(n + 1);
+  for (int j = 0; j <= n; ++j) {
+    spots[j] = spot * std::exp(j * lu + (n - j) * ld);
+    values[j] = max(0.0, sign * (spots[j] - strike));
+  }
+
+  //	done
+  return binomial(strike, sign, isAmerican, n, std::exp(ld), p, discount,
+                  values, spots);
+}
+
+}  // namespace
+
+double BlackLattice::price(double expiry, double strike, double spot,
+                           double rate, double dividend, double volatility,
+                           bool isCall, bool isAmerican,
+                           const LatticeSettings& settings) {
+  mVector<double> values, spots;
+
+  //	done
+  return ::price(expiry, strike, spot, rate, dividend, volatility, isCall,
+                 isAmerican, settings, values, spots);
+}
+
+void BlackLattice::prices(double expiry, const mVector<double>& strikes,
+                          double spot, double rate, double dividend,
+                          double volatility, bool isCall, bool isAmerican,
+                          const LatticeSettings& settings,
+                          mVector<double>& prices) {
+  const int m = strikes.size();
+  prices.resize(m);
+
+  mVector<double> values, spots;
+  for (int k = 0; k < m; ++k)
+    prices[k] = ::price(expiry, strikes[k], spot, rate, dividend, volatility,
+                        isCall, isAmerican, settings, values, spots);
+}
@@ -0,0 +1,69 @@
+#include "BlackPathFdm.hpp"
+
+double BlackPathFdm::price(const FdmGrid& a, const mVector<double>& fixings,
+                           double strike, double forward, double volatility,
+                           bool isCall, const FdmSettings1d& settings,
+                           double a0, const FdmFixing& update,
+                           ThreadPool* pool) {
+  const double expiry = fixings[fixings.size() - 1];
+  FdmOperator1d op(BlackFdm::makeGrid(expiry, forward, volatility,
+                                      mVector<double>(1, strike), settings));
+  BlackFdm::buildOperator(volatility, op);
+
+  //	payoff on the state, cell averaged across slices
+  const int n = op.size();
+  mMatrix<double> u(a.size(), n);
+  for (int j = 0; j < a.size(); ++j) {
+    const double v = a.vanillaAverage(j, strike, isCall);
+    for (int i = 0; i < n; ++i) u(j, i) = v;
+  }
+
+  SliceSolver solver(op, settings.theta, pool);
+  solver.rollback(u, a, expiry, settings.timeSteps, settings.dampingSteps,
+                  fixings, update);
+
+  //	done
+  return SliceSolver::valueAt(a, op.x(), u, a0, forward);
+}
+
+double BlackPathFdm::asian(const mVector<double>& fixings, double strike,
+                           double forward, double volatility, bool isCall,
+                           const FdmSettings1d& settings, int stateSize,
+                           ThreadPool* pool) {
+  const double expiry = fixings[fixings.size() - 1];
+  const FdmGrid x = BlackFdm::makeGrid(expiry, forward, volatility,
+                                       mVector<double>(1, strike), settings);
+
+  //	the average lives in the range of the forward
+  const FdmGrid a = FdmGrid::concentrated(x.front(), x.back(), stateSize,
+                                          strike, settings.density);
+
+  //	running average after k + 1 fixings
+  auto update = [](int k, double avg, double f) {
+    return avg + (f - avg) / (k + 1);
+  };
+
+  //	done
+  return price(a, fixings, strike, forward, volatility, isCall, settings,
+               forward, update, pool);
+}
+
+double BlackPathFdm::lookback(const mVector<double>& fixings, double strike,
+                              double forward, double volatility, bool isCall,
+                              const FdmSettings1d& settings, int stateSize,
+                              ThreadPool* pool) {
+  const double expiry = fixings[fixings.size() - 1];
+  const FdmGrid x = BlackFdm::makeGrid(expiry, forward, volatility,
+                                       mVector<double>(1, strike), settings);
+
+  //	the maximum starts at the forward
+  const FdmGrid a = FdmGrid::concentrated(forward, x.back(), stateSize,
+                                          max(forward, strike),
+                                          settings.density);
+
+  auto update = [](int, double m, double f) { return max(m, f); };
+
+  //	done
+  return price(a, fixings, strike, forward, volatility, isCall, settings,
+               forward, update, pool);
+}
@@ -0,0 +1,167 @@
+#include "Heston.hpp"
+
+#include <algorithm>
+
+namespace {
+
+//	a / b inline, complex division otherwise goes through a library call
+//	guarding against overflow that the bounded arguments here never need
+inline complex<double> quotient(const complex<double>& a,
+                                const complex<double>& b) {
+  const double r = 1.0 / std::norm(b);
+  return complex<double>(
+      r * (a.real() * b.real() + a.imag() * b.imag()),
+      r * (a.imag() * b.real() - a.real() * b.imag()));
+}
+
+}  // namespace
+
+//	characteristic function, "little trap" form of Albrecher et al. (2007)
+complex<double> Heston::charFunc(complex<double> u, double expiry,
+                                 const HestonParams& params) {
+  const complex<double> i(0.0, 1.0);
+  const double kappa = params.kappa;
+  const double sigma = params.sigma;
+  const double sigma2 = sigma * sigma;
+
+  const complex<double> beta = kappa - params.rho * sigma * i * u;
+  const complex<double> d = std::sqrt(beta * beta + sigma2 * (i * u + u * u));
+  const complex<double> g = quotient(beta - d, beta + d);
+  const complex<double> e = std::exp(-d * expiry);
+
+  const complex<double> C =
+      kappa * params.eta / sigma2 *
+      ((beta - d) * expiry - 2.0 * std::log(quotient(1.0 - g * e, 1.0 - g)));
+  const complex<double> D =
+      quotient((beta - d) * (1.0 - e), 1.0 - g * e) / sigma2;
+
+  //	done
+  return std::exp(C + D * params.v0);
+}
+
+//	call = F - sqrt(F K) / pi int_0^inf Re[e^iuk phi(u - i/2)] / (u^2 + 1/4)
+//	with k = log(F / K), integrated by Gauss-Legendre panels until the
+//	integrand has decayed
+double Heston::call(double expiry, double strike, double forward,
+                    const HestonParams& params) {
+  if (expiry <= 0.0) return std::max(0.0, forward - strike);
+
+  const complex<double> i(0.0, 1.0);
+  const double k = std::log(forward / strike);
+
+  //	panel rule on [0, 1], rescaled per panel
+  const int points = 32;
+  mVector<double> nodes, weights;
+  SpecialFunctions::gaussLegendre(points, 0.0, 1.0, nodes, weights);
+
+  double integral = 0.0;
+  double a = 0.0;
+  double width = 2.0;
+  for (int panel = 0; panel < 200; ++panel) {
+    double sum = 0.0;
+    for (int n = 0; n < points; ++n) {
+      const double u = a + width * nodes[n];
+      const complex<double> phi = charFunc(u - 0.5 * i, expiry, params);
+      sum += weights[n] * std::real(std::exp(i * u * k) * phi) /
+             (u * u + 0.25);
+    }
+    sum *= width;
+    integral += sum;
+
+    a += width;
+    width = std::min(2.0 * width, 50.0);
+    if (fabs(sum) < Constants::dblPrecision() * fabs(integral)) break;
+  }
+
+  double res =
+      forward - std::sqrt(forward * strike) / Constants::pi() * integral;
+
+  //	done
+  return std::max(res, std::max(0.0, forward - strike));
+}
+
+void Heston::cumulants(double expiry, const HestonParams& params, double& c1,
+                       double& c2) {
+  const double k = params.kappa;
+  const double e = std::exp(-k * expiry);
+  c1 = (1.0 - e) * (params.eta - params.v0) / (2.0 * k) -
+       0.5 * params.eta * expiry;
+
+  //	log |phi(h)| = -c2 h^2 / 2 + O(h^4), the closed form of the variance
+  //	is lengthy and error prone for a value that only sizes the range
+  const double h = 1e-3;
+  c2 = -2.0 * std::log(std::abs(charFunc(h, expiry, params))) / (h * h);
+}
+
+void Heston::calls(double expiry, const mVector<double>& strikes,
+                   double forward, const HestonParams& params,
+                   mVector<double>& calls, const HestonCosSettings& settings) {
+  const int m = strikes.size();
+  calls.resize(m);
+  if (m == 0) return;
+
+  if (expiry <= 0.0) {
+    for (int j = 0; j < m; ++j) calls[j] = std::max(0.0, forward - strikes[j]);
+    return;
+  }
+
+  //	y = log(F_T / K) = log(F_T / F) + x_j on [a, b] for every strike
+  double c1, c2;
+  cumulants(expiry, params, c1, c2);
+  const double half = settings.width * std::sqrt(std::fabs(c2));
+  double xMin = HUGE_VAL, xMax = -HUGE_VAL;
+  for (int j = 0; j < m; ++j) {
+    const double x = std::log(forward / strikes[j]);
+    xMin = std::min(xMin, x);
+    xMax = std::max(xMax, x);
+  }
+  const double a = c1 + xMin - half;
+  const double b = c1 + xMax + half;
+  const double range = b - a;
+
+  //	put terms phi(w_k) V_k with V_k the coefficients of (1 - e^y)+ on
+  //	[a, min(b, 0)], the first one halved
+  const int n = settings.terms;
+  const double d = std::min(b, 0.0);
+  const double ed = std::exp(d), ea = std::exp(a);
+  mVector<double> re(n), im(n);
+  for (int k = 0; k < n; ++k) {
+    const double w = k * Constants::pi() / range;
+    const double cd = std::cos(w * (d - a)), sd = std::sin(w * (d - a));
+    const double chi = (cd * ed - ea + w * sd * ed) / (1.0 + w * w);
+    const double psi = k ? sd / w : d - a;
+    const double v = (k ? 2.0 : 1.0) / range * (psi - chi);
+
+    const complex<double> phi = charFunc(w, expiry, params);
+    re[k] = v * std::real(phi);
+    im[k] = v * std::imag(phi);
+  }
+
+  //	sum_k terms_k z_j^k by Horner, z_j = exp(i pi (x_j - a) / range)
+  mVector<double> zr(m), zi(m), sr(m, 0.0), si(m, 0.0);
+  for (int j = 0; j < m; ++j) {
+    const double theta =
+        Constants::pi() * (std::log(forward / strikes[j]) - a) / range;
+    zr[j] = std::cos(theta);
+    zi[j] = std::sin(theta);
+  }
+  const double* pr = zr.data().data();
+  const double* pi = zi.data().data();
+  double* qr = sr.data().data();
+  double* qi = si.data().data();
+  for (int k = n - 1; k >= 0; --k) {
+    const double tr = re[k], ti = im[k];
+    for (int j = 0; j < m; ++j) {
+      const double r = qr[j] * pr[j] - qi[j] * pi[j] + tr;
+      qi[j] = qr[j] * pi[j] + qi[j] * pr[j] + ti;
+      qr[j] = r;
+    }
+  }
+
+  //	calls by parity, floored at intrinsic
+  for (int j = 0; j < m; ++j) {
+    const double put = strikes[j] * sr[j];
+    calls[j] = std::max(put + forward - strikes[j],
+                        std::max(0.0, forward - strikes[j]));
+  }
+}
@@ -0,0 +1,175 @@
+#include "HestonFdm.hpp"
+
+void HestonFdm::makeGrids(const HestonFdmProduct& product,
+                          const HestonFdmSettings& settings, FdmGrid& s,
+                          FdmGrid& v) {
+  const double strike = product.strike;
+  const double sMin = product.lowerBarrier > 0.0 ? product.lowerBarrier : 0.0;
+  const double sMax =
+      product.upperBarrier > 0.0 ? product.upperBarrier : 8.0 * strike;
+  s = FdmGrid::concentrated(sMin, sMax, settings.sSize, strike,
+                            0.2 * strike / (sMax - sMin));
+
+  const double vMax = 5.0;
+  v = FdmGrid::concentrated(0.0, vMax, settings.vSize, 0.0, 1.0 / 500.0);
+}
+
+void HestonFdm::buildOperator(double rate, double dividend,
+                              const HestonParams& params,
+                              const HestonFdmProduct& product,
+                              FdmOperator2d& op) {
+  const FdmGrid& s = op.x();
+  const FdmGrid& v = op.y();
+  const int ns = s.size();
+  const int nv = v.size();
+
+  FdmCoefficients2d coeffs;
+  coeffs.resize(ns, nv);
+  for (int i = 0; i < ns; ++i) {
+    for (int j = 0; j < nv; ++j) {
+      coeffs.axx(i, j) = 0.5 * s[i] * s[i] * v[j];
+      coeffs.ayy(i, j) = 0.5 * params.sigma * params.sigma * v[j];
+      coeffs.axy(i, j) = params.rho * params.sigma * s[i] * v[j];
+      coeffs.bx(i, j) = (rate - dividend) * s[i];
+      coeffs.by(i, j) = params.kappa * (params.eta - v[j]);
+      coeffs.r(i, j) = -rate;
+    }
+  }
+
+  const FdmBoundary lower = product.lowerBarrier > 0.0 ? FdmBoundary::Dirichlet
+                                                       : FdmBoundary::Linear;
+  const FdmBoundary upper = product.upperBarrier > 0.0 ? FdmBoundary::Dirichlet
+                                                       : FdmBoundary::Linear;
+  op.setBoundaries(lower, upper, FdmBoundary::Linear, FdmBoundary::Linear);
+  op.assemble(coeffs);
+}
+
+void HestonFdm::payoff(const HestonFdmProduct& product, const FdmOperator2d& op,
+                       mMatrix<double>& u) {
+  const FdmGrid& s = op.x();
+  const int ns = s.size();
+  const int nv = op.ySize();
+  u.resize(ns, nv);
+
+  for (int i = 0; i < ns; ++i) {
+    double pay = op.compact()
+                     ? s.vanillaSmoothed(i, product.strike, product.isCall)
+                     : s.vanillaAverage(i, product.strike, product.isCall);
+
+    //	knocked out on the barriers
+    if (i == 0 && product.lowerBarrier > 0.0) pay = 0.0;
+    if (i == ns - 1 && product.upperBarrier > 0.0) pay = 0.0;
+
+    for (int j = 0; j < nv; ++j) u(i, j) = pay;
+  }
+}
+
+double HestonFdm::valueAt(const FdmOperator2d& op, const mMatrix<double>& u,
+                          double s, double v) {
+  const int ns = op.xSize();
+
+  //	along v on every row, then along s
+  mVector<double> col(ns);
+  for (int i = 0; i < ns; ++i) col[i] = op.y().interpolate(u(i), v);
+
+  //	done
+  return op.x().interpolate(col, s);
+}
+
+double HestonFdm::price(double spot, double rate, double dividend,
+                        const HestonParams& params,
+                        const HestonFdmProduct& product,
+                        const HestonFdmSettings& settings,
+                        mMatrix<double>* values) {
+  //	knocked out already
+  if ((product.lowerBarrier > 0.0 && spot <= product.lowerBarrier) ||
+      (product.upperBarrier > 0.0 && spot >= product.upperBarrier))
+    return 0.0;
+
+  FdmGrid s, v;
+  makeGrids(product, settings, s, v);
+
+  FdmOperator2d op(s, v);
+  op.setCompact(settings.compact);
+  if (settings.convection != FdmConvection::Central)
+    op.setConvection(settings.convection);
+  buildOperator(rate, dividend, params, product, op);
+
+  mMatrix<double> u;
+  payoff(product, op, u);
+
+  AdiSolver solver(op, settings.scheme, settings.theta, settings.pool);
+  solver.rollback(u, product.expiry, settings.timeSteps,
+                  settings.dampingSteps);
+
+  double res = valueAt(op, u, spot, params.v0);
+  if (values) *values = std::move(u);
+
+  //	done
+  return res;
+}
+
+double HestonFdm::sensitivities(double spot, double rate, double dividend,
+                                const HestonParams& params,
+                                const HestonFdmProduct& product,
+                                const HestonFdmSettings& settings,
+                                HestonFdmGradient& gradient,
+                                int budget) {
+  gradient = HestonFdmGradient();
+  if ((product.lowerBarrier > 0.0 && spot <= product.lowerBarrier) ||
+      (product.upperBarrier > 0.0 && spot >= product.upperBarrier))
+    return 0.0;
+
+  FdmGrid s, v;
+  makeGrids(product, settings, s, v);
+  const int ns = s.size();
+  const int nv = v.size();
+
+  FdmOperator2d op(s, v);
+  buildOperator(rate, dividend, params, product, op);
+
+  mMatrix<double> u;
+  payoff(product, op, u);
+
+  AdiAdjoint solver(op, settings.scheme, settings.theta, budget);
+  solver.rollback(u, product.expiry, settings.timeSteps,
+                  settings.dampingSteps);
+
+  //	valueAt() is the tensor of the lagrange weights, they seed lambda
+  double ws[4], ds[4], d2s[4], wv[4], dv[4], d2v[4];
+  int os, ov;
+  const int is = s.lagrangeWeights(spot, ws, ds, d2s, os);
+  const int iv = v.lagrangeWeights(params.v0, wv, dv, d2v, ov);
+  mMatrix<double> lambda(ns, nv, 0.0);
+  double price = 0.0;
+  for (int a = 0; a < os; ++a) {
+    for (int b = 0; b < ov; ++b) {
+      const double x = u(is + a, iv + b);
+      lambda(is + a, iv + b) = ws[a] * wv[b];
+      price += ws[a] * wv[b] * x;
+      gradient.spot += ds[a] * wv[b] * x;
+      gradient.v0 += ws[a] * dv[b] * x;
+    }
+  }
+
+  FdmCoefficients2d& c = gradient.coefficients;
+  c.resize(ns, nv);
+  solver.adjoint(lambda, c);
+  gradient.checkpoints = solver.schedule().stats();
+
+  //	chain rule through buildOperator()
+  for (int i = 0; i < ns; ++i) {
+    for (int j = 0; j < nv; ++j) {
+      gradient.sigma += c.ayy(i, j) * params.sigma * v[j] +
+                        c.axy(i, j) * params.rho * s[i] * v[j];
+      gradient.rho += c.axy(i, j) * params.sigma * s[i] * v[j];
+      gradient.rate += c.bx(i, j) * s[i] - c.r(i, j);
+      gradient.dividend -= c.bx(i, j) * s[i];
+      gradient.kappa += c.by(i, j) * (params.eta - v[j]);
+      gradient.eta += c.by(i, j) * params.kappa;
+    }
+  }
+
+  //	done
+  return price;
+}
@@ -0,0 +1,137 @@
+#include "HestonHullWhiteFdm.hpp"
+
+#include <cmath>
+
+void HestonHullWhiteFdm::makeGrids(const HestonFdmProduct& product,
+                                   const HullWhiteParams& rates,
+                                   const HestonHullWhiteFdmSettings& settings,
+                                   FdmGrid& s, FdmGrid& v, FdmGrid& r) {
+  HestonFdmSettings hs;
+  hs.sSize = settings.sSize;
+  hs.vSize = settings.vSize;
+  HestonFdm::makeGrids(product, hs, s, v);
+
+  //	standard deviation of the rate at expiry
+  const double t = product.expiry;
+  const double a = rates.a;
+  const double variance =
+      a > 1.0e-8 ? (1.0 - std::exp(-2.0 * a * t)) / (2.0 * a) : t;
+  const double width = 5.0 * max(rates.sigma * std::sqrt(variance), 1.0e-4);
+  r = FdmGrid::uniform(min(rates.r0, rates.b) - width,
+                       max(rates.r0, rates.b) + width, settings.rSize);
+}
+
+void HestonHullWhiteFdm::buildOperator(double dividend,
+                                       const HestonParams& params,
+                                       const HullWhiteParams& rates,
+                                       double rhoSr, double rhoVr,
+                                       const HestonFdmProduct& product,
+                                       FdmOperator3d& op) {
+  const FdmGrid& s = op.x();
+  const FdmGrid& v = op.y();
+  const FdmGrid& r = op.z();
+  const int ns = s.size();
+  const int nv = v.size();
+  const int nr = r.size();
+
+  mVector<double> s2(ns), sv(ns), srv(ns), qs(ns);
+  for (int i = 0; i < ns; ++i) {
+    s2[i] = 0.5 * s[i] * s[i];
+    sv[i] = params.rho * params.sigma * s[i];
+    srv[i] = rhoSr * rates.sigma * s[i];
+    qs[i] = -dividend * s[i];
+  }
+  mVector<double> vs(nv), vv(nv), sqv(nv), vr(nv), kv(nv);
+  for (int j = 0; j < nv; ++j) {
+    vs[j] = v[j];
+    vv[j] = 0.5 * params.sigma * params.sigma * v[j];
+    sqv[j] = std::sqrt(max(v[j], 0.0));
+    vr[j] = rhoVr * params.sigma * rates.sigma * sqv[j];
+    kv[j] = params.kappa * (params.eta - v[j]);
+  }
+  mVector<double> rr(nr), hw(nr), disc(nr);
+  mVector<double> rs(nr, 0.5 * rates.sigma * rates.sigma);
+  for (int k = 0; k < nr; ++k) {
+    rr[k] = r[k];
+    hw[k] = rates.a * (rates.b - r[k]);
+    disc[k] = -r[k];
+  }
+
+  const mVector<double> one;
+  FdmCoefficients3d coeffs;
+  coeffs.axx.add(s2, vs, one);
+  coeffs.ayy.add(one, vv, one);
+  coeffs.azz.add(one, one, rs);
+  coeffs.axy.add(sv, vs, one);
+  coeffs.axz.add(srv, sqv, one);
+  coeffs.ayz.add(one, vr, one);
+  coeffs.bx.add(s.points(), one, rr);
+  coeffs.bx.add(qs, one, one);
+  coeffs.by.add(one, kv, one);
+  coeffs.bz.add(one, one, hw);
+  coeffs.r.add(one, one, disc);
+
+  const FdmBoundary lower = product.lowerBarrier > 0.0 ? FdmBoundary::Dirichlet
+                                                       : FdmBoundary::Linear;
+  const FdmBoundary upper = product.upperBarrier > 0.0 ? FdmBoundary::Dirichlet
+                                                       : FdmBoundary::Linear;
+  op.setBoundaries(lower, upper, FdmBoundary::Linear, FdmBoundary::Linear,
+                   FdmBoundary::Linear, FdmBoundary::Linear);
+  op.assemble(coeffs);
+}
+
+double HestonHullWhiteFdm::valueAt(const FdmOperator3d& op,
+                                   const mCube<double>& u, double s, double v,
+                                   double r) {
+  const int ns = op.xSize();
+  const int nv = op.ySize();
+
+  //	along r on every line, then as HestonFdm
+  mVector<double> col(ns), row(nv);
+  for (int i = 0; i < ns; ++i) {
+    for (int j = 0; j < nv; ++j) row[j] = op.z().interpolate(u(i, j), r);
+    col[i] = op.y().interpolate(row, v);
+  }
+
+  //	done
+  return op.x().interpolate(col, s);
+}
+
+double HestonHullWhiteFdm::price(double spot, double dividend,
+                                 const HestonParams& params,
+                                 const HullWhiteParams& rates, double rhoSr,
+                                 double rhoVr, const HestonFdmProduct& product,
+                                 const HestonHullWhiteFdmSettings& settings,
+                                 Profiler* profiler) {
+  //	knocked out already
+  if ((product.lowerBarrier > 0.0 && spot <= product.lowerBarrier) ||
+      (product.upperBarrier > 0.0 && spot >= product.upperBarrier))
+    return 0.0;
+
+  FdmGrid s, v, r;
+  makeGrids(product, rates, settings, s, v, r);
+
+  FdmOperator3d op(s, v, r);
+  buildOperator(dividend, params, rates, rhoSr, rhoVr, product, op);
+
+  //	cell averaged payoff, the same on every v and r node
+  const int ns = s.size();
+  mCube<double> u(ns, v.size(), r.size());
+  for (int i = 0; i < ns; ++i) {
+    double pay = s.vanillaAverage(i, product.strike, product.isCall);
+    if (i == 0 && product.lowerBarrier > 0.0) pay = 0.0;
+    if (i == ns - 1 && product.upperBarrier > 0.0) pay = 0.0;
+    for (int j = 0; j < v.size(); ++j)
+      for (int k = 0; k < r.size(); ++k) u(i, j, k) = pay;
+  }
+
+  AdiSolver3d solver(op, settings.scheme, settings.theta, settings.pool);
+  {
+    ProfilerScope scope(profiler, "rollback");
+    solver.rollback(u, product.expiry, settings.timeSteps,
+                    settings.dampingSteps);
+  }
+
+  //	done
+  return valueAt(op, u, spot, params.v0, rates.r0);
+}
@@ -0,0 +1,239 @@
+#include "LocalVolFdm.hpp"
+
+#include "BlackFdm.hpp"
+
+FdmGrid LocalVolFdm::makeGrid(double expiry, double forward,
+                              const LocalVolSurface& surface,
+                              const mVector<double>& strikes,
+                              const FdmSettings1d& settings) {
+  return BlackFdm::makeGrid(expiry, forward,
+                            surface.volatility(expiry, forward), strikes,
+                            settings);
+}
+
+void LocalVolFdm::buildOperator(FdmOperator1d& op) {
+  const FdmGrid& x = op.x();
+  const int n = x.size();
+
+  FdmCoefficients1d coeffs;
+  coeffs.resize(n);
+  for (int i = 0; i < n; ++i) coeffs.a[i] = 0.5 * x[i] * x[i];
+
+  op.assemble(coeffs);
+}
+
+void LocalVolFdm::refresh(const LocalVolSurface& surface, double t,
+                          mVector<double>& vols, FdmOperator1d& op) {
+  surface.volatilities(t, vols);
+  for (int i = 0; i < vols.size(); ++i) vols[i] *= vols[i];
+  op.scaleDiffusion(vols);
+}
+
+void LocalVolFdm::prices(double expiry, const mVector<double>& strikes,
+                         double forward, const LocalVolSurface& surface,
+                         bool isCall, const FdmSettings1d& settings,
+                         mVector<double>& prices, Profiler* profiler) {
+  const int m = strikes.size();
+  prices.resize(m);
+  if (m == 0) return;
+
+  if (expiry <= 0.0) {
+    for (int k = 0; k < m; ++k)
+      prices[k] = isCall ? max(0.0, forward - strikes[k])
+                         : max(0.0, strikes[k] - forward);
+    return;
+  }
+
+  FdmOperator1d op(makeGrid(expiry, forward, surface, strikes, settings));
+  op.setCompact(settings.compact);
+  buildOperator(op);
+
+  //	grid nodes fixed once for the whole solve
+  const FdmGrid& x = op.x();
+  LocalVolSurface lv = surface;
+  lv.setPoints(x.points());
+
+  const int n = x.size();
+  mMatrix<double> u(n, m);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < m; ++k)
+      u(i, k) = settings.compact
+                    ? x.vanillaSmoothed(i, strikes[k], isCall)
+                    : x.vanillaAverage(i, strikes[k], isCall);
+
+  //	the calendar time grid of callSurface(), from expiry back to 0 with
+  //	the surface sampled at the middle of every step, the damping half
+  //	steps are the last ones
+  const FdmTimeGrid times =
+      FdmTimeGrid::make(mVector<double>(1, expiry), settings.timeSteps,
+                        settings.theta, settings.dampingSteps);
+  ThetaSolver solver(op, settings.theta);
+  mVector<double> vols;
+  for (int k = times.steps() - 1; k >= 0; --k) {
+    {
+      ProfilerScope scope(profiler, "assembly");
+      refresh(lv, times.time(k) + 0.5 * times.dt(k), vols, op);
+    }
+    ProfilerScope scope(profiler, "solve");
+    solver.step(u, times.dt(k), times.theta(k));
+  }
+
+  x.interpolate(u, forward, prices);
+}
+
+void LocalVolFdm::callSurface(const mVector<double>& maturities,
+                              const mVector<double>& strikes, double forward,
+                              const LocalVolSurface& surface,
+                              const FdmSettings1d& settings,
+                              mMatrix<double>& calls, Profiler* profiler) {
+  const int m = maturities.size();
+  calls.resize(m, strikes.size());
+
+  double expiry = 0.0;
+  for (int l = 0; l < m; ++l) expiry = max(expiry, maturities[l]);
+
+  FdmOperator1d op(makeGrid(expiry, forward, surface, strikes, settings));
+  buildOperator(op);
+
+  const FdmGrid& x = op.x();
+  LocalVolSurface lv = surface;
+  lv.setPoints(x.points());
+
+  const FdmTimeGrid times = FdmTimeGrid::make(
+      maturities, settings.timeSteps, settings.theta, settings.dampingSteps);
+
+  vector<int> nodes(m);
+  for (int l = 0; l < m; ++l) nodes[l] = times.index(maturities[l]);
+
+  FokkerPlanckSolver solver(op);
+  mVector<double> p, row, vols;
+  FokkerPlanckSolver::dirac(x, forward, p);
+
+  auto record = [&](int node) {
+    for (int l = 0; l < m; ++l) {
+      if (nodes[l] != node) continue;
+      FokkerPlanckSolver::calls(x, p, strikes, row);
+      for (int k = 0; k < row.size(); ++k) calls(l, k) = row[k];
+    }
+  };
+
+  record(0);
+  for (int k = 0; k < times.steps(); ++k) {
+    {
+      ProfilerScope scope(profiler, "assembly");
+      refresh(lv, times.time(k) + 0.5 * times.dt(k), vols, op);
+    }
+    {
+      ProfilerScope scope(profiler, "solve");
+      solver.step(p, times.dt(k), times.theta(k));
+    }
+    record(k + 1);
+  }
+}
+
+namespace {
+
+//	linear weights of r(t) on the rate nodes j and j + 1, flat outside
+int rateWeights(const mVector<double>& times, double t, double& w) {
+  const int n = times.size();
+  w = 1.0;
+  if (n < 2 || t <= times[0]) return 0;
+  if (t >= times[n - 1]) {
+    w = 0.0;
+    return n - 2;
+  }
+
+  int j = 0;
+  while (j < n - 2 && times[j + 1] <= t) ++j;
+  w = (times[j + 1] - t) / (times[j + 1] - times[j]);
+  return j;
+}
+
+}  // namespace
+
+double LocalVolFdm::sensitivities(
+    double expiry, double strike, double forward,
+    const LocalVolSurface& surface, const mVector<double>& rateTimes,
+    const mVector<double>& rates, bool isCall, const FdmSettings1d& settings,
+    mMatrix<double>& volGradient, mVector<double>& rateGradient,
+    int budget, RevolveStats* checkpoints) {
+  const int nr = rates.size();
+  rateGradient.resize(nr);
+  for (int j = 0; j < nr; ++j) rateGradient[j] = 0.0;
+
+  FdmOperator1d op(makeGrid(expiry, forward, surface,
+                            mVector<double>(1, strike), settings));
+  buildOperator(op);
+
+  const FdmGrid& x = op.x();
+  const int n = x.size();
+  LocalVolSurface lv = surface;
+  lv.setPoints(x.points());
+
+  //	same steps as prices(), backward from expiry, every step at its middle
+  const FdmTimeGrid times =
+      FdmTimeGrid::make(mVector<double>(1, expiry), settings.timeSteps,
+                        settings.theta, settings.dampingSteps);
+  const int count = times.steps();
+  mVector<double> dts(count), thetas(count), mids(count);
+  for (int k = 0; k < count; ++k) {
+    const int l = count - 1 - k;
+    dts[k] = times.dt(l);
+    thetas[k] = times.theta(l);
+    mids[k] = times.time(l) + 0.5 * dts[k];
+  }
+
+  mVector<double> vols;
+  auto rate = [&](double s) {
+    if (nr == 0) return 0.0;
+    double w;
+    const int j = rateWeights(rateTimes, s, w);
+    return nr == 1 ? rates[0] : w * rates[j] + (1.0 - w) * rates[j + 1];
+  };
+  auto refresh = [&](int k) {
+    lv.volatilities(mids[k], vols);
+    for (int i = 0; i < n; ++i) vols[i] *= vols[i];
+    op.scaleDiffusion(vols, rate(mids[k]));
+  };
+
+  ThetaAdjoint solver(op, dts, thetas, refresh, budget);
+  mVector<double> u(n);
+  for (int i = 0; i < n; ++i) u[i] = x.vanillaAverage(i, strike, isCall);
+  solver.rollback(u);
+
+  //	the price is the interpolant at the forward, its weights seed lambda
+  double weights[4];
+  int order;
+  const int i0 = x.lagrangeWeights(forward, weights, order);
+  mVector<double> lambda(n, 0.0);
+  double price = 0.0;
+  for (int l = 0; l < order; ++l) {
+    lambda[i0 + l] = weights[l];
+    price += weights[l] * u[i0 + l];
+  }
+
+  //	s = sigma^2 on the nodes, sigmaBar = 2 sigma sBar
+  mVector<double> sigmaBar(n);
+  auto gradient = [&](int k, const mVector<double>& scaleBar,
+                      double discountBar) {
+    lv.volatilities(mids[k], vols);
+    for (int i = 0; i < n; ++i) sigmaBar[i] = 2.0 * vols[i] * scaleBar[i];
+    lv.volatilitiesAdjoint(mids[k], sigmaBar);
+
+    if (nr == 0) return;
+    if (nr == 1) {
+      rateGradient[0] += discountBar;
+      return;
+    }
+    double w;
+    const int j = rateWeights(rateTimes, mids[k], w);
+    rateGradient[j] += w * discountBar;
+    rateGradient[j + 1] += (1.0 - w) * discountBar;
+  };
+  solver.adjoint(lambda, gradient);
+  lv.gradient(volGradient);
+  if (checkpoints) *checkpoints = solver.schedule().stats();
+
+  //	done
+  return price;
+}
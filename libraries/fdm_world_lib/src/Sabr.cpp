@@ -0,0 +1,186 @@
+#include "Sabr.hpp"
+
+#include "Bachelier.hpp"
+#include "Black.hpp"
+
+double Sabr::zOverX(double z, double rho) {
+  if (std::fabs(z) < 1.0e-8) return 1.0 - 0.5 * rho * z;
+
+  const double d = std::sqrt(1.0 - 2.0 * rho * z + z * z);
+  const double x = std::log((d + z - rho) / (1.0 - rho));
+
+  //	done
+  return z / x;
+}
+
+double Sabr::blackVol(double expiry, double strike, double forward,
+                      const SabrParams& params) {
+  const double alpha = params.alpha, beta = params.beta;
+  const double rho = params.rho, nu = params.nu;
+  const double f = forward + params.shift;
+  const double k = strike + params.shift;
+
+  const double b = 1.0 - beta;
+  const double logFK = std::log(f / k);
+  const double fkb = std::pow(f * k, 0.5 * b);
+
+  const double denom = fkb * (1.0 + b * b / 24.0 * logFK * logFK +
+                              b * b * b * b / 1920.0 * logFK * logFK * logFK *
+                                  logFK);
+  const double z = nu / alpha * fkb * logFK;
+  const double corr =
+      1.0 + (b * b / 24.0 * alpha * alpha / (fkb * fkb) +
+             0.25 * rho * beta * nu * alpha / fkb +
+             (2.0 - 3.0 * rho * rho) / 24.0 * nu * nu) *
+                expiry;
+
+  //	done
+  return alpha / denom * zOverX(z, rho) * corr;
+}
+
+double Sabr::normalVol(double expiry, double strike, double forward,
+                       const SabrParams& params) {
+  const double alpha = params.alpha, beta = params.beta;
+  const double rho = params.rho, nu = params.nu;
+  const double f = forward + params.shift;
+  const double k = strike + params.shift;
+
+  //	C at the geometric mean, the arithmetic one when beta = 0 allows
+  //	negative rates
+  const double b = 1.0 - beta;
+  const double mid = beta > 0.0 ? std::sqrt(f * k) : 0.5 * (f + k);
+  const double cMid = beta > 0.0 ? std::pow(mid, beta) : 1.0;
+
+  //	alpha (f - k) / int_k^f du / C(u)
+  double scale = alpha * cMid;
+  if (beta > 0.0 && std::fabs(f - k) > 1.0e-12 * mid) {
+    const double integral = beta == 1.0
+                                ? std::log(f / k)
+                                : (std::pow(f, b) - std::pow(k, b)) / b;
+    scale = alpha * (f - k) / integral;
+  }
+
+  const double z = nu / alpha * (f - k) / cMid;
+  double corr = (2.0 - 3.0 * rho * rho) / 24.0 * nu * nu;
+  if (beta > 0.0) {
+    const double a = alpha * cMid / mid;
+    corr += -beta * (2.0 - beta) / 24.0 * a * a + 0.25 * rho * nu * beta * a;
+  }
+  corr = 1.0 + corr * expiry;
+
+  //	done
+  return scale * zOverX(z, rho) * corr;
+}
+
+double Sabr::call(double expiry, double strike, double forward,
+                  const SabrParams& params) {
+  if (params.beta == 0.0)
+    return Bachelier::call(expiry, strike, forward,
+                           normalVol(expiry, strike, forward, params));
+
+  //	done
+  return Black::call(expiry, strike + params.shift, forward + params.shift,
+                     blackVol(expiry, strike, forward, params));
+}
+
+void Sabr::vols(double expiry, const mVector<double>& strikes, double forward,
+                const SabrParams& params, mVector<double>& res) {
+  const int n = strikes.size();
+  res.resize(n);
+  if (params.beta == 0.0)
+    for (int j = 0; j < n; ++j)
+      res[j] = normalVol(expiry, strikes[j], forward, params);
+  else
+    for (int j = 0; j < n; ++j)
+      res[j] = blackVol(expiry, strikes[j], forward, params);
+}
+
+void Sabr::calls(double expiry, const mVector<double>& strikes,
+                 double forward, const SabrParams& params,
+                 mVector<double>& res) {
+  mVector<double> v;
+  vols(expiry, strikes, forward, params, v);
+  if (params.beta == 0.0) {
+    Bachelier::calls(expiry, strikes, forward, v, res);
+    return;
+  }
+
+  mVector<double> shifted(strikes.size());
+  for (int j = 0; j < strikes.size(); ++j)
+    shifted[j] = strikes[j] + params.shift;
+  Black::calls(expiry, shifted, forward + params.shift, v, res);
+}
+
+namespace {
+
+//	volatility errors, parameters (alpha, rho, nu)
+class SabrObj : public LeastSquaresObjective {
+ public:
+  SabrObj(double expiry, const mVector<double>& strikes, double forward,
+          const mVector<double>& vols, const SabrParams& params)
+      : myExpiry(expiry),
+        myStrikes(strikes),
+        myForward(forward),
+        myVols(vols),
+        myParams(params) {}
+
+  SabrParams params(const mVector<double>& x) const {
+    SabrParams res = myParams;
+    res.alpha = x[0];
+    res.rho = x[1];
+    res.nu = x[2];
+    return res;
+  }
+
+  void values(const mVector<double>& x, mVector<double>& res) override {
+    Sabr::vols(myExpiry, myStrikes, myForward, params(x), res);
+    for (int j = 0; j < res.size(); ++j) res[j] -= myVols[j];
+  }
+
+ private:
+  double myExpiry;
+  const mVector<double>& myStrikes;
+  double myForward;
+  const mVector<double>& myVols;
+  SabrParams myParams;
+};
+
+}  // namespace
+
+bool Sabr::fit(double expiry, const mVector<double>& strikes, double forward,
+               const mVector<double>& vols, SabrParams& params,
+               const LevenbergMarquardtSettings& settings,
+               LevenbergMarquardtReport* report) {
+  const int n = strikes.size();
+  if (n < 3 || vols.size() != n || expiry <= 0.0) return false;
+
+  //	volatilities are about linear in alpha
+  int atm = 0;
+  for (int j = 1; j < n; ++j)
+    if (std::fabs(strikes[j] - forward) < std::fabs(strikes[atm] - forward))
+      atm = j;
+  mVector<double> v;
+  Sabr::vols(expiry, mVector<double>(1, strikes[atm]), forward, params, v);
+  if (v[0] > 0.0 && std::isfinite(v[0])) params.alpha *= vols[atm] / v[0];
+
+  SabrObj obj(expiry, strikes, forward, vols, params);
+  LevenbergMarquardtSettings s = settings;
+  s.lower.resize(3);
+  s.upper.resize(3);
+  s.lower[0] = 1e-8;
+  s.upper[0] = 1e8;
+  s.lower[1] = -0.999;
+  s.upper[1] = 0.999;
+  s.lower[2] = 1e-6;
+  s.upper[2] = 10.0;
+
+  mVector<double> x(3);
+  x[0] = params.alpha;
+  x[1] = params.rho;
+  x[2] = params.nu;
+  const bool res = Solver::levenbergMarquardt(obj, x, s, report);
+  params = obj.params(x);
+
+  //	done
+  return res;
+}
@@ -0,0 +1,177 @@
+#include "SabrFdm.hpp"
+
+#include <cmath>
+
+namespace {
+
+//	y(F) and its inverse, C(F)
+struct SabrMap {
+  SabrMap(double forward, const SabrParams& params)
+      : p(params),
+        f(forward),
+        fs(forward + params.shift),
+        b(1.0 - params.beta) {}
+
+  double c(double x) const {
+    return p.beta == 0.0 ? 1.0 : std::pow(max(x + p.shift, 0.0), p.beta);
+  }
+
+  double y(double x) const {
+    if (p.beta == 0.0) return x - f;
+    if (p.beta == 1.0) return std::log((x + p.shift) / fs);
+    return (std::pow(max(x + p.shift, 0.0), b) - std::pow(fs, b)) / b;
+  }
+
+  double x(double y) const {
+    if (p.beta == 0.0) return f + y;
+    if (p.beta == 1.0) return fs * std::exp(y) - p.shift;
+    return std::pow(max(std::pow(fs, b) + b * y, 0.0), 1.0 / b) - p.shift;
+  }
+
+  //	z(y) = int_0^y du / sqrt(alpha^2 + 2 rho alpha nu u + nu^2 u^2)
+  double z(double y) const {
+    if (p.nu < 1.0e-12) return y / p.alpha;
+    const double d = std::sqrt(p.alpha * p.alpha +
+                               2.0 * p.rho * p.alpha * p.nu * y +
+                               p.nu * p.nu * y * y);
+    return std::log((d + p.rho * p.alpha + p.nu * y) /
+                    ((1.0 + p.rho) * p.alpha)) /
+           p.nu;
+  }
+
+  double yOfZ(double z) const {
+    if (p.nu < 1.0e-12) return p.alpha * z;
+    return p.alpha / p.nu *
+           (std::sinh(p.nu * z) + p.rho * (std::cosh(p.nu * z) - 1.0));
+  }
+
+  const SabrParams& p;
+  double f, fs, b;
+};
+
+}  // namespace
+
+FdmGrid SabrFdm::makeGrid(double expiry, double forward,
+                          const SabrParams& params,
+                          const FdmSettings1d& settings) {
+  const SabrMap map(forward, params);
+  const int n = settings.xSize;
+
+  //	absorbing barrier at C(F) = 0 when it is reached in finite z
+  double zMax = settings.stdDevs * std::sqrt(expiry);
+  double zMin = -zMax;
+  bool barrier = false;
+  if (params.beta > 0.0 && params.beta < 1.0) {
+    const double zBarrier = map.z(map.y(-params.shift));
+    if (zBarrier > zMin) {
+      zMin = zBarrier;
+      barrier = true;
+    }
+  }
+
+  //	forward on node k0
+  const int k0 = max(
+      1, min(n - 2, (int)std::lround(-zMin / (zMax - zMin) * (n - 1))));
+  const double h = -zMin / k0;
+
+  mVector<double> points(n, 0.0);
+  for (int i = 0; i < n; ++i) points[i] = map.x(map.yOfZ(zMin + i * h));
+  points[k0] = forward;
+  if (barrier) points[0] = -params.shift;
+
+  //	done
+  return FdmGrid(points);
+}
+
+void SabrFdm::density(double expiry, double forward, const SabrParams& params,
+                      const FdmSettings1d& settings, FdmGrid& x,
+                      mVector<double>& p) {
+  x = makeGrid(expiry, forward, params, settings);
+  FokkerPlanckSolver::dirac(x, forward, p);
+  if (expiry <= 0.0) return;
+
+  const SabrMap map(forward, params);
+  const int n = x.size();
+
+  //	1/2 D^2 and the exponent rate of E on the nodes
+  FdmOperator1d op(x);
+  FdmCoefficients1d coeffs;
+  coeffs.resize(n);
+  mVector<double> rate(n, 0.0);
+  const double cf = map.c(forward);
+  const double slope =
+      params.beta > 0.0 ? params.beta * cf / (forward + params.shift) : 0.0;
+  bool constant = true;
+  for (int i = 0; i < n; ++i) {
+    const double y = map.y(x[i]);
+    const double c = map.c(x[i]);
+    const double d2 = params.alpha * params.alpha +
+                      2.0 * params.rho * params.alpha * params.nu * y +
+                      params.nu * params.nu * y * y;
+    coeffs.a[i] = 0.5 * d2 * c * c;
+
+    const double g =
+        std::fabs(x[i] - forward) > 1.0e-12 * (1.0 + std::fabs(forward))
+            ? (c - cf) / (x[i] - forward)
+            : slope;
+    rate[i] = params.rho * params.nu * params.alpha * g;
+    if (rate[i] != 0.0) constant = false;
+  }
+  op.assemble(coeffs);
+
+  const FdmTimeGrid times =
+      FdmTimeGrid::make(mVector<double>(1, expiry), settings.timeSteps,
+                        settings.theta, settings.dampingSteps);
+
+  //	E is sampled at the middle of every step, the normal variant keeps
+  //	one operator and reuses its factors
+  FokkerPlanckSolver solver(op);
+  mVector<double> scale(n, 1.0);
+  for (int k = 0; k < times.steps(); ++k) {
+    if (!constant) {
+      const double t = times.time(k) + 0.5 * times.dt(k);
+      for (int i = 0; i < n; ++i) scale[i] = std::exp(rate[i] * t);
+      op.scaleDiffusion(scale);
+    }
+    solver.step(p, times.dt(k), times.theta(k));
+  }
+}
+
+void SabrFdm::prices(double expiry, const mVector<double>& strikes,
+                     double forward, const SabrParams& params, bool isCall,
+                     const FdmSettings1d& settings, mVector<double>& prices) {
+  FdmGrid x;
+  mVector<double> p;
+  density(expiry, forward, params, settings, x, p);
+
+  //	suffix sums of p and p F
+  const int n = x.size();
+  mVector<double> s0(n + 1, 0.0), s1(n + 1, 0.0);
+  for (int i = n - 1; i >= 0; --i) {
+    s0[i] = s0[i + 1] + p[i];
+    s1[i] = s1[i + 1] + p[i] * x[i];
+  }
+
+  //	sum_i p_i (F_i - K)^+ over the nodes above the strike, puts by parity
+  //	which holds exactly as mass and mean are preserved
+  const int m = strikes.size();
+  prices.resize(m);
+  for (int k = 0; k < m; ++k) {
+    const double strike = strikes[k];
+    const int i = strike < x.front() ? 0
+                  : strike >= x.back()
+                      ? n
+                      : x.locate(strike) + 1;
+    const double call = s1[i] - strike * s0[i];
+    prices[k] = isCall ? call : call - (s1[0] - strike * s0[0]);
+  }
+}
+
+double SabrFdm::call(double expiry, double strike, double forward,
+                     const SabrParams& params, const FdmSettings1d& settings) {
+  mVector<double> strikes(1, strike), res;
+  prices(expiry, strikes, forward, params, true, settings, res);
+
+  //	done
+  return res[0];
+}
@@ -0,0 +1,258 @@
+#include "Svi.hpp"
+
+#include <cmath>
+
+namespace {
+
+//	weight of the arbitrage penalties against volatility errors
+const double penalty = 10.0;
+
+//	raw slice residuals, parameters (a, b, rho, m, sigma)
+class SviObj : public LeastSquaresObjective {
+ public:
+  SviObj(double expiry, const mVector<double>& strikes, double forward,
+         const mVector<double>& vols)
+      : myK(strikes.size()), myW(vols.size()), myScale(vols.size()) {
+    for (int j = 0; j < strikes.size(); ++j) {
+      myK[j] = std::log(strikes[j] / forward);
+      myW[j] = vols[j] * vols[j] * expiry;
+      myScale[j] = 1.0 / (2.0 * max(vols[j], 1e-4) * expiry);
+    }
+  }
+
+  static SviParams params(const mVector<double>& x) {
+    return SviParams{x[0], x[1], x[2], x[3], x[4]};
+  }
+
+  //	quotes, then w >= 0 and Lee's bound
+  void values(const mVector<double>& x, mVector<double>& res) override {
+    const SviParams p = params(x);
+    const int n = myK.size();
+    res.resize(n + 2);
+    for (int j = 0; j < n; ++j)
+      res[j] = (Svi::variance(myK[j], p) - myW[j]) * myScale[j];
+    res[n] = penalty * max(0.0, -minimum(p));
+    res[n + 1] = penalty * max(0.0, lee(p));
+  }
+
+  bool jacobian(const mVector<double>& x, mMatrix<double>& res) override {
+    const SviParams p = params(x);
+    const int n = myK.size();
+    res.resize(n + 2, 5);
+    res = 0.0;
+    for (int j = 0; j < n; ++j) {
+      const double d = myK[j] - p.m;
+      const double s = std::sqrt(d * d + p.sigma * p.sigma);
+      double* r = &res(j, 0);
+      r[0] = myScale[j];
+      r[1] = (p.rho * d + s) * myScale[j];
+      r[2] = p.b * d * myScale[j];
+      r[3] = -p.b * (p.rho + d / s) * myScale[j];
+      r[4] = p.b * p.sigma / s * myScale[j];
+    }
+
+    const double q = std::sqrt(1.0 - p.rho * p.rho);
+    if (minimum(p) < 0.0) {
+      double* r = &res(n, 0);
+      r[0] = -penalty;
+      r[1] = -penalty * p.sigma * q;
+      r[2] = penalty * p.b * p.sigma * p.rho / q;
+      r[4] = -penalty * p.b * q;
+    }
+    if (lee(p) > 0.0) {
+      double* r = &res(n + 1, 0);
+      r[1] = penalty * (1.0 + std::fabs(p.rho));
+      r[2] = penalty * p.b * (p.rho < 0.0 ? -1.0 : 1.0);
+    }
+
+    //	done
+    return true;
+  }
+
+ private:
+  //	min_k w(k) and b (1 + |rho|) - 2, Lee's bound on total variance
+  static double minimum(const SviParams& p) {
+    return p.a + p.b * p.sigma * std::sqrt(1.0 - p.rho * p.rho);
+  }
+  static double lee(const SviParams& p) {
+    return p.b * (1.0 + std::fabs(p.rho)) - 2.0;
+  }
+
+  mVector<double> myK, myW, myScale;
+};
+
+//	ssvi surface residuals, parameters (theta_1 .. theta_n, rho, eta, gamma)
+class SsviObj : public LeastSquaresObjective {
+ public:
+  SsviObj(const mVector<double>& expiries, const mVector<double>& forwards,
+          const mMatrix<double>& strikes, const mMatrix<double>& vols)
+      : myK(strikes.rows(), strikes.cols()),
+        myW(vols.rows(), vols.cols()),
+        myScale(vols.rows(), vols.cols()) {
+    for (int i = 0; i < vols.rows(); ++i)
+      for (int j = 0; j < vols.cols(); ++j) {
+        const double t = expiries[i], v = vols(i, j);
+        myK(i, j) = std::log(strikes(i, j) / forwards[i]);
+        myW(i, j) = v * v * t;
+        myScale(i, j) = 1.0 / (2.0 * max(v, 1e-4) * t);
+      }
+  }
+
+  //	quotes, then eta (1 + |rho|) <= 2 and increasing thetas
+  void values(const mVector<double>& x, mVector<double>& res) override {
+    const int n = myW.rows(), m = myW.cols();
+    const SsviParams p{x[n], x[n + 1], x[n + 2]};
+    res.resize(n * m + n);
+    for (int i = 0; i < n; ++i)
+      for (int j = 0; j < m; ++j)
+        res[i * m + j] =
+            (Svi::variance(myK(i, j), x[i], p) - myW(i, j)) * myScale(i, j);
+    res[n * m] = penalty * max(0.0, p.eta * (1.0 + std::fabs(p.rho)) - 2.0);
+    for (int i = 1; i < n; ++i)
+      res[n * m + i] = penalty * max(0.0, x[i - 1] - x[i]);
+  }
+
+ private:
+  mMatrix<double> myK, myW, myScale;
+};
+
+}  // namespace
+
+double Svi::variance(double k, const SviParams& params) {
+  const double d = k - params.m;
+
+  //	done
+  return params.a +
+         params.b * (params.rho * d +
+                     std::sqrt(d * d + params.sigma * params.sigma));
+}
+
+double Svi::variance(double k, double theta, const SsviParams& params) {
+  const double rho = params.rho;
+  const double phi = params.eta / (std::pow(theta, params.gamma) *
+                                   std::pow(1.0 + theta, 1.0 - params.gamma));
+  const double pk = phi * k;
+  const double q = pk + rho;
+
+  //	done
+  return 0.5 * theta * (1.0 + rho * pk + std::sqrt(q * q + 1.0 - rho * rho));
+}
+
+void Svi::vols(double expiry, const mVector<double>& strikes, double forward,
+               const SviParams& params, mVector<double>& res) {
+  const int n = strikes.size();
+  res.resize(n);
+  const double d = 1.0 / expiry;
+  for (int j = 0; j < n; ++j)
+    res[j] = std::sqrt(
+        max(0.0, variance(std::log(strikes[j] / forward), params) * d));
+}
+
+void Svi::vols(double expiry, double theta, const mVector<double>& strikes,
+               double forward, const SsviParams& params,
+               mVector<double>& res) {
+  const int n = strikes.size();
+  res.resize(n);
+  const double d = 1.0 / expiry;
+  for (int j = 0; j < n; ++j)
+    res[j] = std::sqrt(
+        max(0.0, variance(std::log(strikes[j] / forward), theta, params) * d));
+}
+
+bool Svi::fit(double expiry, const mVector<double>& strikes, double forward,
+              const mVector<double>& vols, SviParams& params,
+              const LevenbergMarquardtSettings& settings,
+              LevenbergMarquardtReport* report) {
+  const int n = strikes.size();
+  if (n < 5 || vols.size() != n || expiry <= 0.0) return false;
+  SviObj obj(expiry, strikes, forward, vols);
+
+  double kMin = 0.0, kMax = 0.0, wMax = 0.0;
+  int atm = 0;
+  for (int j = 0; j < n; ++j) {
+    const double k = std::log(strikes[j] / forward);
+    kMin = min(kMin, k);
+    kMax = max(kMax, k);
+    wMax = max(wMax, vols[j] * vols[j] * expiry);
+    if (std::fabs(k) < std::fabs(std::log(strikes[atm] / forward))) atm = j;
+  }
+
+  //	guess: the atm variance with a moderate skew and curvature
+  if (params.b == 0.0) {
+    const double w0 = vols[atm] * vols[atm] * expiry;
+    params = SviParams{0.5 * w0, 0.5 * w0 / 0.1, -0.3, 0.0, 0.1};
+  }
+
+  LevenbergMarquardtSettings s = settings;
+  s.lower.resize(5);
+  s.upper.resize(5);
+  const double lower[] = {-wMax, 0.0, -0.999, kMin - 1.0, 1e-4};
+  const double upper[] = {wMax, 2.0, 0.999, kMax + 1.0, 5.0};
+  for (int p = 0; p < 5; ++p) {
+    s.lower[p] = lower[p];
+    s.upper[p] = upper[p];
+  }
+
+  mVector<double> x(5);
+  x[0] = params.a;
+  x[1] = params.b;
+  x[2] = params.rho;
+  x[3] = params.m;
+  x[4] = params.sigma;
+  const bool res = Solver::levenbergMarquardt(obj, x, s, report);
+  params = SviObj::params(x);
+
+  //	done
+  return res;
+}
+
+bool Svi::fit(const mVector<double>& expiries, const mVector<double>& forwards,
+              const mMatrix<double>& strikes, const mMatrix<double>& vols,
+              mVector<double>& thetas, SsviParams& params,
+              const LevenbergMarquardtSettings& settings,
+              LevenbergMarquardtReport* report) {
+  const int n = vols.rows(), m = vols.cols();
+  if (n == 0 || m < 3 || expiries.size() != n || forwards.size() != n ||
+      strikes.rows() != n || strikes.cols() != m)
+    return false;
+  SsviObj obj(expiries, forwards, strikes, vols);
+
+  //	thetas from the quotes nearest the money
+  if (thetas.size() != n) {
+    thetas.resize(n);
+    for (int i = 0; i < n; ++i) {
+      int atm = 0;
+      for (int j = 1; j < m; ++j)
+        if (std::fabs(std::log(strikes(i, j) / forwards[i])) <
+            std::fabs(std::log(strikes(i, atm) / forwards[i])))
+          atm = j;
+      thetas[i] = vols(i, atm) * vols(i, atm) * expiries[i];
+    }
+  }
+
+  LevenbergMarquardtSettings s = settings;
+  s.lower.resize(n + 3);
+  s.upper.resize(n + 3);
+  mVector<double> x(n + 3);
+  for (int i = 0; i < n; ++i) {
+    x[i] = thetas[i];
+    s.lower[i] = 1e-8;
+    s.upper[i] = 10.0;
+  }
+  x[n] = params.rho;
+  x[n + 1] = params.eta;
+  x[n + 2] = params.gamma;
+  const double lower[] = {-0.999, 1e-6, 1e-3};
+  const double upper[] = {0.999, 10.0, 0.5};
+  for (int p = 0; p < 3; ++p) {
+    s.lower[n + p] = lower[p];
+    s.upper[n + p] = upper[p];
+  }
+
+  const bool res = Solver::levenbergMarquardt(obj, x, s, report);
+  for (int i = 0; i < n; ++i) thetas[i] = x[i];
+  params = SsviParams{x[n], x[n + 1], x[n + 2]};
+
+  //	done
+  return res;
+}
@@ -0,0 +1,233 @@
+#include "adi.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//	doubles per cache line, chunks of flat loops are multiples of it from
+//	the start of the storage, which is not itself line aligned, so two
+//	threads share at most the one line straddling their boundary
+static constexpr int cacheLine = 8;
+
+AdiSolver::AdiSolver(const FdmOperator2d& op, AdiScheme scheme, double theta,
+                     ThreadPool* pool)
+    : myOp(&op),
+      myScheme(scheme),
+      myTheta(theta > 0.0 ? theta : defaultTheta(scheme)),
+      myPool(pool) {
+  const int threads = pool ? pool->numThreads() : 1;
+  myScratch.resize(threads);
+  for (auto& s : myScratch) s.resize(op.xSize(), FdmOperator2d::lineBlock);
+  mySlabs.resize(threads);
+  mySlabBegin.assign(threads, -1);
+}
+
+double AdiSolver::defaultTheta(AdiScheme scheme) {
+  switch (scheme) {
+    case AdiScheme::ModifiedCraigSneyd:
+      return 1.0 / 3.0;
+    case AdiScheme::HundsdorferVerwer:
+      return 0.5 + std::sqrt(3.0) / 6.0;
+    default:
+      return 0.5;
+  }
+}
+
+void AdiSolver::parallelFor(int size,
+                            const function<void(int, int, int)>& func,
+                            int align) {
+  if (myPool)
+    myPool->parallelFor(size, func, align);
+  else
+    func(0, 0, size);
+}
+
+void AdiSolver::factorize(double thetaDt, FdmLineFactors& factors) {
+  if (factors.thetaDt == thetaDt && !factors.xPivots.empty()) return;
+  myOp->factorize(thetaDt, factors);
+}
+
+void AdiSolver::applyAll(const mMatrix<double>& v, mMatrix<double>& a0v,
+                         mMatrix<double>& a1v, mMatrix<double>& a2v) {
+  const int nx = myOp->xSize();
+  const int ny = myOp->ySize();
+  a0v.resize(nx, ny);
+  a1v.resize(nx, ny);
+  a2v.resize(nx, ny);
+
+  parallelFor(nx, [&](int, int begin, int end) {
+    myOp->applyMixed(v, a0v, begin, end);
+    myOp->applyX(v, a1v, begin, end);
+    myOp->applyY(v, a2v, begin, end);
+    if (myOp->compact()) myOp->massSolveY(a2v, begin, end);
+  });
+
+  //	compact x parts need whole columns, solved in the slabs
+  if (myOp->compact()) {
+    sweepX(a1v, nullptr, 0.0,
+           [&](int thread, int begin, int end, mMatrix<double>& lines,
+               int offset) {
+             myOp->massSolveX(lines, begin, end, myScratch[thread], offset);
+           });
+    parallelFor(nx, [&](int, int begin, int end) {
+      for (int i = begin; i < end; ++i) gatherSlabs(a1v, i);
+    });
+  }
+}
+
+void AdiSolver::sweepX(
+    mMatrix<double>& v, const mMatrix<double>* av, double thetaDt,
+    const function<void(int, int, int, mMatrix<double>&, int)>& solve) {
+  const int nx = myOp->xSize();
+  std::fill(mySlabBegin.begin(), mySlabBegin.end(), -1);
+
+  //	nothing to share on one thread, in place
+  if (!myPool || myPool->numThreads() == 1) {
+    if (av)
+      for (int k = 0; k < v.size(); ++k) v[k] -= thetaDt * (*av)[k];
+    solve(0, 0, myOp->ySize(), v, 0);
+    return;
+  }
+
+  parallelFor(
+      myOp->ySize(),
+      [&](int thread, int begin, int end) {
+        const int w = end - begin;
+        mMatrix<double>& slab = mySlabs[thread];
+        slab.resize(nx, w);
+        mySlabBegin[thread] = begin;
+        for (int i = 0; i < nx; ++i) {
+          const double* vc = &v(i, begin);
+          double* s = &slab(i, 0);
+          if (av) {
+            const double* ac = &(*av)(i, begin);
+            for (int j = 0; j < w; ++j) s[j] = vc[j] - thetaDt * ac[j];
+          } else {
+            for (int j = 0; j < w; ++j) s[j] = vc[j];
+          }
+        }
+        solve(thread, begin, end, slab, begin);
+      },
+      FdmOperator2d::lineBlock);
+}
+
+void AdiSolver::gatherSlabs(mMatrix<double>& u, int i) const {
+  double* uc = &u(i, 0);
+  for (int t = 0; t < (int)mySlabs.size(); ++t) {
+    if (mySlabBegin[t] < 0) continue;
+    const mMatrix<double>& slab = mySlabs[t];
+    const double* s = &slab(i, 0);
+    double* dst = uc + mySlabBegin[t];
+    for (int j = 0; j < slab.cols(); ++j) dst[j] = s[j];
+  }
+}
+
+void AdiSolver::predict(const mMatrix<double>& u, double dt,
+                        const FdmLineFactors& factors) {
+  applyAll(u, myA0U, myA1U, myA2U);
+
+  //	explicit predictor
+  myY0.resize(u.rows(), u.cols());
+  myY.resize(u.rows(), u.cols());
+  parallelFor(
+      u.size(),
+      [&](int, int begin, int end) {
+        for (int k = begin; k < end; ++k) {
+          myY0[k] = u[k] + dt * (myA0U[k] + myA1U[k] + myA2U[k]);
+          myY[k] = myY0[k];
+        }
+      },
+      cacheLine);
+
+  //	implicit corrections
+  correct(myY, myA1U, myA2U, factors);
+}
+
+void AdiSolver::correct(mMatrix<double>& y, const mMatrix<double>& a1v,
+                        const mMatrix<double>& a2v,
+                        const FdmLineFactors& factors) {
+  const int nx = myOp->xSize();
+  const int ny = myOp->ySize();
+  const double thetaDt = factors.thetaDt;
+
+  //	x lines on column blocks, multiples of the line block
+  sweepX(y, &a1v, thetaDt,
+         [&](int thread, int begin, int end, mMatrix<double>& lines,
+             int offset) {
+           myOp->solveX(factors, lines, begin, end, myScratch[thread],
+                        offset);
+         });
+
+  //	y lines on row blocks, each row first gathered from the slabs
+  parallelFor(nx, [&](int, int begin, int end) {
+    for (int i = begin; i < end; ++i) {
+      gatherSlabs(y, i);
+      double* yc = &y(i, 0);
+      const double* ac = &a2v(i, 0);
+      for (int j = 0; j < ny; ++j) yc[j] -= thetaDt * ac[j];
+    }
+    myOp->solveY(factors, y, begin, end);
+  });
+}
+
+void AdiSolver::step(mMatrix<double>& u, double dt) {
+  factorize(myTheta * dt, myFactors);
+  predict(u, dt, myFactors);
+
+  if (myScheme == AdiScheme::Douglas) {
+    u = myY;
+    return;
+  }
+
+  //	second stage, evaluated at the Douglas predictor
+  if (myScheme == AdiScheme::CraigSneyd) {
+    myA0Y.resize(u.rows(), u.cols());
+    parallelFor(u.rows(), [&](int, int begin, int end) {
+      myOp->applyMixed(myY, myA0Y, begin, end);
+    });
+  } else {
+    applyAll(myY, myA0Y, myA1Y, myA2Y);
+  }
+
+  const AdiScheme scheme = myScheme;
+  const double theta = myTheta;
+  parallelFor(
+      u.size(),
+      [&](int, int begin, int end) {
+        if (scheme == AdiScheme::CraigSneyd) {
+          for (int k = begin; k < end; ++k)
+            u[k] = myY0[k] + 0.5 * dt * (myA0Y[k] - myA0U[k]);
+          return;
+        }
+        for (int k = begin; k < end; ++k) {
+          const double dA0 = myA0Y[k] - myA0U[k];
+          const double dA =
+              dA0 + myA1Y[k] + myA2Y[k] - myA1U[k] - myA2U[k];
+          if (scheme == AdiScheme::ModifiedCraigSneyd)
+            u[k] = myY0[k] + theta * dt * dA0 + (0.5 - theta) * dt * dA;
+          else
+            u[k] = myY0[k] + 0.5 * dt * dA;
+        }
+      },
+      cacheLine);
+
+  //	Hundsdorfer-Verwer corrects against the predictor, the others against u
+  if (myScheme == AdiScheme::HundsdorferVerwer)
+    correct(u, myA1Y, myA2Y, myFactors);
+  else
+    correct(u, myA1U, myA2U, myFactors);
+}
+
+void AdiSolver::rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                         int dampingSteps) {
+  const double dt = expiry / timeSteps;
+  dampingSteps = min(dampingSteps, timeSteps);
+
+  //	implicit Douglas half steps
+  if (dampingSteps > 0) factorize(0.5 * dt, myDampingFactors);
+  for (int n = 0; n < 2 * dampingSteps; ++n) {
+    predict(u, 0.5 * dt, myDampingFactors);
+    u = myY;
+  }
+
+  for (int n = dampingSteps; n < timeSteps; ++n) step(u, dt);
+}
@@ -0,0 +1,104 @@
+#include "adi3d.hpp"
+
+AdiSolver3d::AdiSolver3d(const FdmOperator3d& op, AdiScheme scheme,
+                         double theta, ThreadPool* pool)
+    : myOp(&op),
+      myScheme(scheme),
+      myTheta(theta > 0.0 ? theta : AdiSolver::defaultTheta(scheme)),
+      myPool(pool) {
+  const int threads = pool ? pool->numThreads() : 1;
+  myWork.resize(threads);
+  for (auto& w : myWork) w.resize(op.workSize());
+}
+
+size_t AdiSolver3d::bytes() const {
+  const size_t cube =
+      (size_t)myOp->xSize() * myOp->ySize() * myOp->zSize() * sizeof(double);
+  size_t res = 3 * cube + myOp->bytes();
+  for (const auto& w : myWork) res += w.size() * sizeof(double);
+
+  //	done
+  return res;
+}
+
+void AdiSolver3d::parallelFor(int size,
+                              const function<void(int, int, int)>& func) {
+  if (myPool)
+    myPool->parallelFor(size, func);
+  else
+    func(0, 0, size);
+}
+
+void AdiSolver3d::apply(const mCube<double>& u, double w0, double w1,
+                        double w2, double w3, const mCube<double>& base,
+                        mCube<double>& out) {
+  const double w[4] = {w0, w1, w2, w3};
+  out.resize(u.rows(), u.cols(), u.depth());
+  parallelFor(u.rows(), [&](int thread, int begin, int end) {
+    myOp->apply(u, w, base, out, begin, end, &myWork[thread][0]);
+  });
+}
+
+void AdiSolver3d::correct(const mCube<double>& base, const mCube<double>& v,
+                          double thetaDt, mCube<double>& y) {
+  apply(v, 0.0, -thetaDt, 0.0, 0.0, base, y);
+  parallelFor(y.cols(), [&](int thread, int begin, int end) {
+    myOp->solveX(thetaDt, y, begin, end, &myWork[thread][0]);
+  });
+
+  apply(v, 0.0, 0.0, -thetaDt, 0.0, y, y);
+  parallelFor(y.rows(), [&](int thread, int begin, int end) {
+    myOp->solveY(thetaDt, y, begin, end, &myWork[thread][0]);
+  });
+
+  apply(v, 0.0, 0.0, 0.0, -thetaDt, y, y);
+  parallelFor(y.rows(), [&](int thread, int begin, int end) {
+    myOp->solveZ(thetaDt, y, begin, end, &myWork[thread][0]);
+  });
+}
+
+void AdiSolver3d::predict(const mCube<double>& u, double dt,
+                          double thetaDt) {
+  apply(u, dt, dt, dt, dt, u, myY0);
+  correct(myY0, u, thetaDt, myY);
+}
+
+void AdiSolver3d::step(mCube<double>& u, double dt) {
+  const double thetaDt = myTheta * dt;
+  predict(u, dt, thetaDt);
+
+  if (myScheme == AdiScheme::Douglas) {
+    std::swap(u, myY);
+    return;
+  }
+
+  //	second stage on y0 + dt sum_m c_m A_m (y - u)
+  double c[4] = {0.5, 0.0, 0.0, 0.0};
+  if (myScheme == AdiScheme::ModifiedCraigSneyd)
+    c[1] = c[2] = c[3] = 0.5 - myTheta;
+  else if (myScheme == AdiScheme::HundsdorferVerwer)
+    c[1] = c[2] = c[3] = 0.5;
+  apply(myY, dt * c[0], dt * c[1], dt * c[2], dt * c[3], myY0, myY0);
+  apply(u, -dt * c[0], -dt * c[1], -dt * c[2], -dt * c[3], myY0, myY0);
+
+  //	Hundsdorfer-Verwer corrects against the predictor, the others against u
+  if (myScheme == AdiScheme::HundsdorferVerwer)
+    correct(myY0, myY, thetaDt, myY0);
+  else
+    correct(myY0, u, thetaDt, myY0);
+  std::swap(u, myY0);
+}
+
+void AdiSolver3d::rollback(mCube<double>& u, double expiry, int timeSteps,
+                           int dampingSteps) {
+  const double dt = expiry / timeSteps;
+  dampingSteps = min(dampingSteps, timeSteps);
+
+  //	implicit Douglas half steps
+  for (int n = 0; n < 2 * dampingSteps; ++n) {
+    predict(u, 0.5 * dt, 0.5 * dt);
+    std::swap(u, myY);
+  }
+
+  for (int n = dampingSteps; n < timeSteps; ++n) step(u, dt);
+}
@@ -0,0 +1,200 @@
+#include "adiAdjoint.hpp"
+
+#include <cmath>
+
+AdiAdjoint::AdiAdjoint(const FdmOperator2d& op, AdiScheme scheme,
+                       double theta, int budget)
+    : myOp(&op),
+      myScheme(scheme),
+      myTheta(theta > 0.0 ? theta : AdiSolver::defaultTheta(scheme)),
+      myBudget(budget) {}
+
+void AdiAdjoint::stageWeights(double* c) const {
+  c[0] = 0.5;
+  c[1] = c[2] = 0.0;
+  if (myScheme == AdiScheme::ModifiedCraigSneyd)
+    c[1] = c[2] = 0.5 - myTheta;
+  else if (myScheme == AdiScheme::HundsdorferVerwer)
+    c[1] = c[2] = 0.5;
+}
+
+void AdiAdjoint::rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                          int dampingSteps) {
+  const double dt = expiry / timeSteps;
+  dampingSteps = min(dampingSteps, timeSteps);
+
+  //	implicit Douglas half steps then the scheme
+  myDts.clear();
+  myDamping.clear();
+  for (int n = 0; n < 2 * dampingSteps; ++n) {
+    myDts.push_back(0.5 * dt);
+    myDamping.push_back(true);
+  }
+  for (int n = dampingSteps; n < timeSteps; ++n) {
+    myDts.push_back(dt);
+    myDamping.push_back(false);
+  }
+  if (dampingSteps > 0) myOp->factorize(0.5 * dt, myDampingFactors);
+  myOp->factorize(myTheta * dt, myFactors);
+
+  const int n = steps();
+  const int budget =
+      myBudget > 0 ? myBudget
+                   : max(2, (int)std::ceil(2.0 * std::sqrt((double)n)));
+  myRevolve = Revolve(n, budget);
+  myCheckpoints.resize(myRevolve.budget());
+
+  myRevolve.forward([&](int slot) { myCheckpoints[slot] = u; },
+                    [&](int from, int to) { advance(u, from, to); });
+}
+
+void AdiAdjoint::advance(mMatrix<double>& u, int from, int to) {
+  for (int k = from; k < to; ++k) {
+    std::swap(myTape.u, u);
+    step(k, myTape, u);
+  }
+}
+
+void AdiAdjoint::step(int k, Stages& s, mMatrix<double>& out) {
+  const double dt = myDts[k];
+  const double thetaDt = (myDamping[k] ? 1.0 : myTheta) * dt;
+  const FdmLineFactors& f = factors(k);
+  const mMatrix<double>& u = s.u;
+  const int size = u.size();
+
+  //	Douglas predictor
+  myOp->applyMixed(u, myA);
+  myOp->applyX(u, myB);
+  myOp->applyY(u, myC);
+  myY0.resize(u.rows(), u.cols());
+  s.y1.resize(u.rows(), u.cols());
+  s.y2.resize(u.rows(), u.cols());
+  for (int i = 0; i < size; ++i) {
+    myY0[i] = u[i] + dt * (myA[i] + myB[i] + myC[i]);
+    s.y1[i] = myY0[i] - thetaDt * myB[i];
+  }
+  myOp->solveX(f, s.y1);
+  for (int i = 0; i < size; ++i) s.y2[i] = s.y1[i] - thetaDt * myC[i];
+  myOp->solveY(f, s.y2);
+
+  out.resize(u.rows(), u.cols());
+  if (myDamping[k] || myScheme == AdiScheme::Douglas) {
+    for (int i = 0; i < size; ++i) out[i] = s.y2[i];
+    return;
+  }
+
+  //	second stage on d = y2 - u, corrected against v
+  double c[3];
+  stageWeights(c);
+  myD.resize(u.rows(), u.cols());
+  for (int i = 0; i < size; ++i) myD[i] = s.y2[i] - u[i];
+  myOp->applyMixed(myD, myA);
+  myOp->applyX(myD, myB);
+  myOp->applyY(myD, myC);
+  for (int i = 0; i < size; ++i)
+    out[i] = myY0[i] + dt * (c[0] * myA[i] + c[1] * myB[i] + c[2] * myC[i]);
+
+  const mMatrix<double>& v =
+      myScheme == AdiScheme::HundsdorferVerwer ? s.y2 : u;
+  myOp->applyX(v, myB);
+  myOp->applyY(v, myC);
+  s.w1.resize(u.rows(), u.cols());
+  for (int i = 0; i < size; ++i) s.w1[i] = out[i] - thetaDt * myB[i];
+  myOp->solveX(f, s.w1);
+  for (int i = 0; i < size; ++i) out[i] = s.w1[i] - thetaDt * myC[i];
+  myOp->solveY(f, out);
+}
+
+void AdiAdjoint::reverse(int k, const Stages& s, const mMatrix<double>& out,
+                         mMatrix<double>& lambda,
+                         FdmCoefficients2d& gradient) {
+  const double dt = myDts[k];
+  const double thetaDt = (myDamping[k] ? 1.0 : myTheta) * dt;
+  const FdmLineFactors& f = factors(k);
+  const mMatrix<double>& u = s.u;
+  const int size = u.size();
+
+  myUBar.resize(u.rows(), u.cols());
+  myY0Bar.resize(u.rows(), u.cols());
+  myD.resize(u.rows(), u.cols());
+  for (int i = 0; i < size; ++i) myUBar[i] = myY0Bar[i] = 0.0;
+
+  //	myRBar ends as the adjoint of y2
+  myRBar = lambda;
+  if (!myDamping[k] && myScheme != AdiScheme::Douglas) {
+    const bool hv = myScheme == AdiScheme::HundsdorferVerwer;
+    const mMatrix<double>& v = hv ? s.y2 : u;
+
+    //	out = P2^-1 (w1 - thetaDt A2 v)
+    myOp->solveYTranspose(f, myRBar);
+    for (int i = 0; i < size; ++i) myD[i] = out[i] - v[i];
+    myOp->gradient(myRBar, myD, 0.0, 0.0, thetaDt, gradient);
+    myOp->applyYTranspose(myRBar, myVBar);
+
+    //	w1 = P1^-1 (h - thetaDt A1 v)
+    myOp->solveXTranspose(f, myRBar);
+    for (int i = 0; i < size; ++i) myD[i] = s.w1[i] - v[i];
+    myOp->gradient(myRBar, myD, 0.0, thetaDt, 0.0, gradient);
+    myOp->applyXTranspose(myRBar, myA);
+    for (int i = 0; i < size; ++i)
+      myVBar[i] = -thetaDt * (myVBar[i] + myA[i]);
+
+    //	h = y0 + dt (c0 A0 + c1 A1 + c2 A2) (y2 - u)
+    double c[3];
+    stageWeights(c);
+    for (int i = 0; i < size; ++i) myD[i] = s.y2[i] - u[i];
+    myOp->gradient(myRBar, myD, dt * c[0], dt * c[1], dt * c[2], gradient);
+    myOp->applyMixedTranspose(myRBar, myA);
+    myOp->applyXTranspose(myRBar, myB);
+    myOp->applyYTranspose(myRBar, myC);
+    for (int i = 0; i < size; ++i) {
+      const double dBar =
+          dt * (c[0] * myA[i] + c[1] * myB[i] + c[2] * myC[i]);
+      myY0Bar[i] = myRBar[i];
+      myRBar[i] = dBar + (hv ? myVBar[i] : 0.0);
+      myUBar[i] = -dBar + (hv ? 0.0 : myVBar[i]);
+    }
+  }
+
+  //	y2 = P2^-1 (y1 - thetaDt A2 u)
+  myOp->solveYTranspose(f, myRBar);
+  for (int i = 0; i < size; ++i) myD[i] = s.y2[i] - u[i];
+  myOp->gradient(myRBar, myD, 0.0, 0.0, thetaDt, gradient);
+  myOp->applyYTranspose(myRBar, myC);
+
+  //	y1 = P1^-1 (y0 - thetaDt A1 u)
+  myOp->solveXTranspose(f, myRBar);
+  for (int i = 0; i < size; ++i) myD[i] = s.y1[i] - u[i];
+  myOp->gradient(myRBar, myD, 0.0, thetaDt, 0.0, gradient);
+  myOp->applyXTranspose(myRBar, myB);
+  for (int i = 0; i < size; ++i) {
+    myUBar[i] -= thetaDt * (myB[i] + myC[i]);
+    myY0Bar[i] += myRBar[i];
+  }
+
+  //	y0 = u + dt A u
+  myOp->gradient(myY0Bar, u, dt, dt, dt, gradient);
+  myOp->applyMixedTranspose(myY0Bar, myA);
+  myOp->applyXTranspose(myY0Bar, myB);
+  myOp->applyYTranspose(myY0Bar, myC);
+  for (int i = 0; i < size; ++i)
+    lambda[i] = myUBar[i] + myY0Bar[i] +
+                dt * (myA[i] + myB[i] + myC[i]);
+}
+
+void AdiAdjoint::adjoint(mMatrix<double>& lambda,
+                         FdmCoefficients2d& gradient) {
+  if (gradient.axx.rows() != myOp->xSize() ||
+      gradient.axx.cols() != myOp->ySize())
+    gradient.resize(myOp->xSize(), myOp->ySize());
+
+  myRevolve.reverse(
+      [&](int slot) { myCheckpoints[slot] = myState; },
+      [&](int slot) { myState = myCheckpoints[slot]; },
+      [&](int from, int to) { advance(myState, from, to); },
+      [&](int k) {
+        myTape.u = myState;
+        step(k, myTape, myOut);
+        reverse(k, myTape, myOut, lambda, gradient);
+      });
+}
@@ -0,0 +1,286 @@
+#include "chebyshev.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "constants.hpp"
+#include "mMatrixAlgebra.hpp"
+
+ChebyshevGrid::ChebyshevGrid(double xMin, double xMax, int size)
+    : myPoints(size) {
+  const int n = size - 1;
+  const double c = 0.5 * (xMin + xMax);
+  const double h = 0.5 * (xMax - xMin);
+  const double step = Constants::pi() / n;
+  for (int j = 0; j <= n; ++j) myPoints[j] = c - h * std::cos(step * j);
+  myPoints[0] = xMin;
+  myPoints[n] = xMax;
+
+  //	D_ik = (w_k / w_i) / (x_i - x_k) with the barycentric weights, the
+  //	diagonals as minus the row sums so that constants are exact
+  mVector<double> w(size);
+  for (int j = 0; j <= n; ++j) w[j] = (j % 2 ? -1.0 : 1.0);
+  w[0] *= 0.5;
+  w[n] *= 0.5;
+
+  myD1.resize(size, size, 0.0);
+  for (int i = 0; i <= n; ++i) {
+    double sum = 0.0;
+    for (int k = 0; k <= n; ++k) {
+      if (k == i) continue;
+      myD1(i, k) = w[k] / w[i] / (myPoints[i] - myPoints[k]);
+      sum += myD1(i, k);
+    }
+    myD1(i, i) = -sum;
+  }
+
+  myD2.resize(size, size, 0.0);
+  for (int i = 0; i <= n; ++i) {
+    double sum = 0.0;
+    for (int k = 0; k <= n; ++k) {
+      if (k == i) continue;
+      double d = 0.0;
+      for (int p = 0; p <= n; ++p) d += myD1(i, p) * myD1(p, k);
+      myD2(i, k) = d;
+      sum += d;
+    }
+    myD2(i, i) = -sum;
+  }
+}
+
+void ChebyshevGrid::weights(double x, mVector<double>& res) const {
+  const int n = size() - 1;
+  res.assign(n + 1, 0.0);
+  x = max(xMin(), min(xMax(), x));
+
+  double sum = 0.0;
+  for (int j = 0; j <= n; ++j) {
+    const double d = x - myPoints[j];
+    if (d == 0.0) {
+      res.assign(n + 1, 0.0);
+      res[j] = 1.0;
+      return;
+    }
+    const double w = (j % 2 ? -1.0 : 1.0) * (j == 0 || j == n ? 0.5 : 1.0);
+    res[j] = w / d;
+    sum += res[j];
+  }
+  for (int j = 0; j <= n; ++j) res[j] /= sum;
+}
+
+double ChebyshevGrid::interpolate(const mVectorView<double>& values,
+                                  double x) const {
+  mVector<double> w;
+  weights(x, w);
+
+  double res = 0.0;
+  for (int j = 0; j < size(); ++j) res += w[j] * values[j];
+
+  //	done
+  return res;
+}
+
+void ChebyshevGrid::interpolate(const mMatrix<double>& values, double x,
+                                mVector<double>& res) const {
+  mVector<double> w;
+  weights(x, w);
+
+  const int m = values.cols();
+  res.assign(m, 0.0);
+  for (int j = 0; j < size(); ++j) {
+    const double* v = &values(j, 0);
+    for (int k = 0; k < m; ++k) res[k] += w[j] * v[k];
+  }
+}
+
+ChebyshevOperator::ChebyshevOperator(const ChebyshevGrid& x) : myX(x) {}
+
+ChebyshevOperator::ChebyshevOperator(const ChebyshevGrid& x,
+                                     const ChebyshevGrid& y)
+    : myX(x), myY(y), myYSize(y.size()) {}
+
+void ChebyshevOperator::setBoundaries(FdmBoundary lower, FdmBoundary upper) {
+  myXLower = lower;
+  myXUpper = upper;
+}
+
+void ChebyshevOperator::setBoundaries(FdmBoundary xLower, FdmBoundary xUpper,
+                                      FdmBoundary yLower, FdmBoundary yUpper) {
+  myXLower = xLower;
+  myXUpper = xUpper;
+  myYLower = yLower;
+  myYUpper = yUpper;
+}
+
+void ChebyshevOperator::assemble(const FdmCoefficients1d& coeffs) {
+  const int n = myX.size();
+  const mMatrix<double>& d1 = myX.d1();
+  const mMatrix<double>& d2 = myX.d2();
+  myMatrix.resize(n, n, 0.0);
+  myMatrix = 0.0;
+
+  for (int i = 0; i < n; ++i) {
+    const FdmBoundary side = i == 0       ? myXLower
+                             : i == n - 1 ? myXUpper
+                                          : FdmBoundary::Linear;
+    const bool edge = i == 0 || i == n - 1;
+    if (edge && side == FdmBoundary::Dirichlet) continue;
+
+    const double a = edge ? 0.0 : coeffs.a[i];
+    const double b = coeffs.b[i];
+    double* row = &myMatrix(i, 0);
+    for (int k = 0; k < n; ++k) row[k] = a * d2(i, k) + b * d1(i, k);
+    row[i] += coeffs.r[i];
+  }
+
+  ++myVersion;
+}
+
+void ChebyshevOperator::assemble(const FdmCoefficients2d& coeffs) {
+  const int nx = myX.size();
+  const int ny = myYSize;
+  const int n = nx * ny;
+  const mMatrix<double>& dx1 = myX.d1();
+  const mMatrix<double>& dx2 = myX.d2();
+  const mMatrix<double>& dy1 = myY.d1();
+  const mMatrix<double>& dy2 = myY.d2();
+  myMatrix.resize(n, n, 0.0);
+  myMatrix = 0.0;
+
+  for (int i = 0; i < nx; ++i) {
+    const bool xEdge = i == 0 || i == nx - 1;
+    const bool xFrozen = (i == 0 && myXLower == FdmBoundary::Dirichlet) ||
+                         (i == nx - 1 && myXUpper == FdmBoundary::Dirichlet);
+    for (int j = 0; j < ny; ++j) {
+      const bool yEdge = j == 0 || j == ny - 1;
+      const bool yFrozen =
+          (j == 0 && myYLower == FdmBoundary::Dirichlet) ||
+          (j == ny - 1 && myYUpper == FdmBoundary::Dirichlet);
+      if (xFrozen || yFrozen) continue;
+
+      const double axx = xEdge ? 0.0 : coeffs.axx(i, j);
+      const double ayy = yEdge ? 0.0 : coeffs.ayy(i, j);
+      const double axy = xEdge || yEdge ? 0.0 : coeffs.axy(i, j);
+      const double bx = coeffs.bx(i, j);
+      const double by = coeffs.by(i, j);
+      double* row = &myMatrix(i * ny + j, 0);
+
+      //	x derivatives along the column j, y ones along the row i
+      for (int p = 0; p < nx; ++p)
+        row[p * ny + j] += axx * dx2(i, p) + bx * dx1(i, p);
+      for (int q = 0; q < ny; ++q)
+        row[i * ny + q] += ayy * dy2(j, q) + by * dy1(j, q);
+      if (axy != 0.0)
+        for (int p = 0; p < nx; ++p) {
+          const double w = axy * dx1(i, p);
+          for (int q = 0; q < ny; ++q) row[p * ny + q] += w * dy1(j, q);
+        }
+      row[i * ny + j] += coeffs.r(i, j);
+    }
+  }
+
+  ++myVersion;
+}
+
+void ChebyshevOperator::apply(const mMatrix<double>& u,
+                              mMatrix<double>& res) const {
+  const int n = size();
+  const int m = u.size() / n;
+  res.resize(n, m, 0.0);
+  for (int i = 0; i < n; ++i) {
+    const double* l = &myMatrix(i, 0);
+    double* r = &res(i, 0);
+    for (int k = 0; k < m; ++k) r[k] = 0.0;
+    for (int p = 0; p < n; ++p) {
+      if (l[p] == 0.0) continue;
+      const double* up = &u.data()[p * m];
+      for (int k = 0; k < m; ++k) r[k] += l[p] * up[k];
+    }
+  }
+}
+
+void ChebyshevOperator::value(const mMatrix<double>& u, double x,
+                              mVector<double>& res) const {
+  myX.interpolate(u, x, res);
+}
+
+double ChebyshevOperator::value(const mMatrix<double>& u, double x,
+                                double y) const {
+  mVector<double> row;
+  myX.interpolate(u, x, row);
+
+  //	done
+  return myY.interpolate(row, y);
+}
+
+ChebyshevSolver::ChebyshevSolver(const ChebyshevOperator& op, double theta,
+                                 int cacheSize)
+    : myOp(&op), myTheta(theta), myCacheSize(max(cacheSize, 1)) {}
+
+const ChebyshevSolver::Factors& ChebyshevSolver::factorize(double thetaDt) {
+  const int n = myOp->size();
+  const int version = myOp->version();
+  for (int k = 0; k < (int)myCache.size(); ++k) {
+    const Factors& f = myCache[k];
+    if (f.size != n || f.version != version || f.thetaDt != thetaDt) continue;
+    std::rotate(myCache.begin(), myCache.begin() + k, myCache.begin() + k + 1);
+    return myCache[0];
+  }
+
+  //	the least recently used entry is recycled
+  if ((int)myCache.size() < myCacheSize) myCache.emplace_back();
+  std::rotate(myCache.begin(), myCache.end() - 1, myCache.end());
+  Factors& f = myCache[0];
+  f.size = n;
+  f.version = version;
+  f.thetaDt = thetaDt;
+
+  const mMatrix<double>& L = myOp->matrix();
+  f.lu.resize(n, n, 0.0);
+  for (int i = 0; i < n; ++i)
+    for (int k = 0; k < n; ++k)
+      f.lu(i, k) = (i == k ? 1.0 : 0.0) - thetaDt * L(i, k);
+  ++myFactorizations;
+
+  //	singular factors are not kept
+  if (!mMatrixAlgebra::lu(f.lu, f.pivots)) {
+    f.version = -1;
+    throw std::runtime_error("ChebyshevSolver: I - theta dt L is singular");
+  }
+
+  //	done
+  return f;
+}
+
+void ChebyshevSolver::step(mMatrix<double>& u, double dt, double theta) {
+  const Factors& f = factorize(theta * dt);
+
+  //	u seen as size() rows, explicit part u + (1 - theta) dt L u
+  const int n = myOp->size();
+  const int m = u.size() / n;
+  myU.resize(n, m, 0.0);
+  std::copy(u.data().begin(), u.data().end(), myU.data().begin());
+  myOp->apply(myU, myRhs);
+  const double w = (1.0 - theta) * dt;
+  for (int i = 0; i < n * m; ++i) myRhs[i] = myU[i] + w * myRhs[i];
+
+  //	implicit part, all columns against the same factors
+  mMatrixAlgebra::luSolve(f.lu, f.pivots, myRhs);
+  std::copy(myRhs.data().begin(), myRhs.data().end(), u.data().begin());
+}
+
+void ChebyshevSolver::step(mMatrix<double>& u, double dt) {
+  step(u, dt, myTheta);
+}
+
+void ChebyshevSolver::rollback(mMatrix<double>& u, double expiry,
+                               int timeSteps, int dampingSteps) {
+  const double dt = expiry / timeSteps;
+  dampingSteps = min(dampingSteps, timeSteps);
+
+  //	implicit half steps
+  for (int n = 0; n < 2 * dampingSteps; ++n) step(u, 0.5 * dt, 1.0);
+
+  for (int n = dampingSteps; n < timeSteps; ++n) step(u, dt, myTheta);
+}
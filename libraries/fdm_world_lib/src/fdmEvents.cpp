@@ -0,0 +1,147 @@
+#include "fdmEvents.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "constants.hpp"
+
+FdmEvent FdmEvent::barrier(double time, double lower, double upper,
+                           double rebate) {
+  FdmEvent res;
+  res.time = time;
+  res.type = FdmEventType::Barrier;
+  res.lower = lower;
+  res.upper = upper;
+  res.rebate = rebate;
+
+  //	done
+  return res;
+}
+
+FdmEvent FdmEvent::jump(double time, double amount, double proportion) {
+  FdmEvent res;
+  res.time = time;
+  res.type = FdmEventType::Jump;
+  res.amount = amount;
+  res.proportion = proportion;
+
+  //	done
+  return res;
+}
+
+FdmEvent FdmEvent::exercise(double time, const mMatrix<double>& values) {
+  FdmEvent res;
+  res.time = time;
+  res.type = FdmEventType::Exercise;
+  res.values = values;
+
+  //	done
+  return res;
+}
+
+void FdmEventSchedule::add(const FdmEvent& event) {
+  //	stable: events on the same date keep the order they were added in
+  auto it = std::upper_bound(
+      myEvents.begin(), myEvents.end(), event.time,
+      [](double t, const FdmEvent& e) { return t < e.time; });
+  myEvents.insert(it, event);
+}
+
+mVector<double> FdmEventSchedule::times() const {
+  vector<double> res;
+  for (const FdmEvent& e : myEvents)
+    if (res.empty() || e.time != res.back()) res.push_back(e.time);
+
+  mVector<double> out(res.size(), 0.0);
+  for (int k = 0; k < (int)res.size(); ++k) out[k] = res[k];
+
+  //	done
+  return out;
+}
+
+bool FdmEventSchedule::apply(double t, const FdmGrid& x, mMatrix<double>& u,
+                             mMatrix<double>& scratch) const {
+  const double tol = Constants::epsilon() * max(1.0, t);
+  bool res = false;
+  for (const FdmEvent& e : myEvents) {
+    if (std::fabs(e.time - t) > tol) continue;
+    switch (e.type) {
+      case FdmEventType::Barrier:
+        applyBarrier(e, x, u);
+        res = true;
+        break;
+      case FdmEventType::Jump:
+        applyJump(e, x, u, scratch);
+        res = true;
+        break;
+      case FdmEventType::Exercise:
+        applyExercise(e, u);
+        break;
+    }
+  }
+
+  //	done
+  return res;
+}
+
+void FdmEventSchedule::applyBarrier(const FdmEvent& event, const FdmGrid& x,
+                                    mMatrix<double>& u) {
+  const int n = x.size();
+  const int m = u.cols();
+  const double lower = event.lower, upper = event.upper;
+
+  //	fraction of the cell around each node alive, as the cell averaged
+  //	payoffs, so that the value does not jump as the barrier crosses a node
+  for (int i = 0; i < n; ++i) {
+    const double a = i > 0 ? 0.5 * (x[i - 1] + x[i]) : x[i];
+    const double b = i < n - 1 ? 0.5 * (x[i] + x[i + 1]) : x[i];
+    double w;
+    if (b > a)
+      w = max(0.0, min(b, upper) - max(a, lower)) / (b - a);
+    else
+      w = x[i] > lower && x[i] < upper ? 1.0 : 0.0;
+    if (w == 1.0) continue;
+
+    const double r = (1.0 - w) * event.rebate;
+    double* row = &u(i, 0);
+    for (int k = 0; k < m; ++k) row[k] = w * row[k] + r;
+  }
+}
+
+void FdmEventSchedule::applyJump(const FdmEvent& event, const FdmGrid& x,
+                                 mMatrix<double>& u,
+                                 mMatrix<double>& scratch) {
+  const int n = x.size();
+  const int m = u.cols();
+
+  //	pre jump values, no allocation once scratch has the size of u
+  scratch.resize(u.rows(), m);
+  std::copy(u.data().begin(), u.data().end(), scratch.data().begin());
+  const mMatrix<double>& old = scratch;
+
+  //	interpolate every column at the pre jump points, flat outside the grid
+  double w[4];
+  int order;
+  for (int i = 0; i < n; ++i) {
+    const double y0 = x[i] - event.amount - event.proportion * x[i];
+    const double y = max(x.front(), min(x.back(), y0));
+    const int i0 = x.lagrangeWeights(y, w, order);
+    double* row = &u(i, 0);
+    for (int k = 0; k < m; ++k) row[k] = 0.0;
+    for (int l = 0; l < order; ++l) {
+      const double* src = &old(i0 + l, 0);
+      for (int k = 0; k < m; ++k) row[k] += w[l] * src[k];
+    }
+  }
+}
+
+void FdmEventSchedule::applyExercise(const FdmEvent& event,
+                                     mMatrix<double>& u) {
+  const int n = u.rows();
+  const int m = u.cols();
+  for (int i = 0; i < n; ++i) {
+    double* row = &u(i, 0);
+    const double* e = &event.values(i, 0);
+    for (int k = 0; k < m; ++k) row[k] = max(row[k], e[k]);
+  }
+}
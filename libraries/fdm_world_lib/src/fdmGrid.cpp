@@ -0,0 +1,339 @@
+#include "fdmGrid.hpp"
+
+#include <cmath>
+
+FdmGrid::FdmGrid(const mVector<double>& points) : myPoints(points) {
+  computeWeights();
+}
+
+FdmGrid FdmGrid::uniform(double xMin, double xMax, int size) {
+  mVector<double> x(size);
+  const double dx = (xMax - xMin) / (size - 1);
+  for (int i = 0; i < size; ++i) x[i] = xMin + i * dx;
+  x[size - 1] = xMax;
+
+  //	done
+  return FdmGrid(x);
+}
+
+FdmGrid FdmGrid::concentrated(double xMin, double xMax, int size,
+                              double centre, double density) {
+  //	x = centre + alpha sinh(xi), xi uniform
+  const double alpha = density * (xMax - xMin);
+  const double xiMin = std::asinh((xMin - centre) / alpha);
+  const double xiMax = std::asinh((xMax - centre) / alpha);
+  const double dxi = (xiMax - xiMin) / (size - 1);
+
+  mVector<double> x(size);
+  for (int i = 0; i < size; ++i)
+    x[i] = centre + alpha * std::sinh(xiMin + i * dxi);
+  x[0] = xMin;
+  x[size - 1] = xMax;
+
+  //	done
+  return FdmGrid(x);
+}
+
+void FdmGrid::stencil(int i, double a, double b, FdmConvection scheme,
+                      double& low, double& diag, double& up) const {
+  const int n = size();
+  const bool interior = i > 0 && i < n - 1;
+
+  if (interior && scheme == FdmConvection::Fitted) {
+    //	fitted on the larger cell, which keeps both off diagonals non negative
+    //	on non-uniform grids
+    const double h = max(myPoints[i] - myPoints[i - 1],
+                         myPoints[i + 1] - myPoints[i]);
+    const double p = 0.5 * b * h;
+    if (a <= 0.0)
+      a = std::fabs(p);
+    else if (std::fabs(p) > 1.0e-8 * a)
+      a = p / std::tanh(p / a);
+  }
+
+  low = a * myD2Minus[i] + b * myD1Minus[i];
+  diag = a * myD2Centre[i] + b * myD1Centre[i];
+  up = a * myD2Plus[i] + b * myD1Plus[i];
+  if (!interior || scheme != FdmConvection::Upwind || (low >= 0.0 && up >= 0.0))
+    return;
+
+  //	smallest blend w with the one sided difference, which removes the
+  //	negative off diagonal
+  const double hm = myPoints[i] - myPoints[i - 1];
+  const double hp = myPoints[i + 1] - myPoints[i];
+  double w;
+  double oneLow = 0.0, oneDiag, oneUp = 0.0;
+  if (b > 0.0) {
+    w = 1.0 + a * myD2Minus[i] / (b * myD1Minus[i]);
+    oneDiag = -b / hp;
+    oneUp = b / hp;
+  } else {
+    w = 1.0 + a * myD2Plus[i] / (b * myD1Plus[i]);
+    oneLow = -b / hm;
+    oneDiag = b / hm;
+  }
+  w = max(0.0, min(1.0, w));
+  low = a * myD2Minus[i] + (1.0 - w) * b * myD1Minus[i] + w * oneLow;
+  diag = a * myD2Centre[i] + (1.0 - w) * b * myD1Centre[i] + w * oneDiag;
+  up = a * myD2Plus[i] + (1.0 - w) * b * myD1Plus[i] + w * oneUp;
+}
+
+int FdmGrid::locate(double x) const {
+  const int n = size();
+  if (x <= myPoints[0]) return 0;
+  if (x >= myPoints[n - 1]) return n - 2;
+
+  const auto& p = myPoints.data();
+  int i = (int)(std::upper_bound(p.begin(), p.end(), x) - p.begin()) - 1;
+
+  //	done
+  return min(i, n - 2);
+}
+
+int FdmGrid::lagrangeWeights(double x, double* weights, int& order) const {
+  const int n = size();
+  const int i = locate(x);
+
+  //	linear when there are not enough nodes for a cubic
+  if (n < 4) {
+    const double w = (x - myPoints[i]) / (myPoints[i + 1] - myPoints[i]);
+    weights[0] = 1.0 - w;
+    weights[1] = w;
+    order = 2;
+    return i;
+  }
+
+  //	four nodes around x
+  const int i0 = min(max(i - 1, 0), n - 4);
+  order = 4;
+  for (int k = 0; k < 4; ++k) {
+    double w = 1.0;
+    for (int l = 0; l < 4; ++l) {
+      if (l == k) continue;
+      w *= (x - myPoints[i0 + l]) / (myPoints[i0 + k] - myPoints[i0 + l]);
+    }
+    weights[k] = w;
+  }
+
+  //	done
+  return i0;
+}
+
+int FdmGrid::lagrangeWeights(double x, double* weights, double* d1,
+                             double* d2, int& order) const {
+  const int i0 = lagrangeWeights(x, weights, order);
+
+  if (order == 2) {
+    const double h = myPoints[i0 + 1] - myPoints[i0];
+    d1[0] = -1.0 / h;
+    d1[1] = 1.0 / h;
+    d2[0] = d2[1] = 0.0;
+    return i0;
+  }
+
+  //	derivatives of prod_{l != k} (x - x_l) over the same denominators
+  for (int k = 0; k < 4; ++k) {
+    double e[3], denom = 1.0;
+    int m = 0;
+    for (int l = 0; l < 4; ++l) {
+      if (l == k) continue;
+      e[m++] = x - myPoints[i0 + l];
+      denom *= myPoints[i0 + k] - myPoints[i0 + l];
+    }
+    d1[k] = (e[0] * e[1] + e[0] * e[2] + e[1] * e[2]) / denom;
+    d2[k] = 2.0 * (e[0] + e[1] + e[2]) / denom;
+  }
+
+  //	done
+  return i0;
+}
+
+double FdmGrid::interpolate(const mVectorView<double>& values,
+                            double x) const {
+  double w[4];
+  int order;
+  const int i0 = lagrangeWeights(x, w, order);
+
+  double res = 0.0;
+  for (int k = 0; k < order; ++k) res += w[k] * values[i0 + k];
+
+  //	done
+  return res;
+}
+
+void FdmGrid::interpolate(const mMatrix<double>& values, double x,
+                          mVector<double>& out) const {
+  double w[4];
+  int order;
+  const int i0 = lagrangeWeights(x, w, order);
+
+  const int m = values.cols();
+  out.assign(m, 0.0);
+  for (int k = 0; k < order; ++k) {
+    const double* v = &values(i0 + k, 0);
+    for (int j = 0; j < m; ++j) out[j] += w[k] * v[j];
+  }
+}
+
+double FdmGrid::vanillaAverage(int i, double strike, bool isCall) const {
+  const int n = size();
+  const double x = myPoints[i];
+  const double a = i > 0 ? 0.5 * (myPoints[i - 1] + x) : x;
+  const double b = i < n - 1 ? 0.5 * (x + myPoints[i + 1]) : x;
+
+  if (b <= a) return isCall ? max(x - strike, 0.0) : max(strike - x, 0.0);
+
+  if (isCall) {
+    if (strike <= a) return 0.5 * (a + b) - strike;
+    if (strike >= b) return 0.0;
+    return 0.5 * (b - strike) * (b - strike) / (b - a);
+  }
+
+  if (strike >= b) return strike - 0.5 * (a + b);
+  if (strike <= a) return 0.0;
+  return 0.5 * (strike - a) * (strike - a) / (b - a);
+}
+
+double FdmGrid::position(double xi) const {
+  const int n = size();
+  const int j = max(1, min((int)std::floor(xi), n - 3));
+  const double t = xi - j;
+  const double* x = &myPoints[j - 1];
+
+  //	done
+  return -t * (t - 1.0) * (t - 2.0) / 6.0 * x[0] +
+         (t + 1.0) * (t - 1.0) * (t - 2.0) / 2.0 * x[1] -
+         (t + 1.0) * t * (t - 2.0) / 2.0 * x[2] +
+         (t + 1.0) * t * (t - 1.0) / 6.0 * x[3];
+}
+
+namespace {
+
+//	cubic B-spline on [-2, 2]
+double bspline(double s) {
+  s = std::fabs(s);
+  if (s >= 2.0) return 0.0;
+  if (s >= 1.0) return (2.0 - s) * (2.0 - s) * (2.0 - s) / 6.0;
+  return (4.0 - 6.0 * s * s + 3.0 * s * s * s) / 6.0;
+}
+
+//	fourth order smoothing kernel on [-3, 3], its transform is
+//	sinc^4(w / 2) (1 + 2 / 3 sin^2(w / 2))
+double kreiss(double s) {
+  return 4.0 / 3.0 * bspline(s) -
+         (bspline(s - 1.0) + bspline(s + 1.0)) / 6.0;
+}
+
+}  // namespace
+
+double FdmGrid::vanillaSmoothed(int i, double strike, bool isCall) const {
+  const int n = size();
+  auto payoff = [&](double x) {
+    return isCall ? max(x - strike, 0.0) : max(strike - x, 0.0);
+  };
+
+  //	away from the kink the payoff is linear, near the ends there is no room
+  //	for the kernel
+  const double x = myPoints[i];
+  if (i < 3 || i > n - 4) return vanillaAverage(i, strike, isCall);
+  if (strike <= myPoints[i - 3] || strike >= myPoints[i + 3]) return payoff(x);
+
+  //	4 point gauss on every unit piece of the kernel, split at the kink
+  static constexpr double nodes[4] = {-0.8611363115940526, -0.3399810435848563,
+                                      0.3399810435848563, 0.8611363115940526};
+  static constexpr double weights[4] = {0.3478548451374538, 0.6521451548625461,
+                                        0.6521451548625461, 0.3478548451374538};
+  auto integrate = [&](double a, double b) {
+    double res = 0.0;
+    for (int q = 0; q < 4; ++q) {
+      const double s = 0.5 * (a + b) + 0.5 * (b - a) * nodes[q];
+      res += weights[q] * kreiss(s) * payoff(position(i + s));
+    }
+    return 0.5 * (b - a) * res;
+  };
+
+  double res = 0.0;
+  for (int m = -3; m < 3; ++m) {
+    const double lo = myPoints[i + m];
+    const double hi = myPoints[i + m + 1];
+    if (strike <= lo || strike >= hi) {
+      res += integrate(m, m + 1);
+      continue;
+    }
+
+    //	kink by bisection on the monotone map
+    double a = m, b = m + 1;
+    for (int k = 0; k < 50; ++k) {
+      const double c = 0.5 * (a + b);
+      (position(i + c) < strike ? a : b) = c;
+    }
+    res += integrate(m, a) + integrate(a, m + 1);
+  }
+
+  //	done
+  return res;
+}
+
+void FdmGrid::mapDerivatives(mVector<double>& d1,
+                             mVector<double>& d2) const {
+  const int n = size();
+  const mVector<double>& x = myPoints;
+  d1.assign(n, 0.0);
+  d2.assign(n, 0.0);
+  if (n < 3) {
+    if (n == 2) d1[0] = d1[1] = x[1] - x[0];
+    return;
+  }
+
+  for (int i = 1; i < n - 1; ++i) {
+    if (i > 1 && i < n - 2) {
+      d1[i] = (x[i - 2] - 8.0 * x[i - 1] + 8.0 * x[i + 1] - x[i + 2]) / 12.0;
+      d2[i] = (-x[i - 2] + 16.0 * x[i - 1] - 30.0 * x[i] + 16.0 * x[i + 1] -
+               x[i + 2]) /
+              12.0;
+    } else {
+      d1[i] = 0.5 * (x[i + 1] - x[i - 1]);
+      d2[i] = x[i + 1] - 2.0 * x[i] + x[i - 1];
+    }
+  }
+
+  //	one sided at the ends
+  d1[0] = 0.5 * (-3.0 * x[0] + 4.0 * x[1] - x[2]);
+  d2[0] = x[0] - 2.0 * x[1] + x[2];
+  d1[n - 1] = 0.5 * (3.0 * x[n - 1] - 4.0 * x[n - 2] + x[n - 3]);
+  d2[n - 1] = x[n - 1] - 2.0 * x[n - 2] + x[n - 3];
+}
+
+void FdmGrid::computeWeights() {
+  const int n = size();
+  myD1Minus.assign(n, 0.0);
+  myD1Centre.assign(n, 0.0);
+  myD1Plus.assign(n, 0.0);
+  myD2Minus.assign(n, 0.0);
+  myD2Centre.assign(n, 0.0);
+  myD2Plus.assign(n, 0.0);
+  if (n < 2) return;
+
+  //	interior: central differences on the non-uniform stencil
+  for (int i = 1; i < n - 1; ++i) {
+    const double hm = myPoints[i] - myPoints[i - 1];
+    const double hp = myPoints[i + 1] - myPoints[i];
+
+    myD1Minus[i] = -hp / (hm * (hm + hp));
+    myD1Centre[i] = (hp - hm) / (hm * hp);
+    myD1Plus[i] = hm / (hp * (hm + hp));
+
+    myD2Minus[i] = 2.0 / (hm * (hm + hp));
+    myD2Centre[i] = -2.0 / (hm * hp);
+    myD2Plus[i] = 2.0 / (hp * (hm + hp));
+  }
+
+  //	boundaries: one sided first derivatives
+  const double h0 = myPoints[1] - myPoints[0];
+  myD1Centre[0] = -1.0 / h0;
+  myD1Plus[0] = 1.0 / h0;
+
+  const double hn = myPoints[n - 1] - myPoints[n - 2];
+  myD1Minus[n - 1] = -1.0 / hn;
+  myD1Centre[n - 1] = 1.0 / hn;
+}
@@ -0,0 +1,187 @@
+#include "fdmOperator1d.hpp"
+
+#include <cmath>
+
+FdmOperator1d::FdmOperator1d(const FdmGrid& x)
+    : myX(x), myMatrix(x.size()), myMass(x.size()) {
+  for (int i = 0; i < x.size(); ++i) myMass.diag(i) = 1.0;
+}
+
+void FdmOperator1d::setBoundaries(FdmBoundary lower, FdmBoundary upper) {
+  myLower = lower;
+  myUpper = upper;
+}
+
+void FdmOperator1d::compactStencil(const FdmGrid& x,
+                                   const mVector<double>& a,
+                                   const mVector<double>& b,
+                                   const mVector<double>& r,
+                                   Tridiagonal<double>& mass,
+                                   Tridiagonal<double>& res) {
+  const int n = x.size();
+  mass.resize(n);
+  res.resize(n);
+
+  //	on the uniform index grid: u_xx = (u'' - x'' u_x) / x'^2, u_x = u' / x'
+  mVector<double> d1, d2;
+  x.mapDerivatives(d1, d2);
+  mVector<double> ah(n), bh(n);
+  for (int i = 0; i < n; ++i) {
+    const double j = 1.0 / d1[i];
+    ah[i] = a[i] * j * j;
+    bh[i] = b[i] * j - a[i] * d2[i] * j * j * j;
+  }
+
+  auto standard = [&](int i) {
+    mass.diag(i) = 1.0;
+    res.lower(i) = a[i] * x.d2Minus(i) + b[i] * x.d1Minus(i);
+    res.diag(i) = a[i] * x.d2Centre(i) + b[i] * x.d1Centre(i) + r[i];
+    res.upper(i) = a[i] * x.d2Plus(i) + b[i] * x.d1Plus(i);
+  };
+
+  for (int i = 0; i < n; ++i) {
+    if (i == 0 || i == n - 1 || ah[i] <= 0.0) {
+      standard(i);
+      continue;
+    }
+
+    //	a u'' + b u' = f with f = u_t - r u, the h^2 terms of the central
+    //	differences replaced by derivatives of the equation
+    const double da = 0.5 * (ah[i + 1] - ah[i - 1]);
+    const double dda = ah[i + 1] - 2.0 * ah[i] + ah[i - 1];
+    const double db = 0.5 * (bh[i + 1] - bh[i - 1]);
+    const double ddb = bh[i + 1] - 2.0 * bh[i] + bh[i - 1];
+    const double c = (2.0 * da - bh[i]) / (12.0 * ah[i]);
+    if (std::fabs(c) >= 0.5) {
+      standard(i);
+      continue;
+    }
+    const double A = ah[i] + (dda + 2.0 * db) / 12.0 - c * (da + bh[i]);
+    const double B = bh[i] + ddb / 12.0 - c * db;
+
+    //	M f = A d2 u + B d1 u, then M u_t = L u with L = A d2 + B d1 + M r
+    mass.lower(i) = 1.0 / 12.0 + 0.5 * c;
+    mass.diag(i) = 5.0 / 6.0;
+    mass.upper(i) = 1.0 / 12.0 - 0.5 * c;
+    res.lower(i) = A - 0.5 * B + mass.lower(i) * r[i - 1];
+    res.diag(i) = -2.0 * A + mass.diag(i) * r[i];
+    res.upper(i) = A + 0.5 * B + mass.upper(i) * r[i + 1];
+  }
+}
+
+void FdmOperator1d::setConvection(FdmConvection scheme, double xMin,
+                                  double xMax) {
+  const int n = size();
+  if (myConvection.empty()) myConvection.assign(n, FdmConvection::Central);
+  for (int i = 0; i < n; ++i)
+    if (myX[i] >= xMin && myX[i] <= xMax) myConvection[i] = scheme;
+}
+
+void FdmOperator1d::assemble(const FdmCoefficients1d& coeffs) {
+  const int n = size();
+  if (myCompact || !myConvection.empty()) myCoeffs = coeffs;
+  if (myCompact) {
+    scaleDiffusion(mVector<double>(n, 1.0));
+    return;
+  }
+
+  myDLow.resize(n);
+  myDDiag.resize(n);
+  myDUp.resize(n);
+  myRLow.resize(n);
+  myRDiag.resize(n);
+  myRUp.resize(n);
+
+  for (int i = 0; i < n; ++i) {
+    const double a = coeffs.a[i];
+    const double b = coeffs.b[i];
+    myDLow[i] = a * myX.d2Minus(i);
+    myDDiag[i] = a * myX.d2Centre(i);
+    myDUp[i] = a * myX.d2Plus(i);
+    myRLow[i] = b * myX.d1Minus(i);
+    myRDiag[i] = b * myX.d1Centre(i) + coeffs.r[i];
+    myRUp[i] = b * myX.d1Plus(i);
+  }
+
+  //	dirichlet sides: zero rows so the value keeps its initial condition
+  auto zero = [&](int i) {
+    myDLow[i] = myDDiag[i] = myDUp[i] = 0.0;
+    myRLow[i] = myRDiag[i] = myRUp[i] = 0.0;
+  };
+  if (myLower == FdmBoundary::Dirichlet) zero(0);
+  if (myUpper == FdmBoundary::Dirichlet) zero(n - 1);
+
+  scaleDiffusion(mVector<double>(n, 1.0));
+}
+
+void FdmOperator1d::scaleDiffusion(const mVector<double>& scale,
+                                   double discount) {
+  const int n = size();
+  if (myCompact) {
+    mVector<double> a(n), r(n);
+    for (int i = 0; i < n; ++i) {
+      a[i] = scale[i] * myCoeffs.a[i];
+      r[i] = myCoeffs.r[i] - discount;
+    }
+    compactStencil(myX, a, myCoeffs.b, r, myMass, myMatrix);
+
+    //	dirichlet sides: zero rows, M = I there
+    auto zero = [&](int i) {
+      myMatrix.lower(i) = myMatrix.diag(i) = myMatrix.upper(i) = 0.0;
+    };
+    if (myLower == FdmBoundary::Dirichlet) zero(0);
+    if (myUpper == FdmBoundary::Dirichlet) zero(n - 1);
+
+    ++myVersion;
+    return;
+  }
+
+  myMatrix.resize(n);
+
+  for (int i = 0; i < n; ++i) {
+    const double s = scale[i];
+    myMatrix.lower(i) = s * myDLow[i] + myRLow[i];
+    myMatrix.diag(i) = s * myDDiag[i] + myRDiag[i] - discount;
+    myMatrix.upper(i) = s * myDUp[i] + myRUp[i];
+  }
+
+  //	upwind and fitted rows from the scaled coefficients
+  for (int i = 0; i < (int)myConvection.size(); ++i) {
+    if (myConvection[i] == FdmConvection::Central || frozen(i)) continue;
+    myX.stencil(i, scale[i] * myCoeffs.a[i], myCoeffs.b[i], myConvection[i],
+                myMatrix.lower(i), myMatrix.diag(i), myMatrix.upper(i));
+    myMatrix.diag(i) += myCoeffs.r[i] - discount;
+  }
+
+  //	frozen dirichlet rows are not discounted either
+  if (discount != 0.0) {
+    if (myLower == FdmBoundary::Dirichlet) myMatrix.diag(0) = 0.0;
+    if (myUpper == FdmBoundary::Dirichlet) myMatrix.diag(n - 1) = 0.0;
+  }
+
+  ++myVersion;
+}
+
+void FdmOperator1d::applyDiffusion(const mVector<double>& z,
+                                   mVector<double>& res) const {
+  const int n = size();
+  res.resize(n);
+  for (int i = 0; i < n; ++i) {
+    double v = myDDiag[i] * z[i];
+    if (i > 0) v += myDLow[i] * z[i - 1];
+    if (i < n - 1) v += myDUp[i] * z[i + 1];
+    res[i] = v;
+  }
+}
+
+void FdmOperator1d::implicitMatrix(double thetaDt,
+                                   Tridiagonal<double>& res) const {
+  const int n = size();
+  res.resize(n);
+  for (int i = 0; i < n; ++i) {
+    res.lower(i) = myMass.lower(i) - thetaDt * myMatrix.lower(i);
+    res.diag(i) = myMass.diag(i) - thetaDt * myMatrix.diag(i);
+    res.upper(i) = myMass.upper(i) - thetaDt * myMatrix.upper(i);
+  }
+  res.factorize();
+}
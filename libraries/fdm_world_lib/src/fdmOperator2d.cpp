@@ -0,0 +1,825 @@
+#include "fdmOperator2d.hpp"
+
+#include "fdmOperator1d.hpp"
+
+FdmOperator2d::FdmOperator2d(const FdmGrid& x, const FdmGrid& y)
+    : myX(x), myY(y) {}
+
+void FdmOperator2d::setBoundaries(FdmBoundary xLower, FdmBoundary xUpper,
+                                  FdmBoundary yLower, FdmBoundary yUpper) {
+  myXLower = xLower;
+  myXUpper = xUpper;
+  myYLower = yLower;
+  myYUpper = yUpper;
+}
+
+void FdmOperator2d::setConvection(FdmConvection scheme, double xMin,
+                                  double xMax, double yMin, double yMax) {
+  const int nx = xSize();
+  const int ny = ySize();
+  if (myConvection.empty())
+    myConvection.assign(nx * ny, FdmConvection::Central);
+  for (int i = 0; i < nx; ++i) {
+    if (myX[i] < xMin || myX[i] > xMax) continue;
+    for (int j = 0; j < ny; ++j)
+      if (myY[j] >= yMin && myY[j] <= yMax) myConvection[i * ny + j] = scheme;
+  }
+}
+
+void FdmOperator2d::assemble(const FdmCoefficients2d& coeffs) {
+  const int nx = xSize();
+  const int ny = ySize();
+
+  myXLow.resize(nx, ny);
+  myXDiag.resize(nx, ny);
+  myXUp.resize(nx, ny);
+  myYLow.resize(nx, ny);
+  myYDiag.resize(nx, ny);
+  myYUp.resize(nx, ny);
+  myMixed.resize(nx, ny);
+  myFrozen.resize(nx, ny);
+
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      const double axx = coeffs.axx(i, j);
+      const double ayy = coeffs.ayy(i, j);
+      const double bx = coeffs.bx(i, j);
+      const double by = coeffs.by(i, j);
+      const double r = 0.5 * coeffs.r(i, j);
+
+      myXLow(i, j) = axx * myX.d2Minus(i) + bx * myX.d1Minus(i);
+      myXDiag(i, j) = axx * myX.d2Centre(i) + bx * myX.d1Centre(i) + r;
+      myXUp(i, j) = axx * myX.d2Plus(i) + bx * myX.d1Plus(i);
+
+      myYLow(i, j) = ayy * myY.d2Minus(j) + by * myY.d1Minus(j);
+      myYDiag(i, j) = ayy * myY.d2Centre(j) + by * myY.d1Centre(j) + r;
+      myYUp(i, j) = ayy * myY.d2Plus(j) + by * myY.d1Plus(j);
+
+      //	upwind or fitted rows
+      const FdmConvection scheme = myConvection.empty()
+                                       ? FdmConvection::Central
+                                       : myConvection[i * ny + j];
+      if (scheme != FdmConvection::Central) {
+        myX.stencil(i, axx, bx, scheme, myXLow(i, j), myXDiag(i, j),
+                    myXUp(i, j));
+        myXDiag(i, j) += r;
+        myY.stencil(j, ayy, by, scheme, myYLow(i, j), myYDiag(i, j),
+                    myYUp(i, j));
+        myYDiag(i, j) += r;
+      }
+
+      const bool interior = i > 0 && i < nx - 1 && j > 0 && j < ny - 1;
+      myMixed(i, j) = interior ? coeffs.axy(i, j) : 0.0;
+      myFrozen(i, j) = 0.0;
+    }
+  }
+
+  //	dirichlet sides: zero rows so the value keeps its initial condition
+  auto freeze = [&](int i, int j) {
+    myXLow(i, j) = myXDiag(i, j) = myXUp(i, j) = 0.0;
+    myYLow(i, j) = myYDiag(i, j) = myYUp(i, j) = 0.0;
+    myFrozen(i, j) = 1.0;
+  };
+  for (int j = 0; j < ny; ++j) {
+    if (myXLower == FdmBoundary::Dirichlet) freeze(0, j);
+    if (myXUpper == FdmBoundary::Dirichlet) freeze(nx - 1, j);
+  }
+  for (int i = 0; i < nx; ++i) {
+    if (myYLower == FdmBoundary::Dirichlet) freeze(i, 0);
+    if (myYUpper == FdmBoundary::Dirichlet) freeze(i, ny - 1);
+  }
+
+  if (myCompact) assembleCompact(coeffs);
+}
+
+void FdmOperator2d::assembleCompact(const FdmCoefficients2d& coeffs) {
+  const int nx = xSize();
+  const int ny = ySize();
+  for (auto* m : {&myXMassLow, &myXMassDiag, &myXMassUp, &myYMassLow,
+                  &myYMassDiag, &myYMassUp, &myXMassPivots, &myXMassUppers,
+                  &myYMassPivots, &myYMassUppers})
+    m->resize(nx, ny);
+
+  Tridiagonal<double> mass, k;
+
+  //	x lines, frozen nodes keep M = I and zero rows
+  mVector<double> a(nx), b(nx), r(nx);
+  for (int j = 0; j < ny; ++j) {
+    for (int i = 0; i < nx; ++i) {
+      a[i] = coeffs.axx(i, j);
+      b[i] = coeffs.bx(i, j);
+      r[i] = 0.5 * coeffs.r(i, j);
+    }
+    FdmOperator1d::compactStencil(myX, a, b, r, mass, k);
+    for (int i = 0; i < nx; ++i) {
+      const bool frozen = myFrozen(i, j) != 0.0;
+      myXMassLow(i, j) = frozen ? 0.0 : mass.lower(i);
+      myXMassDiag(i, j) = frozen ? 1.0 : mass.diag(i);
+      myXMassUp(i, j) = frozen ? 0.0 : mass.upper(i);
+      myXLow(i, j) = frozen ? 0.0 : k.lower(i);
+      myXDiag(i, j) = frozen ? 0.0 : k.diag(i);
+      myXUp(i, j) = frozen ? 0.0 : k.upper(i);
+    }
+  }
+
+  //	y lines
+  a.resize(ny);
+  b.resize(ny);
+  r.resize(ny);
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      a[j] = coeffs.ayy(i, j);
+      b[j] = coeffs.by(i, j);
+      r[j] = 0.5 * coeffs.r(i, j);
+    }
+    FdmOperator1d::compactStencil(myY, a, b, r, mass, k);
+    for (int j = 0; j < ny; ++j) {
+      const bool frozen = myFrozen(i, j) != 0.0;
+      myYMassLow(i, j) = frozen ? 0.0 : mass.lower(j);
+      myYMassDiag(i, j) = frozen ? 1.0 : mass.diag(j);
+      myYMassUp(i, j) = frozen ? 0.0 : mass.upper(j);
+      myYLow(i, j) = frozen ? 0.0 : k.lower(j);
+      myYDiag(i, j) = frozen ? 0.0 : k.diag(j);
+      myYUp(i, j) = frozen ? 0.0 : k.upper(j);
+    }
+  }
+
+  //	mixed term on the index grids, u_xy = u_ij / (x'(i) y'(j))
+  mVector<double> xd1, xd2, yd1, yd2;
+  myX.mapDerivatives(xd1, xd2);
+  myY.mapDerivatives(yd1, yd2);
+  for (int i = 0; i < nx; ++i)
+    for (int j = 0; j < ny; ++j) myMixed(i, j) /= xd1[i] * yd1[j];
+
+  //	Thomas factors of the masses
+  for (int j = 0; j < ny; ++j) {
+    myXMassPivots(0, j) = 1.0 / myXMassDiag(0, j);
+    myXMassUppers(0, j) = myXMassUp(0, j) * myXMassPivots(0, j);
+  }
+  for (int i = 1; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      myXMassPivots(i, j) = 1.0 / (myXMassDiag(i, j) -
+                                   myXMassLow(i, j) * myXMassUppers(i - 1, j));
+      myXMassUppers(i, j) = myXMassUp(i, j) * myXMassPivots(i, j);
+    }
+  }
+  for (int i = 0; i < nx; ++i) {
+    myYMassPivots(i, 0) = 1.0 / myYMassDiag(i, 0);
+    myYMassUppers(i, 0) = myYMassUp(i, 0) * myYMassPivots(i, 0);
+    for (int j = 1; j < ny; ++j) {
+      myYMassPivots(i, j) = 1.0 / (myYMassDiag(i, j) -
+                                   myYMassLow(i, j) * myYMassUppers(i, j - 1));
+      myYMassUppers(i, j) = myYMassUp(i, j) * myYMassPivots(i, j);
+    }
+  }
+}
+
+void FdmOperator2d::applyMixed(const mMatrix<double>& u,
+                               mMatrix<double>& out) const {
+  out.resize(xSize(), ySize());
+  applyMixed(u, out, 0, xSize());
+}
+
+void FdmOperator2d::applyX(const mMatrix<double>& u,
+                           mMatrix<double>& out) const {
+  out.resize(xSize(), ySize());
+  applyX(u, out, 0, xSize());
+  if (myCompact) {
+    mMatrix<double> scratch(xSize(), lineBlock);
+    massSolveX(out, 0, ySize(), scratch);
+  }
+}
+
+void FdmOperator2d::applyY(const mMatrix<double>& u,
+                           mMatrix<double>& out) const {
+  out.resize(xSize(), ySize());
+  applyY(u, out, 0, xSize());
+  if (myCompact) massSolveY(out, 0, xSize());
+}
+
+void FdmOperator2d::applyMixed(const mMatrix<double>& u, mMatrix<double>& out,
+                               int iBegin, int iEnd) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  if (myCompact) {
+    applyMixedCompact(u, out, iBegin, iEnd);
+    return;
+  }
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    double* o = &out(i, 0);
+    if (i == 0 || i == nx - 1) {
+      for (int j = 0; j < ny; ++j) o[j] = 0.0;
+      continue;
+    }
+
+    const double wxm = myX.d1Minus(i);
+    const double wxc = myX.d1Centre(i);
+    const double wxp = myX.d1Plus(i);
+    const double* um = &u(i - 1, 0);
+    const double* uc = &u(i, 0);
+    const double* up = &u(i + 1, 0);
+    const double* m = &myMixed(i, 0);
+
+    o[0] = o[ny - 1] = 0.0;
+    for (int j = 1; j < ny - 1; ++j) {
+      //	d/dx on the three columns j-1, j, j+1 then d/dy
+      const double dxm = wxm * um[j - 1] + wxc * uc[j - 1] + wxp * up[j - 1];
+      const double dxc = wxm * um[j] + wxc * uc[j] + wxp * up[j];
+      const double dxp = wxm * um[j + 1] + wxc * uc[j + 1] + wxp * up[j + 1];
+      o[j] = m[j] *
+             (myY.d1Minus(j) * dxm + myY.d1Centre(j) * dxc +
+              myY.d1Plus(j) * dxp);
+    }
+  }
+}
+
+void FdmOperator2d::stencil(vector<mMatrix<double>>& res) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  res.resize(9);
+  for (mMatrix<double>& s : res) {
+    s.resize(nx, ny, 0.0);
+    s = 0.0;
+  }
+
+  for (int i = 0; i < nx; ++i)
+    for (int j = 0; j < ny; ++j) {
+      if (myFrozen(i, j) != 0.0) continue;
+      res[1](i, j) = myXLow(i, j);
+      res[4](i, j) = myXDiag(i, j) + myYDiag(i, j);
+      res[7](i, j) = myXUp(i, j);
+      res[3](i, j) = myYLow(i, j);
+      res[5](i, j) = myYUp(i, j);
+
+      const double m = myMixed(i, j);
+      if (m == 0.0) continue;
+      const double wx[3] = {myX.d1Minus(i), myX.d1Centre(i), myX.d1Plus(i)};
+      const double wy[3] = {myY.d1Minus(j), myY.d1Centre(j), myY.d1Plus(j)};
+      for (int a = 0; a < 3; ++a)
+        for (int b = 0; b < 3; ++b) res[3 * a + b](i, j) += m * wx[a] * wy[b];
+    }
+}
+
+void FdmOperator2d::applyMixedCompact(const mMatrix<double>& u,
+                                      mMatrix<double>& out, int iBegin,
+                                      int iEnd) const {
+  const int nx = xSize();
+  const int ny = ySize();
+
+  //	index derivatives, five points inside and three next to the ends
+  auto dx = [&](int i, int j) {
+    if (i >= 2 && i <= nx - 3)
+      return (u(i - 2, j) - 8.0 * u(i - 1, j) + 8.0 * u(i + 1, j) -
+              u(i + 2, j)) /
+             12.0;
+    return 0.5 * (u(i + 1, j) - u(i - 1, j));
+  };
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    double* o = &out(i, 0);
+    if (i == 0 || i == nx - 1) {
+      for (int j = 0; j < ny; ++j) o[j] = 0.0;
+      continue;
+    }
+
+    //	window of d/dx on the columns j - 2 .. j + 2
+    const double* m = &myMixed(i, 0);
+    double w[5] = {0.0, dx(i, 0), dx(i, 1), dx(i, 2), 0.0};
+    o[0] = o[ny - 1] = 0.0;
+    for (int j = 1; j < ny - 1; ++j) {
+      w[4] = j + 2 < ny ? dx(i, j + 2) : 0.0;
+      const double d = j >= 2 && j <= ny - 3
+                           ? (w[0] - 8.0 * w[1] + 8.0 * w[3] - w[4]) / 12.0
+                           : 0.5 * (w[3] - w[1]);
+      o[j] = m[j] * d;
+      for (int k = 0; k < 4; ++k) w[k] = w[k + 1];
+    }
+  }
+}
+
+void FdmOperator2d::applyX(const mMatrix<double>& u, mMatrix<double>& out,
+                           int iBegin, int iEnd) const {
+  const int nx = xSize();
+  const int ny = ySize();
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    const double* l = &myXLow(i, 0);
+    const double* d = &myXDiag(i, 0);
+    const double* h = &myXUp(i, 0);
+    const double* uc = &u(i, 0);
+    double* o = &out(i, 0);
+
+    for (int j = 0; j < ny; ++j) o[j] = d[j] * uc[j];
+    if (i > 0) {
+      const double* um = &u(i - 1, 0);
+      for (int j = 0; j < ny; ++j) o[j] += l[j] * um[j];
+    }
+    if (i < nx - 1) {
+      const double* up = &u(i + 1, 0);
+      for (int j = 0; j < ny; ++j) o[j] += h[j] * up[j];
+    }
+  }
+}
+
+void FdmOperator2d::applyY(const mMatrix<double>& u, mMatrix<double>& out,
+                           int iBegin, int iEnd) const {
+  const int ny = ySize();
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    const double* l = &myYLow(i, 0);
+    const double* d = &myYDiag(i, 0);
+    const double* h = &myYUp(i, 0);
+    const double* uc = &u(i, 0);
+    double* o = &out(i, 0);
+
+    o[0] = d[0] * uc[0] + h[0] * uc[1];
+    for (int j = 1; j < ny - 1; ++j)
+      o[j] = l[j] * uc[j - 1] + d[j] * uc[j] + h[j] * uc[j + 1];
+    o[ny - 1] = l[ny - 1] * uc[ny - 2] + d[ny - 1] * uc[ny - 1];
+  }
+}
+
+void FdmOperator2d::factorize(double thetaDt, FdmLineFactors& factors) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  factors.thetaDt = thetaDt;
+  if (myCompact) {
+    factorizeCompact(thetaDt, factors);
+    return;
+  }
+
+  //	x lines: the recursion runs down the rows, all columns at once
+  mMatrix<double>& xp = factors.xPivots;
+  mMatrix<double>& xu = factors.xUppers;
+  xp.resize(nx, ny);
+  xu.resize(nx, ny);
+  for (int j = 0; j < ny; ++j) {
+    xp(0, j) = 1.0 / (1.0 - thetaDt * myXDiag(0, j));
+    xu(0, j) = -thetaDt * myXUp(0, j) * xp(0, j);
+  }
+  for (int i = 1; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      const double low = -thetaDt * myXLow(i, j);
+      xp(i, j) =
+          1.0 / (1.0 - thetaDt * myXDiag(i, j) - low * xu(i - 1, j));
+      xu(i, j) = -thetaDt * myXUp(i, j) * xp(i, j);
+    }
+  }
+
+  //	y lines: one recursion per row
+  mMatrix<double>& yp = factors.yPivots;
+  mMatrix<double>& yu = factors.yUppers;
+  yp.resize(nx, ny);
+  yu.resize(nx, ny);
+  for (int i = 0; i < nx; ++i) {
+    yp(i, 0) = 1.0 / (1.0 - thetaDt * myYDiag(i, 0));
+    yu(i, 0) = -thetaDt * myYUp(i, 0) * yp(i, 0);
+    for (int j = 1; j < ny; ++j) {
+      const double low = -thetaDt * myYLow(i, j);
+      yp(i, j) =
+          1.0 / (1.0 - thetaDt * myYDiag(i, j) - low * yu(i, j - 1));
+      yu(i, j) = -thetaDt * myYUp(i, j) * yp(i, j);
+    }
+  }
+}
+
+void FdmOperator2d::solveX(const FdmLineFactors& factors,
+                           mMatrix<double>& u) const {
+  mMatrix<double> scratch(xSize(), lineBlock);
+  solveX(factors, u, 0, ySize(), scratch);
+}
+
+void FdmOperator2d::solveY(const FdmLineFactors& factors,
+                           mMatrix<double>& u) const {
+  solveY(factors, u, 0, xSize());
+}
+
+void FdmOperator2d::solveX(const FdmLineFactors& factors, mMatrix<double>& u,
+                           int jBegin, int jEnd, mMatrix<double>& scratch,
+                           int offset) const {
+  const int nx = xSize();
+  const double thetaDt = factors.thetaDt;
+  if (myCompact) {
+    solveXCompact(factors, u, jBegin, jEnd, scratch, offset);
+    return;
+  }
+
+  for (int j0 = jBegin; j0 < jEnd; j0 += lineBlock) {
+    const int w = min(lineBlock, jEnd - j0);
+
+    //	forward elimination from u into the scratch block
+    {
+      const double* p = &factors.xPivots(0, j0);
+      const double* uc = &u(0, j0 - offset);
+      double* s = &scratch(0, 0);
+      for (int k = 0; k < w; ++k) s[k] = uc[k] * p[k];
+    }
+    for (int i = 1; i < nx; ++i) {
+      const double* l = &myXLow(i, j0);
+      const double* p = &factors.xPivots(i, j0);
+      const double* uc = &u(i, j0 - offset);
+      const double* sm = &scratch(i - 1, 0);
+      double* s = &scratch(i, 0);
+      for (int k = 0; k < w; ++k)
+        s[k] = (uc[k] + thetaDt * l[k] * sm[k]) * p[k];
+    }
+
+    //	back substitution from the scratch block into u
+    {
+      const double* s = &scratch(nx - 1, 0);
+      double* uc = &u(nx - 1, j0 - offset);
+      for (int k = 0; k < w; ++k) uc[k] = s[k];
+    }
+    for (int i = nx - 2; i >= 0; --i) {
+      const double* q = &factors.xUppers(i, j0);
+      const double* s = &scratch(i, 0);
+      const double* up = &u(i + 1, j0 - offset);
+      double* uc = &u(i, j0 - offset);
+      for (int k = 0; k < w; ++k) uc[k] = s[k] - q[k] * up[k];
+    }
+  }
+}
+
+void FdmOperator2d::solveY(const FdmLineFactors& factors, mMatrix<double>& u,
+                           int iBegin, int iEnd) const {
+  const int ny = ySize();
+  const double thetaDt = factors.thetaDt;
+  if (myCompact) {
+    solveYCompact(factors, u, iBegin, iEnd);
+    return;
+  }
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    const double* l = &myYLow(i, 0);
+    const double* p = &factors.yPivots(i, 0);
+    const double* q = &factors.yUppers(i, 0);
+    double* uc = &u(i, 0);
+
+    uc[0] *= p[0];
+    for (int j = 1; j < ny; ++j)
+      uc[j] = (uc[j] + thetaDt * l[j] * uc[j - 1]) * p[j];
+    for (int j = ny - 2; j >= 0; --j) uc[j] -= q[j] * uc[j + 1];
+  }
+}
+
+void FdmOperator2d::factorizeCompact(double thetaDt,
+                                     FdmLineFactors& factors) const {
+  const int nx = xSize();
+  const int ny = ySize();
+
+  //	M - thetaDt K on the x lines, down the rows
+  mMatrix<double>& xp = factors.xPivots;
+  mMatrix<double>& xu = factors.xUppers;
+  xp.resize(nx, ny);
+  xu.resize(nx, ny);
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      const double low = myXMassLow(i, j) - thetaDt * myXLow(i, j);
+      const double prev = i > 0 ? low * xu(i - 1, j) : 0.0;
+      xp(i, j) =
+          1.0 / (myXMassDiag(i, j) - thetaDt * myXDiag(i, j) - prev);
+      xu(i, j) = (myXMassUp(i, j) - thetaDt * myXUp(i, j)) * xp(i, j);
+    }
+  }
+
+  //	y lines
+  mMatrix<double>& yp = factors.yPivots;
+  mMatrix<double>& yu = factors.yUppers;
+  yp.resize(nx, ny);
+  yu.resize(nx, ny);
+  for (int i = 0; i < nx; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      const double low = myYMassLow(i, j) - thetaDt * myYLow(i, j);
+      const double prev = j > 0 ? low * yu(i, j - 1) : 0.0;
+      yp(i, j) =
+          1.0 / (myYMassDiag(i, j) - thetaDt * myYDiag(i, j) - prev);
+      yu(i, j) = (myYMassUp(i, j) - thetaDt * myYUp(i, j)) * yp(i, j);
+    }
+  }
+}
+
+void FdmOperator2d::solveXCompact(const FdmLineFactors& factors,
+                                  mMatrix<double>& u, int jBegin, int jEnd,
+                                  mMatrix<double>& scratch, int offset) const {
+  const int nx = xSize();
+  const double thetaDt = factors.thetaDt;
+
+  //	(I - thetaDt M^-1 K) y = u is (M - thetaDt K) y = M u, the right hand
+  //	side is formed in the forward elimination
+  for (int j0 = jBegin; j0 < jEnd; j0 += lineBlock) {
+    const int w = min(lineBlock, jEnd - j0);
+
+    for (int i = 0; i < nx; ++i) {
+      const double* ml = &myXMassLow(i, j0);
+      const double* md = &myXMassDiag(i, j0);
+      const double* mu = &myXMassUp(i, j0);
+      const double* l = &myXLow(i, j0);
+      const double* p = &factors.xPivots(i, j0);
+      const double* um = &u(max(i - 1, 0), j0 - offset);
+      const double* uc = &u(i, j0 - offset);
+      const double* up = &u(min(i + 1, nx - 1), j0 - offset);
+      const double* sm = &scratch(max(i - 1, 0), 0);
+      double* s = &scratch(i, 0);
+      for (int k = 0; k < w; ++k) {
+        double rhs = md[k] * uc[k];
+        if (i > 0) rhs += ml[k] * um[k] - (ml[k] - thetaDt * l[k]) * sm[k];
+        if (i < nx - 1) rhs += mu[k] * up[k];
+        s[k] = rhs * p[k];
+      }
+    }
+
+    {
+      const double* s = &scratch(nx - 1, 0);
+      double* uc = &u(nx - 1, j0 - offset);
+      for (int k = 0; k < w; ++k) uc[k] = s[k];
+    }
+    for (int i = nx - 2; i >= 0; --i) {
+      const double* q = &factors.xUppers(i, j0);
+      const double* s = &scratch(i, 0);
+      const double* up = &u(i + 1, j0 - offset);
+      double* uc = &u(i, j0 - offset);
+      for (int k = 0; k < w; ++k) uc[k] = s[k] - q[k] * up[k];
+    }
+  }
+}
+
+void FdmOperator2d::solveYCompact(const FdmLineFactors& factors,
+                                  mMatrix<double>& u, int iBegin,
+                                  int iEnd) const {
+  const int ny = ySize();
+  const double thetaDt = factors.thetaDt;
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    const double* ml = &myYMassLow(i, 0);
+    const double* md = &myYMassDiag(i, 0);
+    const double* mu = &myYMassUp(i, 0);
+    const double* l = &myYLow(i, 0);
+    const double* p = &factors.yPivots(i, 0);
+    const double* q = &factors.yUppers(i, 0);
+    double* uc = &u(i, 0);
+
+    //	M u formed on the fly, the previous value is kept before it is
+    //	overwritten
+    double prev = uc[0];
+    uc[0] = (md[0] * uc[0] + (ny > 1 ? mu[0] * uc[1] : 0.0)) * p[0];
+    for (int j = 1; j < ny; ++j) {
+      const double cur = uc[j];
+      double rhs = ml[j] * prev + md[j] * cur;
+      if (j < ny - 1) rhs += mu[j] * uc[j + 1];
+      uc[j] = (rhs - (ml[j] - thetaDt * l[j]) * uc[j - 1]) * p[j];
+      prev = cur;
+    }
+    for (int j = ny - 2; j >= 0; --j) uc[j] -= q[j] * uc[j + 1];
+  }
+}
+
+void FdmOperator2d::massSolveX(mMatrix<double>& u, int jBegin, int jEnd,
+                               mMatrix<double>& scratch, int offset) const {
+  const int nx = xSize();
+  for (int j0 = jBegin; j0 < jEnd; j0 += lineBlock) {
+    const int w = min(lineBlock, jEnd - j0);
+
+    for (int i = 0; i < nx; ++i) {
+      const double* l = &myXMassLow(i, j0);
+      const double* p = &myXMassPivots(i, j0);
+      const double* uc = &u(i, j0 - offset);
+      const double* sm = &scratch(max(i - 1, 0), 0);
+      double* s = &scratch(i, 0);
+      for (int k = 0; k < w; ++k)
+        s[k] = (uc[k] - (i > 0 ? l[k] * sm[k] : 0.0)) * p[k];
+    }
+
+    {
+      const double* s = &scratch(nx - 1, 0);
+      double* uc = &u(nx - 1, j0 - offset);
+      for (int k = 0; k < w; ++k) uc[k] = s[k];
+    }
+    for (int i = nx - 2; i >= 0; --i) {
+      const double* q = &myXMassUppers(i, j0);
+      const double* s = &scratch(i, 0);
+      const double* up = &u(i + 1, j0 - offset);
+      double* uc = &u(i, j0 - offset);
+      for (int k = 0; k < w; ++k) uc[k] = s[k] - q[k] * up[k];
+    }
+  }
+}
+
+void FdmOperator2d::massSolveY(mMatrix<double>& u, int iBegin,
+                               int iEnd) const {
+  const int ny = ySize();
+  for (int i = iBegin; i < iEnd; ++i) {
+    const double* l = &myYMassLow(i, 0);
+    const double* p = &myYMassPivots(i, 0);
+    const double* q = &myYMassUppers(i, 0);
+    double* uc = &u(i, 0);
+
+    uc[0] *= p[0];
+    for (int j = 1; j < ny; ++j) uc[j] = (uc[j] - l[j] * uc[j - 1]) * p[j];
+    for (int j = ny - 2; j >= 0; --j) uc[j] -= q[j] * uc[j + 1];
+  }
+}
+
+void FdmOperator2d::applyMixedTranspose(const mMatrix<double>& u,
+                                        mMatrix<double>& out) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  out.resize(nx, ny);
+
+  //	g = m u on the interior, then out(i, j) gathers g from its neighbours
+  //	with the weights of the neighbours' stencils
+  mMatrix<double> g(nx, ny, 0.0);
+  for (int i = 1; i < nx - 1; ++i)
+    for (int j = 1; j < ny - 1; ++j) g(i, j) = myMixed(i, j) * u(i, j);
+
+  //	along y first: h(i, j) = sum_c wy_c(j + 1 - c) g(i, j + 1 - c)
+  mMatrix<double> h(nx, ny, 0.0);
+  for (int i = 1; i < nx - 1; ++i) {
+    const double* gc = &g(i, 0);
+    double* hc = &h(i, 0);
+    for (int j = 0; j < ny; ++j) {
+      double r = 0.0;
+      if (j > 0) r += myY.d1Plus(j - 1) * gc[j - 1];
+      r += myY.d1Centre(j) * gc[j];
+      if (j < ny - 1) r += myY.d1Minus(j + 1) * gc[j + 1];
+      hc[j] = r;
+    }
+  }
+
+  for (int i = 0; i < nx; ++i) {
+    double* o = &out(i, 0);
+    const double* hc = &h(i, 0);
+    for (int j = 0; j < ny; ++j) o[j] = myX.d1Centre(i) * hc[j];
+    if (i > 0) {
+      const double w = myX.d1Plus(i - 1);
+      const double* hm = &h(i - 1, 0);
+      for (int j = 0; j < ny; ++j) o[j] += w * hm[j];
+    }
+    if (i < nx - 1) {
+      const double w = myX.d1Minus(i + 1);
+      const double* hp = &h(i + 1, 0);
+      for (int j = 0; j < ny; ++j) o[j] += w * hp[j];
+    }
+  }
+}
+
+void FdmOperator2d::applyXTranspose(const mMatrix<double>& u,
+                                    mMatrix<double>& out) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  out.resize(nx, ny);
+
+  for (int i = 0; i < nx; ++i) {
+    const double* d = &myXDiag(i, 0);
+    const double* uc = &u(i, 0);
+    double* o = &out(i, 0);
+
+    for (int j = 0; j < ny; ++j) o[j] = d[j] * uc[j];
+    if (i > 0) {
+      const double* h = &myXUp(i - 1, 0);
+      const double* um = &u(i - 1, 0);
+      for (int j = 0; j < ny; ++j) o[j] += h[j] * um[j];
+    }
+    if (i < nx - 1) {
+      const double* l = &myXLow(i + 1, 0);
+      const double* up = &u(i + 1, 0);
+      for (int j = 0; j < ny; ++j) o[j] += l[j] * up[j];
+    }
+  }
+}
+
+void FdmOperator2d::applyYTranspose(const mMatrix<double>& u,
+                                    mMatrix<double>& out) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  out.resize(nx, ny);
+
+  for (int i = 0; i < nx; ++i) {
+    const double* l = &myYLow(i, 0);
+    const double* d = &myYDiag(i, 0);
+    const double* h = &myYUp(i, 0);
+    const double* uc = &u(i, 0);
+    double* o = &out(i, 0);
+
+    o[0] = d[0] * uc[0] + l[1] * uc[1];
+    for (int j = 1; j < ny - 1; ++j)
+      o[j] = h[j - 1] * uc[j - 1] + d[j] * uc[j] + l[j + 1] * uc[j + 1];
+    o[ny - 1] = h[ny - 2] * uc[ny - 2] + d[ny - 1] * uc[ny - 1];
+  }
+}
+
+void FdmOperator2d::solveXTranspose(const FdmLineFactors& factors,
+                                    mMatrix<double>& u) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  const double thetaDt = factors.thetaDt;
+
+  //	the factors are L U with U unit upper: solve U^T then L^T, all
+  //	columns at once
+  for (int i = 1; i < nx; ++i) {
+    const double* q = &factors.xUppers(i - 1, 0);
+    const double* um = &u(i - 1, 0);
+    double* uc = &u(i, 0);
+    for (int j = 0; j < ny; ++j) uc[j] -= q[j] * um[j];
+  }
+  {
+    const double* p = &factors.xPivots(nx - 1, 0);
+    double* uc = &u(nx - 1, 0);
+    for (int j = 0; j < ny; ++j) uc[j] *= p[j];
+  }
+  for (int i = nx - 2; i >= 0; --i) {
+    const double* l = &myXLow(i + 1, 0);
+    const double* p = &factors.xPivots(i, 0);
+    const double* up = &u(i + 1, 0);
+    double* uc = &u(i, 0);
+    for (int j = 0; j < ny; ++j)
+      uc[j] = (uc[j] + thetaDt * l[j] * up[j]) * p[j];
+  }
+}
+
+void FdmOperator2d::solveYTranspose(const FdmLineFactors& factors,
+                                    mMatrix<double>& u) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  const double thetaDt = factors.thetaDt;
+
+  for (int i = 0; i < nx; ++i) {
+    const double* l = &myYLow(i, 0);
+    const double* p = &factors.yPivots(i, 0);
+    const double* q = &factors.yUppers(i, 0);
+    double* uc = &u(i, 0);
+
+    for (int j = 1; j < ny; ++j) uc[j] -= q[j - 1] * uc[j - 1];
+    uc[ny - 1] *= p[ny - 1];
+    for (int j = ny - 2; j >= 0; --j)
+      uc[j] = (uc[j] + thetaDt * l[j + 1] * uc[j + 1]) * p[j];
+  }
+}
+
+void FdmOperator2d::gradient(const mMatrix<double>& a,
+                             const mMatrix<double>& b, double w0, double w1,
+                             double w2, FdmCoefficients2d& res) const {
+  const int nx = xSize();
+  const int ny = ySize();
+
+  for (int i = 0; i < nx; ++i) {
+    const double* ac = &a(i, 0);
+    const double* bc = &b(i, 0);
+    const double* f = &myFrozen(i, 0);
+
+    //	x part, one sided at the ends as in applyX()
+    if (w1 != 0.0) {
+      const double* bm = i > 0 ? &b(i - 1, 0) : nullptr;
+      const double* bp = i < nx - 1 ? &b(i + 1, 0) : nullptr;
+      double* gxx = &res.axx(i, 0);
+      double* gx = &res.bx(i, 0);
+      double* gr = &res.r(i, 0);
+      for (int j = 0; j < ny; ++j) {
+        if (f[j] != 0.0) continue;
+        const double g = w1 * ac[j];
+        const double m = bm ? bm[j] : 0.0;
+        const double p = bp ? bp[j] : 0.0;
+        gxx[j] += g * (myX.d2Minus(i) * m + myX.d2Centre(i) * bc[j] +
+                       myX.d2Plus(i) * p);
+        gx[j] += g * (myX.d1Minus(i) * m + myX.d1Centre(i) * bc[j] +
+                      myX.d1Plus(i) * p);
+        gr[j] += 0.5 * g * bc[j];
+      }
+    }
+
+    //	y part, same as applyY()
+    if (w2 != 0.0) {
+      double* gyy = &res.ayy(i, 0);
+      double* gy = &res.by(i, 0);
+      double* gr = &res.r(i, 0);
+      for (int j = 0; j < ny; ++j) {
+        if (f[j] != 0.0) continue;
+        const double g = w2 * ac[j];
+        const double m = j > 0 ? bc[j - 1] : 0.0;
+        const double p = j < ny - 1 ? bc[j + 1] : 0.0;
+        gyy[j] += g * (myY.d2Minus(j) * m + myY.d2Centre(j) * bc[j] +
+                       myY.d2Plus(j) * p);
+        gy[j] += g * (myY.d1Minus(j) * m + myY.d1Centre(j) * bc[j] +
+                      myY.d1Plus(j) * p);
+        gr[j] += 0.5 * g * bc[j];
+      }
+    }
+
+    //	mixed part on the interior only
+    if (w0 == 0.0 || i == 0 || i == nx - 1) continue;
+    const double wxm = myX.d1Minus(i);
+    const double wxc = myX.d1Centre(i);
+    const double wxp = myX.d1Plus(i);
+    const double* bm = &b(i - 1, 0);
+    const double* bp = &b(i + 1, 0);
+    double* gxy = &res.axy(i, 0);
+    for (int j = 1; j < ny - 1; ++j) {
+      const double dxm = wxm * bm[j - 1] + wxc * bc[j - 1] + wxp * bp[j - 1];
+      const double dxc = wxm * bm[j] + wxc * bc[j] + wxp * bp[j];
+      const double dxp = wxm * bm[j + 1] + wxc * bc[j + 1] + wxp * bp[j + 1];
+      gxy[j] += w0 * ac[j] *
+                (myY.d1Minus(j) * dxm + myY.d1Centre(j) * dxc +
+                 myY.d1Plus(j) * dxp);
+    }
+  }
+}
@@ -0,0 +1,346 @@
+#include "fdmOperator3d.hpp"
+
+void FdmSeparable::line(int i, int j, int depth, double* res) const {
+  for (int k = 0; k < depth; ++k) res[k] = 0.0;
+  for (const Term& t : terms) {
+    const double s =
+        (t.x.empty() ? 1.0 : t.x[i]) * (t.y.empty() ? 1.0 : t.y[j]);
+    if (t.z.empty()) {
+      for (int k = 0; k < depth; ++k) res[k] += s;
+    } else {
+      for (int k = 0; k < depth; ++k) res[k] += s * t.z[k];
+    }
+  }
+}
+
+FdmOperator3d::FdmOperator3d(const FdmGrid& x, const FdmGrid& y,
+                             const FdmGrid& z)
+    : myX(x), myY(y), myZ(z) {}
+
+void FdmOperator3d::setBoundaries(FdmBoundary xLower, FdmBoundary xUpper,
+                                  FdmBoundary yLower, FdmBoundary yUpper,
+                                  FdmBoundary zLower, FdmBoundary zUpper) {
+  myXLower = xLower;
+  myXUpper = xUpper;
+  myYLower = yLower;
+  myYUpper = yUpper;
+  myZLower = zLower;
+  myZUpper = zUpper;
+}
+
+void FdmOperator3d::assemble(const FdmCoefficients3d& coeffs) {
+  myCoeffs = coeffs;
+}
+
+int FdmOperator3d::workSize() const {
+  //	10 coefficient lines and 4 difference lines for apply(), a line
+  //	block of uppers and 3 coefficient lines for the solves
+  return max(14, max(xSize(), ySize()) + 3) * zSize();
+}
+
+size_t FdmOperator3d::bytes() const {
+  //	7 vectors per grid
+  size_t res = 7 * (size_t)(xSize() + ySize() + zSize());
+  for (const FdmSeparable* c :
+       {&myCoeffs.axx, &myCoeffs.ayy, &myCoeffs.azz, &myCoeffs.axy,
+        &myCoeffs.axz, &myCoeffs.ayz, &myCoeffs.bx, &myCoeffs.by,
+        &myCoeffs.bz, &myCoeffs.r})
+    for (const FdmSeparable::Term& t : c->terms)
+      res += t.x.size() + t.y.size() + t.z.size();
+
+  //	done
+  return res * sizeof(double);
+}
+
+bool FdmOperator3d::frozen(int i, int j) const {
+  return (i == 0 && myXLower == FdmBoundary::Dirichlet) ||
+         (i == xSize() - 1 && myXUpper == FdmBoundary::Dirichlet) ||
+         (j == 0 && myYLower == FdmBoundary::Dirichlet) ||
+         (j == ySize() - 1 && myYUpper == FdmBoundary::Dirichlet);
+}
+
+void FdmOperator3d::directional(int i, int j, const FdmSeparable& a,
+                                const FdmSeparable& b, double* aLine,
+                                double* bLine, double* rLine) const {
+  const int nz = zSize();
+  if (frozen(i, j)) {
+    for (int k = 0; k < nz; ++k) aLine[k] = bLine[k] = rLine[k] = 0.0;
+    return;
+  }
+
+  a.line(i, j, nz, aLine);
+  b.line(i, j, nz, bLine);
+  myCoeffs.r.line(i, j, nz, rLine);
+  for (int k = 0; k < nz; ++k) rLine[k] *= 1.0 / 3.0;
+
+  if (myZLower == FdmBoundary::Dirichlet)
+    aLine[0] = bLine[0] = rLine[0] = 0.0;
+  if (myZUpper == FdmBoundary::Dirichlet)
+    aLine[nz - 1] = bLine[nz - 1] = rLine[nz - 1] = 0.0;
+}
+
+void FdmOperator3d::apply(const mCube<double>& u, const double* w,
+                          const mCube<double>& base, mCube<double>& out,
+                          int iBegin, int iEnd, double* work) const {
+  const int nx = xSize();
+  const int ny = ySize();
+  const int nz = zSize();
+
+  double* a = work;
+  double* b = a + nz;
+  double* r = b + nz;
+  double* axy = r + nz;
+  double* axz = axy + nz;
+  double* ayz = axz + nz;
+  double* dxm = ayz + nz;
+  double* dxc = dxm + nz;
+  double* dxp = dxc + nz;
+  double* dy = dxp + nz;
+
+  for (int i = iBegin; i < iEnd; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      const double* uc = &u(i, j, 0);
+      double* o = &out(i, j, 0);
+      if (&base != &out) {
+        const double* bc = &base(i, j, 0);
+        for (int k = 0; k < nz; ++k) o[k] = bc[k];
+      }
+
+      //	x, values of the neighbour slabs
+      if (w[1] != 0.0) {
+        directional(i, j, myCoeffs.axx, myCoeffs.bx, a, b, r);
+        const double w1 = w[1];
+        const double c2 = myX.d2Centre(i), c1 = myX.d1Centre(i);
+        for (int k = 0; k < nz; ++k)
+          o[k] += w1 * (a[k] * c2 + b[k] * c1 + r[k]) * uc[k];
+        if (i > 0) {
+          const double m2 = myX.d2Minus(i), m1 = myX.d1Minus(i);
+          const double* um = &u(i - 1, j, 0);
+          for (int k = 0; k < nz; ++k)
+            o[k] += w1 * (a[k] * m2 + b[k] * m1) * um[k];
+        }
+        if (i < nx - 1) {
+          const double p2 = myX.d2Plus(i), p1 = myX.d1Plus(i);
+          const double* up = &u(i + 1, j, 0);
+          for (int k = 0; k < nz; ++k)
+            o[k] += w1 * (a[k] * p2 + b[k] * p1) * up[k];
+        }
+      }
+
+      //	y, values of the neighbour lines in the slab
+      if (w[2] != 0.0) {
+        directional(i, j, myCoeffs.ayy, myCoeffs.by, a, b, r);
+        const double w2 = w[2];
+        const double c2 = myY.d2Centre(j), c1 = myY.d1Centre(j);
+        for (int k = 0; k < nz; ++k)
+          o[k] += w2 * (a[k] * c2 + b[k] * c1 + r[k]) * uc[k];
+        if (j > 0) {
+          const double m2 = myY.d2Minus(j), m1 = myY.d1Minus(j);
+          const double* um = &u(i, j - 1, 0);
+          for (int k = 0; k < nz; ++k)
+            o[k] += w2 * (a[k] * m2 + b[k] * m1) * um[k];
+        }
+        if (j < ny - 1) {
+          const double p2 = myY.d2Plus(j), p1 = myY.d1Plus(j);
+          const double* up = &u(i, j + 1, 0);
+          for (int k = 0; k < nz; ++k)
+            o[k] += w2 * (a[k] * p2 + b[k] * p1) * up[k];
+        }
+      }
+
+      //	z, along the line
+      if (w[3] != 0.0) {
+        directional(i, j, myCoeffs.azz, myCoeffs.bz, a, b, r);
+        const double w3 = w[3];
+        for (int k = 0; k < nz; ++k) {
+          double v = (a[k] * myZ.d2Centre(k) + b[k] * myZ.d1Centre(k) +
+                      r[k]) *
+                     uc[k];
+          if (k > 0)
+            v += (a[k] * myZ.d2Minus(k) + b[k] * myZ.d1Minus(k)) * uc[k - 1];
+          if (k < nz - 1)
+            v += (a[k] * myZ.d2Plus(k) + b[k] * myZ.d1Plus(k)) * uc[k + 1];
+          o[k] += w3 * v;
+        }
+      }
+
+      //	mixed, interior only
+      if (w[0] == 0.0 || i == 0 || i == nx - 1 || j == 0 || j == ny - 1)
+        continue;
+      myCoeffs.axy.line(i, j, nz, axy);
+      myCoeffs.axz.line(i, j, nz, axz);
+      myCoeffs.ayz.line(i, j, nz, ayz);
+
+      //	d/dx on the lines j-1, j, j+1 and d/dy on the line j
+      const double xm = myX.d1Minus(i), xc = myX.d1Centre(i);
+      const double xp = myX.d1Plus(i);
+      const double ym = myY.d1Minus(j), yc = myY.d1Centre(j);
+      const double yp = myY.d1Plus(j);
+      double* dx[3] = {dxm, dxc, dxp};
+      for (int c = 0; c < 3; ++c) {
+        const double* um = &u(i - 1, j - 1 + c, 0);
+        const double* uk = &u(i, j - 1 + c, 0);
+        const double* up = &u(i + 1, j - 1 + c, 0);
+        for (int k = 0; k < nz; ++k)
+          dx[c][k] = xm * um[k] + xc * uk[k] + xp * up[k];
+      }
+      {
+        const double* um = &u(i, j - 1, 0);
+        const double* up = &u(i, j + 1, 0);
+        for (int k = 0; k < nz; ++k)
+          dy[k] = ym * um[k] + yc * uc[k] + yp * up[k];
+      }
+
+      const double w0 = w[0];
+      for (int k = 1; k < nz - 1; ++k) {
+        const double zm = myZ.d1Minus(k), zc = myZ.d1Centre(k);
+        const double zp = myZ.d1Plus(k);
+        const double vxy = ym * dxm[k] + yc * dxc[k] + yp * dxp[k];
+        const double vxz = zm * dxc[k - 1] + zc * dxc[k] + zp * dxc[k + 1];
+        const double vyz = zm * dy[k - 1] + zc * dy[k] + zp * dy[k + 1];
+        o[k] += w0 * (axy[k] * vxy + axz[k] * vxz + ayz[k] * vyz);
+      }
+    }
+  }
+}
+
+void FdmOperator3d::solveX(double thetaDt, mCube<double>& u, int jBegin,
+                           int jEnd, double* work) const {
+  const int nx = xSize();
+  const int nz = zSize();
+
+  double* q = work;
+  double* a = q + nx * nz;
+  double* b = a + nz;
+  double* r = b + nz;
+
+  //	one block of nz lines per column j, the recursion runs down the slabs
+  //	with the factors computed on the way
+  for (int j = jBegin; j < jEnd; ++j) {
+    for (int i = 0; i < nx; ++i) {
+      directional(i, j, myCoeffs.axx, myCoeffs.bx, a, b, r);
+      const double m2 = myX.d2Minus(i), m1 = myX.d1Minus(i);
+      const double c2 = myX.d2Centre(i), c1 = myX.d1Centre(i);
+      const double p2 = myX.d2Plus(i), p1 = myX.d1Plus(i);
+      double* uc = &u(i, j, 0);
+      double* qc = q + i * nz;
+
+      if (i == 0) {
+        for (int k = 0; k < nz; ++k) {
+          const double p =
+              1.0 / (1.0 - thetaDt * (a[k] * c2 + b[k] * c1 + r[k]));
+          qc[k] = -thetaDt * (a[k] * p2 + b[k] * p1) * p;
+          uc[k] *= p;
+        }
+        continue;
+      }
+
+      const double* um = &u(i - 1, j, 0);
+      const double* qm = qc - nz;
+      const double up = i < nx - 1 ? 1.0 : 0.0;
+      for (int k = 0; k < nz; ++k) {
+        const double l = -thetaDt * (a[k] * m2 + b[k] * m1);
+        const double p = 1.0 / (1.0 - thetaDt * (a[k] * c2 + b[k] * c1 + r[k]) -
+                                l * qm[k]);
+        qc[k] = -up * thetaDt * (a[k] * p2 + b[k] * p1) * p;
+        uc[k] = (uc[k] - l * um[k]) * p;
+      }
+    }
+
+    for (int i = nx - 2; i >= 0; --i) {
+      const double* qc = q + i * nz;
+      const double* up = &u(i + 1, j, 0);
+      double* uc = &u(i, j, 0);
+      for (int k = 0; k < nz; ++k) uc[k] -= qc[k] * up[k];
+    }
+  }
+}
+
+void FdmOperator3d::solveY(double thetaDt, mCube<double>& u, int iBegin,
+                           int iEnd, double* work) const {
+  const int ny = ySize();
+  const int nz = zSize();
+
+  double* q = work;
+  double* a = q + ny * nz;
+  double* b = a + nz;
+  double* r = b + nz;
+
+  //	one slab at a time, the recursion runs down its lines
+  for (int i = iBegin; i < iEnd; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      directional(i, j, myCoeffs.ayy, myCoeffs.by, a, b, r);
+      const double m2 = myY.d2Minus(j), m1 = myY.d1Minus(j);
+      const double c2 = myY.d2Centre(j), c1 = myY.d1Centre(j);
+      const double p2 = myY.d2Plus(j), p1 = myY.d1Plus(j);
+      double* uc = &u(i, j, 0);
+      double* qc = q + j * nz;
+
+      if (j == 0) {
+        for (int k = 0; k < nz; ++k) {
+          const double p =
+              1.0 / (1.0 - thetaDt * (a[k] * c2 + b[k] * c1 + r[k]));
+          qc[k] = -thetaDt * (a[k] * p2 + b[k] * p1) * p;
+          uc[k] *= p;
+        }
+        continue;
+      }
+
+      const double* um = uc - nz;
+      const double* qm = qc - nz;
+      const double up = j < ny - 1 ? 1.0 : 0.0;
+      for (int k = 0; k < nz; ++k) {
+        const double l = -thetaDt * (a[k] * m2 + b[k] * m1);
+        const double p = 1.0 / (1.0 - thetaDt * (a[k] * c2 + b[k] * c1 + r[k]) -
+                                l * qm[k]);
+        qc[k] = -up * thetaDt * (a[k] * p2 + b[k] * p1) * p;
+        uc[k] = (uc[k] - l * um[k]) * p;
+      }
+    }
+
+    for (int j = ny - 2; j >= 0; --j) {
+      const double* qc = q + j * nz;
+      double* uc = &u(i, j, 0);
+      const double* up = uc + nz;
+      for (int k = 0; k < nz; ++k) uc[k] -= qc[k] * up[k];
+    }
+  }
+}
+
+void FdmOperator3d::solveZ(double thetaDt, mCube<double>& u, int iBegin,
+                           int iEnd, double* work) const {
+  const int ny = ySize();
+  const int nz = zSize();
+
+  double* q = work;
+  double* a = q + nz;
+  double* b = a + nz;
+  double* r = b + nz;
+
+  //	contiguous lines
+  for (int i = iBegin; i < iEnd; ++i) {
+    for (int j = 0; j < ny; ++j) {
+      directional(i, j, myCoeffs.azz, myCoeffs.bz, a, b, r);
+      double* uc = &u(i, j, 0);
+
+      double qm = 0.0;
+      for (int k = 0; k < nz; ++k) {
+        const double l =
+            k > 0 ? -thetaDt * (a[k] * myZ.d2Minus(k) + b[k] * myZ.d1Minus(k))
+                  : 0.0;
+        const double h =
+            k < nz - 1
+                ? -thetaDt * (a[k] * myZ.d2Plus(k) + b[k] * myZ.d1Plus(k))
+                : 0.0;
+        const double p =
+            1.0 / (1.0 -
+                   thetaDt * (a[k] * myZ.d2Centre(k) +
+                              b[k] * myZ.d1Centre(k) + r[k]) -
+                   l * qm);
+        qm = q[k] = h * p;
+        uc[k] = (uc[k] - (k > 0 ? l * uc[k - 1] : 0.0)) * p;
+      }
+      for (int k = nz - 2; k >= 0; --k) uc[k] -= q[k] * uc[k + 1];
+    }
+  }
+}
@@ -0,0 +1,59 @@
+#include "fdmTimeGrid.hpp"
+
+#include <cmath>
+
+#include "constants.hpp"
+
+FdmTimeGrid FdmTimeGrid::make(const mVector<double>& mandatory, int timeSteps,
+                              double theta, int dampingSteps) {
+  //	sorted positive mandatory times
+  vector<double> stops;
+  for (int k = 0; k < mandatory.size(); ++k)
+    if (mandatory[k] > 0.0) stops.push_back(mandatory[k]);
+  std::sort(stops.begin(), stops.end());
+  stops.erase(std::unique(stops.begin(), stops.end()), stops.end());
+
+  FdmTimeGrid res;
+  res.myTimes.push_back(0.0);
+  if (stops.empty()) return res;
+
+  //	equal steps between consecutive stops, about dt0 long
+  const double dt0 = stops.back() / max(timeSteps, 1);
+  double t0 = 0.0;
+  vector<double> times{0.0};
+  for (double t1 : stops) {
+    const int n = max(1, (int)std::ceil((t1 - t0) / dt0 - 1.0e-09));
+    for (int k = 1; k < n; ++k) times.push_back(t0 + (t1 - t0) * k / n);
+    times.push_back(t1);
+    t0 = t1;
+  }
+
+  //	damping half steps from t = 0
+  const int steps = (int)times.size() - 1;
+  dampingSteps = min(dampingSteps, steps);
+  for (int k = 0; k < steps; ++k) {
+    if (k < dampingSteps) {
+      res.myTimes.push_back(0.5 * (times[k] + times[k + 1]));
+      res.myThetas.push_back(1.0);
+      res.myTimes.push_back(times[k + 1]);
+      res.myThetas.push_back(1.0);
+    } else {
+      res.myTimes.push_back(times[k + 1]);
+      res.myThetas.push_back(theta);
+    }
+  }
+
+  //	done
+  return res;
+}
+
+int FdmTimeGrid::index(double t) const {
+  const auto& p = myTimes.data();
+  auto it = std::lower_bound(p.begin(), p.end(),
+                             t - Constants::epsilon() * max(1.0, t));
+  if (it == p.end() || fabs(*it - t) > Constants::epsilon() * max(1.0, t))
+    return -1;
+
+  //	done
+  return (int)(it - p.begin());
+}
@@ -0,0 +1,188 @@
+#include "fft.hpp"
+
+#include <cmath>
+#include <map>
+#include <mutex>
+
+#include "constants.hpp"
+
+Fft::Fft(int size) : mySize(size) {
+  //	radix 4 while possible, then 2, then odd factors
+  int n = size, p = 4;
+  while (n > 1) {
+    while (n % p) {
+      p = p == 4 ? 2 : p == 2 ? 3 : p + 2;
+      if (p * p > n) p = n;
+    }
+    n /= p;
+    myFactors.push_back(p);
+    myFactors.push_back(n);
+    myMaxFactor = max(myMaxFactor, p);
+  }
+
+  myForward.resize(size);
+  myInverse.resize(size);
+  for (int k = 0; k < size; ++k) {
+    const double a = 2.0 * Constants::pi() * k / size;
+    myForward[k] = complex<double>(std::cos(a), -std::sin(a));
+    myInverse[k] = std::conj(myForward[k]);
+  }
+}
+
+const Fft& Fft::plan(int size) {
+  static std::mutex mutex;
+  static std::map<int, Fft> plans;
+
+  std::lock_guard<std::mutex> lock(mutex);
+  auto it = plans.find(size);
+  if (it == plans.end()) it = plans.emplace(size, Fft(size)).first;
+
+  //	done
+  return it->second;
+}
+
+void Fft::work(complex<double>* out, const complex<double>* in, int fstride,
+               int f, const vector<complex<double>>& twiddles,
+               complex<double>* scratch, bool inverse) const {
+  const int p = myFactors[2 * f];
+  const int m = myFactors[2 * f + 1];
+
+  //	p interleaved sub-transforms of length m, side by side in out
+  if (m == 1)
+    for (int q = 0; q < p; ++q) out[q] = in[q * fstride];
+  else
+    for (int q = 0; q < p; ++q)
+      work(out + q * m, in + q * fstride, fstride * p, f + 1, twiddles,
+           scratch, inverse);
+
+  const complex<double>* tw = twiddles.data();
+  if (p == 2) {
+    for (int k = 0; k < m; ++k) {
+      const complex<double> t = out[k + m] * tw[k * fstride];
+      out[k + m] = out[k] - t;
+      out[k] += t;
+    }
+  } else if (p == 4) {
+    //	-i for the forward transform, i for the inverse
+    const double s = inverse ? 1.0 : -1.0;
+    for (int k = 0; k < m; ++k) {
+      const complex<double> s0 = out[k + m] * tw[k * fstride];
+      const complex<double> s1 = out[k + 2 * m] * tw[2 * k * fstride];
+      const complex<double> s2 = out[k + 3 * m] * tw[3 * k * fstride];
+      const complex<double> s5 = out[k] - s1;
+      const complex<double> a = out[k] + s1;
+      const complex<double> s3 = s0 + s2;
+      const complex<double> s4 = s0 - s2;
+      const complex<double> is4(-s * s4.imag(), s * s4.real());
+      out[k] = a + s3;
+      out[k + 2 * m] = a - s3;
+      out[k + m] = s5 + is4;
+      out[k + 3 * m] = s5 - is4;
+    }
+  } else {
+    //	direct p point transforms of the twiddled inputs
+    for (int u = 0; u < m; ++u) {
+      for (int q = 0; q < p; ++q) scratch[q] = out[u + q * m];
+      for (int r = 0; r < p; ++r) {
+        const int k = u + r * m;
+        const int step = fstride * k % mySize;
+        complex<double> sum = scratch[0];
+        int t = 0;
+        for (int q = 1; q < p; ++q) {
+          t += step;
+          if (t >= mySize) t -= mySize;
+          sum += scratch[q] * tw[t];
+        }
+        out[k] = sum;
+      }
+    }
+  }
+}
+
+void Fft::forward(const complex<double>* in, complex<double>* out) const {
+  if (mySize == 1) {
+    out[0] = in[0];
+    return;
+  }
+  vector<complex<double>> scratch(myMaxFactor);
+  work(out, in, 1, 0, myForward, scratch.data(), false);
+}
+
+void Fft::inverse(const complex<double>* in, complex<double>* out) const {
+  if (mySize == 1) {
+    out[0] = in[0];
+    return;
+  }
+  vector<complex<double>> scratch(myMaxFactor);
+  work(out, in, 1, 0, myInverse, scratch.data(), true);
+}
+
+void CarrMadan::calls(const function<complex<double>(complex<double>)>& phi,
+                      double forward, const mVector<double>& strikes,
+                      mVector<double>& calls,
+                      const CarrMadanSettings& settings,
+                      mVector<double>* gridStrikes,
+                      mVector<double>* gridCalls) {
+  const int n = settings.size;
+  const double eta = settings.eta;
+  const double alpha = settings.alpha;
+  const double lambda = 2.0 * Constants::pi() / (n * eta);
+  const complex<double> i(0.0, 1.0);
+
+  //	grid k_u = k0 + lambda u centred on the requested log strikes
+  double kMin = 0.0, kMax = 0.0;
+  for (int j = 0; j < strikes.size(); ++j) {
+    const double k = std::log(strikes[j] / forward);
+    kMin = j ? min(kMin, k) : k;
+    kMax = j ? max(kMax, k) : k;
+  }
+  const double k0 = 0.5 * (kMin + kMax) - 0.5 * n * lambda;
+
+  //	x_j = exp(-i v_j k0) psi(v_j) w_j, psi the transform of the damped
+  //	call, Simpson weights w_j
+  //	the tail past the decay of psi to rounding is left at zero, which
+  //	saves most of the characteristic function calls on long grids
+  vector<complex<double>> x(n, 0.0), y(n);
+  double tiny = 0.0;
+  for (int j = 0; j < n; ++j) {
+    const double v = j * eta;
+    const complex<double> psi =
+        phi(v - (alpha + 1.0) * i) /
+        complex<double>(alpha * alpha + alpha - v * v, (2.0 * alpha + 1.0) * v);
+    if (j == 0) tiny = Constants::dblPrecision() * std::abs(psi);
+    if (std::abs(psi) < tiny) break;
+    const double w = eta / 3.0 * (j == 0 ? 1.0 : j % 2 ? 4.0 : 2.0);
+    x[j] = std::exp(-i * v * k0) * psi * w;
+  }
+  Fft::plan(n).forward(x.data(), y.data());
+
+  //	C(k_u) = F exp(-alpha k_u) / pi Re y_u
+  mVector<double> ks(n), cs(n);
+  for (int u = 0; u < n; ++u) {
+    ks[u] = k0 + lambda * u;
+    cs[u] = forward * std::exp(-alpha * ks[u]) / Constants::pi() * y[u].real();
+  }
+
+  //	cubic through the 4 nodes around each strike
+  const int m = strikes.size();
+  calls.resize(m);
+  for (int j = 0; j < m; ++j) {
+    const double k = std::log(strikes[j] / forward);
+    const int u = max(0, min(n - 4, (int)std::floor((k - k0) / lambda) - 1));
+    const double t = (k - ks[u]) / lambda;
+    double c = 0.0;
+    for (int a = 0; a < 4; ++a) {
+      double l = 1.0;
+      for (int b = 0; b < 4; ++b)
+        if (b != a) l *= (t - b) / (a - b);
+      c += l * cs[u + a];
+    }
+    calls[j] = max(c, max(0.0, forward - strikes[j]));
+  }
+
+  if (gridStrikes) {
+    gridStrikes->resize(n);
+    for (int u = 0; u < n; ++u) (*gridStrikes)[u] = forward * std::exp(ks[u]);
+  }
+  if (gridCalls) *gridCalls = cs;
+}
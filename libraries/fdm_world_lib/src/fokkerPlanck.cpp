@@ -0,0 +1,100 @@
+#include "fokkerPlanck.hpp"
+
+FokkerPlanckSolver::FokkerPlanckSolver(const FdmOperator1d& op)
+    : myOp(&op) {}
+
+void FokkerPlanckSolver::step(mVector<double>& p, double dt, double theta) {
+  const double thetaDt = theta * dt;
+  if (!myImplicit.factorized() || myThetaDt != thetaDt ||
+      myVersion != myOp->version()) {
+    myOp->implicitMatrix(thetaDt, myImplicit);
+    myThetaDt = thetaDt;
+    myVersion = myOp->version();
+  }
+
+  //	q = B^-T p
+  myImplicit.solveTranspose(p);
+
+  //	p = E^T q = q + (1 - theta) dt L^T q
+  if (theta < 1.0) {
+    const int n = p.size();
+    const double w = (1.0 - theta) * dt;
+    myTmp.resize(n);
+    myOp->matrix().applyTranspose(p, myTmp);
+    for (int i = 0; i < n; ++i) p[i] += w * myTmp[i];
+  }
+}
+
+void FokkerPlanckSolver::dirac(const FdmGrid& x, double x0,
+                               mVector<double>& p) {
+  p.assign(x.size(), 0.0);
+
+  double w[4];
+  int order;
+  const int i0 = x.lagrangeWeights(x0, w, order);
+  for (int k = 0; k < order; ++k) p[i0 + k] = w[k];
+}
+
+void FokkerPlanckSolver::calls(const FdmGrid& x, const mVector<double>& p,
+                               const mVector<double>& strikes,
+                               mVector<double>& prices) {
+  const int n = x.size();
+
+  //	suffix sums of p and p times the cell average of x
+  mVector<double> s0(n + 1, 0.0), s1(n + 1, 0.0);
+  for (int i = n - 1; i >= 0; --i) {
+    const double a = i > 0 ? 0.5 * (x[i - 1] + x[i]) : x[i];
+    const double b = i < n - 1 ? 0.5 * (x[i] + x[i + 1]) : x[i];
+    s0[i] = s0[i + 1] + p[i];
+    s1[i] = s1[i + 1] + p[i] * 0.5 * (a + b);
+  }
+
+  const int m = strikes.size();
+  prices.resize(m);
+  for (int k = 0; k < m; ++k) {
+    const double strike = strikes[k];
+    if (strike < x.front()) {
+      prices[k] = s1[0] - strike * s0[0];
+      continue;
+    }
+    if (strike >= x.back()) {
+      prices[k] = 0.0;
+      continue;
+    }
+
+    //	cell around node i holding the strike, cells above pay x - K
+    const int j = x.locate(strike);
+    const int i = strike < 0.5 * (x[j] + x[j + 1]) ? j : j + 1;
+    prices[k] = s1[i + 1] - strike * s0[i + 1] +
+                p[i] * x.vanillaAverage(i, strike, true);
+  }
+}
+
+void FokkerPlanckSolver::callSurface(double x0, const FdmTimeGrid& times,
+                                     const mVector<double>& maturities,
+                                     const mVector<double>& strikes,
+                                     mMatrix<double>& surface) {
+  const int m = maturities.size();
+  surface.resize(m, strikes.size());
+
+  //	node of every maturity
+  vector<int> nodes(m);
+  for (int l = 0; l < m; ++l) nodes[l] = times.index(maturities[l]);
+
+  mVector<double> p, row;
+  dirac(myOp->x(), x0, p);
+
+  auto record = [&](int node) {
+    for (int l = 0; l < m; ++l) {
+      if (nodes[l] != node) continue;
+      calls(myOp->x(), p, strikes, row);
+      for (int k = 0; k < row.size(); ++k) surface(l, k) = row[k];
+    }
+  };
+
+  record(0);
+  for (int k = 0; k < times.steps(); ++k) {
+    step(p, times.dt(k), times.theta(k));
+    record(k + 1);
+  }
+}
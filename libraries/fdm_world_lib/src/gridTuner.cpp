@@ -0,0 +1,353 @@
+#include "gridTuner.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+
+template <class S>
+using Pricer = function<void(const S&, mVector<double>&)>;
+
+//	wall clock seconds of one pricing
+template <class S>
+double timed(const Pricer<S>& pricer, const S& settings, mVector<double>& res) {
+  const auto start = std::chrono::steady_clock::now();
+  pricer(settings, res);
+  const std::chrono::duration<double> elapsed =
+      std::chrono::steady_clock::now() - start;
+
+  //	done
+  return elapsed.count();
+}
+
+double tolerance(const mVector<double>& tolerances, int i) {
+  return tolerances[min(i, tolerances.size() - 1)];
+}
+
+//	largest |res - ref| / tolerance over the outputs, the absolute errors in
+//	errors when given
+double ratio(const mVector<double>& res, const mVector<double>& ref,
+             const mVector<double>& tolerances,
+             mVector<double>* errors = nullptr) {
+  if (res.size() != ref.size()) return HUGE_VAL;
+  if (errors) errors->resize(ref.size());
+
+  double worst = 0.0;
+  for (int i = 0; i < ref.size(); ++i) {
+    const double e = std::fabs(res[i] - ref[i]);
+    if (errors) (*errors)[i] = e;
+    worst = max(worst, e / tolerance(tolerances, i));
+  }
+
+  //	done
+  return worst;
+}
+
+//	scales minScale, minScale step, .. up to maxScale
+void scales(const GridTunerSettings& tuner, vector<double>& res) {
+  res.clear();
+  const double step = max(tuner.step, 1.01);
+  for (double s = tuner.minScale; s <= tuner.maxScale * (1.0 + 1e-9);
+       s *= step)
+    res.push_back(s);
+}
+
+int scaled(int size, double scale, int least) {
+  return max(least, (int)std::lround(scale * size));
+}
+
+FdmSettings1d scaled(const FdmSettings1d& base, double scale,
+                     double timeRatio, bool compact) {
+  FdmSettings1d res = base;
+  res.xSize = scaled(base.xSize, scale, 8);
+  res.timeSteps = scaled(base.timeSteps, scale * timeRatio, 2);
+  res.compact = compact;
+
+  //	done
+  return res;
+}
+
+HestonFdmSettings scaled(const HestonFdmSettings& base, double scale,
+                         double timeRatio, AdiScheme scheme, bool compact) {
+  HestonFdmSettings res = base;
+  res.sSize = scaled(base.sSize, scale, 8);
+  res.vSize = scaled(base.vSize, scale, 8);
+  res.timeSteps = scaled(base.timeSteps, scale * timeRatio, 2);
+  res.scheme = scheme;
+  res.compact = compact;
+
+  //	done
+  return res;
+}
+
+const double timeRatios[] = {0.5, 1.0, 2.0};
+
+//	extrapolated reference from the two finest settings, the estimate of its
+//	own error relative to the tolerances in error
+bool reference(const mVector<double>& fine, const mVector<double>& finer,
+               const mVector<double>& tolerances, int order,
+               mVector<double>& res, double& error) {
+  const int n = fine.size();
+  if (n == 0 || finer.size() != n) return false;
+
+  const double d = std::pow(2.0, order) - 1.0;
+  res.resize(n);
+  error = 0.0;
+  for (int i = 0; i < n; ++i) {
+    const double e = (finer[i] - fine[i]) / d;
+    res[i] = finer[i] + e;
+    error = max(error, std::fabs(e) / tolerance(tolerances, i));
+  }
+
+  //	done
+  return true;
+}
+
+//	cheapest setting within tolerance over the ladders, each in increasing
+//	cost
+template <class S>
+bool search(const Pricer<S>& pricer, const mVector<double>& tolerances,
+            const S& fine, const S& finer, const vector<vector<S>>& ladders,
+            const GridTunerSettings& tuner, S& settings,
+            GridTunerReport* report) {
+  GridTunerReport res;
+  mVector<double> out, out2;
+  pricer(fine, out);
+  pricer(finer, out2);
+  res.candidates = 2;
+  if (!reference(out, out2, tolerances, tuner.order, res.reference,
+                 res.referenceError)) {
+    if (report) *report = res;
+    return false;
+  }
+
+  //	nothing below the uncertainty of the reference can be certified
+  bool found = false;
+  if (res.referenceError <= 1.0) {
+    S best;
+    for (const vector<S>& ladder : ladders) {
+      for (const S& s : ladder) {
+        double seconds = timed(pricer, s, out);
+        ++res.candidates;
+
+        //	finer rungs only cost more
+        if (found && seconds > res.seconds) break;
+        if (ratio(out, res.reference, tolerances) > 1.0) continue;
+
+        for (int k = 1; k < tuner.repeats; ++k)
+          seconds = min(seconds, timed(pricer, s, out2));
+        if (!found || seconds < res.seconds) {
+          found = true;
+          best = s;
+          res.seconds = seconds;
+          ratio(out, res.reference, tolerances, &res.errors);
+        }
+        break;
+      }
+    }
+    if (found) settings = best;
+  }
+
+  if (report) *report = res;
+
+  //	done
+  return found;
+}
+
+}  // namespace
+
+bool GridTuner::tune(const GridPricer1d& pricer,
+                     const mVector<double>& tolerances, FdmSettings1d& settings,
+                     const GridTunerSettings& tuner, GridTunerReport* report) {
+  if (tolerances.empty()) return false;
+
+  const FdmSettings1d fine =
+      scaled(settings, tuner.referenceScale, 1.0, settings.compact);
+  const FdmSettings1d finer =
+      scaled(settings, 2.0 * tuner.referenceScale, 1.0, settings.compact);
+
+  vector<double> ss;
+  scales(tuner, ss);
+  vector<vector<FdmSettings1d>> ladders;
+  for (const bool compact : {false, true})
+    for (const double r : timeRatios) {
+      ladders.emplace_back();
+      for (const double s : ss)
+        ladders.back().push_back(scaled(settings, s, r, compact));
+    }
+
+  //	done
+  return search<FdmSettings1d>(pricer, tolerances, fine, finer, ladders,
+                               tuner, settings, report);
+}
+
+bool GridTuner::tune(const GridPricer2d& pricer,
+                     const mVector<double>& tolerances,
+                     HestonFdmSettings& settings,
+                     const GridTunerSettings& tuner, GridTunerReport* report) {
+  if (tolerances.empty()) return false;
+
+  const HestonFdmSettings fine = scaled(settings, tuner.referenceScale, 1.0,
+                                        settings.scheme, settings.compact);
+  const HestonFdmSettings finer =
+      scaled(settings, 2.0 * tuner.referenceScale, 1.0, settings.scheme,
+             settings.compact);
+
+  vector<double> ss;
+  scales(tuner, ss);
+  vector<vector<HestonFdmSettings>> ladders;
+  for (const AdiScheme scheme :
+       {AdiScheme::Douglas, AdiScheme::CraigSneyd,
+        AdiScheme::ModifiedCraigSneyd, AdiScheme::HundsdorferVerwer})
+    for (const bool compact : {false, true})
+      for (const double r : timeRatios) {
+        ladders.emplace_back();
+        for (const double s : ss)
+          ladders.back().push_back(scaled(settings, s, r, scheme, compact));
+      }
+
+  //	done
+  return search<HestonFdmSettings>(pricer, tolerances, fine, finer, ladders,
+                                   tuner, settings, report);
+}
+
+int GridConfig::find(const string& family, const string& key) const {
+  for (int i = 0; i < (int)myKeys.size(); ++i)
+    if (myFamilies[i] == family && myKeys[i] == key) return i;
+  return -1;
+}
+
+void GridConfig::clear() {
+  myFamilies.clear();
+  myKeys.clear();
+  myValues.clear();
+}
+
+void GridConfig::set(const string& family, const string& key, double value) {
+  const int i = find(family, key);
+  if (i >= 0) {
+    myValues[i] = value;
+    return;
+  }
+  myFamilies.push_back(family);
+  myKeys.push_back(key);
+  myValues.push_back(value);
+}
+
+bool GridConfig::get(const string& family, const string& key,
+                     double& value) const {
+  const int i = find(family, key);
+  if (i < 0) return false;
+  value = myValues[i];
+  return true;
+}
+
+bool GridConfig::has(const string& family) const {
+  for (const string& f : myFamilies)
+    if (f == family) return true;
+  return false;
+}
+
+bool GridConfig::load(const string& path) {
+  std::ifstream in(path);
+  if (!in) return false;
+  clear();
+
+  string line;
+  while (std::getline(in, line)) {
+    const size_t hash = line.find('#');
+    if (hash != string::npos) line.erase(hash);
+
+    std::istringstream is(line);
+    string family, key, extra;
+    double value;
+    if (!(is >> family)) continue;
+    if (!(is >> key >> value) || (is >> extra)) return false;
+    set(family, key, value);
+  }
+
+  //	done
+  return true;
+}
+
+bool GridConfig::save(const string& path) const {
+  std::ofstream out(path);
+  if (!out) return false;
+
+  out << "# family key value\n";
+  out.precision(17);
+  for (int i = 0; i < (int)myKeys.size(); ++i)
+    out << myFamilies[i] << ' ' << myKeys[i] << ' ' << myValues[i] << '\n';
+
+  //	done
+  return (bool)out;
+}
+
+void GridConfig::set(const string& family, const FdmSettings1d& settings) {
+  set(family, "xSize", settings.xSize);
+  set(family, "timeSteps", settings.timeSteps);
+  set(family, "dampingSteps", settings.dampingSteps);
+  set(family, "theta", settings.theta);
+  set(family, "stdDevs", settings.stdDevs);
+  set(family, "density", settings.density);
+  set(family, "compact", settings.compact);
+}
+
+void GridConfig::set(const string& family, const HestonFdmSettings& settings) {
+  set(family, "sSize", settings.sSize);
+  set(family, "vSize", settings.vSize);
+  set(family, "timeSteps", settings.timeSteps);
+  set(family, "dampingSteps", settings.dampingSteps);
+  set(family, "scheme", (int)settings.scheme);
+  set(family, "theta", settings.theta);
+  set(family, "compact", settings.compact);
+  set(family, "convection", (int)settings.convection);
+}
+
+namespace {
+
+//	stored entry into a member when present
+template <class T>
+void read(const GridConfig& config, const string& family, const string& key,
+          T& member) {
+  double value;
+  if (config.get(family, key, value)) member = (T)std::lround(value);
+}
+
+void read(const GridConfig& config, const string& family, const string& key,
+          double& member) {
+  config.get(family, key, member);
+}
+
+}  // namespace
+
+bool GridConfig::get(const string& family, FdmSettings1d& settings) const {
+  if (!has(family)) return false;
+  read(*this, family, "xSize", settings.xSize);
+  read(*this, family, "timeSteps", settings.timeSteps);
+  read(*this, family, "dampingSteps", settings.dampingSteps);
+  read(*this, family, "theta", settings.theta);
+  read(*this, family, "stdDevs", settings.stdDevs);
+  read(*this, family, "density", settings.density);
+  read(*this, family, "compact", settings.compact);
+
+  //	done
+  return true;
+}
+
+bool GridConfig::get(const string& family, HestonFdmSettings& settings) const {
+  if (!has(family)) return false;
+  read(*this, family, "sSize", settings.sSize);
+  read(*this, family, "vSize", settings.vSize);
+  read(*this, family, "timeSteps", settings.timeSteps);
+  read(*this, family, "dampingSteps", settings.dampingSteps);
+  read(*this, family, "scheme", settings.scheme);
+  read(*this, family, "theta", settings.theta);
+  read(*this, family, "compact", settings.compact);
+  read(*this, family, "convection", settings.convection);
+
+  //	done
+  return true;
+}
@@ -0,0 +1,388 @@
+#include "interpolation.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include "tridiagonal.hpp"
+
+namespace {
+
+//	1 / step when the knots are uniform to rounding, 0 otherwise
+double uniform(const mVector<double>& knots) {
+  const int n = knots.size();
+  if (n < 2) return 0.0;
+  const double h = (knots[n - 1] - knots[0]) / (n - 1);
+  const double eps = 1e-12 * (std::fabs(knots[0]) + std::fabs(knots[n - 1]));
+  for (int i = 1; i < n - 1; ++i)
+    if (std::fabs(knots[i] - (knots[0] + i * h)) > eps) return 0.0;
+
+  //	done
+  return 1.0 / h;
+}
+
+int locate(const mVector<double>& knots, double inv, double x) {
+  const int n = knots.size();
+  x = max(knots[0], min(knots[n - 1], x));
+
+  int j;
+  if (inv > 0.0)
+    j = (int)((x - knots[0]) * inv);
+  else {
+    const auto& p = knots.data();
+    j = (int)(std::upper_bound(p.begin(), p.end(), x) - p.begin()) - 1;
+  }
+
+  //	done
+  return max(0, min(j, n - 2));
+}
+
+//	intervals of a batch of queries: increasing queries walk the knots from
+//	the previous interval, others are located one by one
+void intervals(const mVector<double>& knots, double inv,
+               const mVector<double>& x, vector<int>& res) {
+  const int n = knots.size();
+  const int m = x.size();
+  res.resize(m);
+
+  const auto& p = x.data();
+  if (inv > 0.0 || !std::is_sorted(p.begin(), p.end())) {
+    for (int i = 0; i < m; ++i) res[i] = locate(knots, inv, x[i]);
+    return;
+  }
+
+  int j = 0;
+  for (int i = 0; i < m; ++i) {
+    while (j < n - 2 && x[i] >= knots[j + 1]) ++j;
+    res[i] = j;
+  }
+}
+
+//	coefficients in u = x - x0 of the cubic with values f0, f1 and slopes
+//	d0, d1 at x0 and x0 + h
+void hermite(double f0, double f1, double d0, double d1, double h,
+             double* res) {
+  const double s = (f1 - f0) / h;
+  res[0] = f0;
+  res[1] = d0;
+  res[2] = (3.0 * s - 2.0 * d0 - d1) / h;
+  res[3] = (d0 + d1 - 2.0 * s) / (h * h);
+}
+
+//	slopes at the knots of the cubic interpolation of every column of y
+void slopes(const mVector<double>& knots, const mMatrix<double>& y,
+            InterpolationType type, double leftSlope, double rightSlope,
+            mMatrix<double>& res) {
+  const int n = y.rows();
+  const int m = y.cols();
+  res.resize(n, m, 0.0);
+  res = 0.0;
+  if (n < 2) return;
+
+  if (type == InterpolationType::Monotone) {
+    //	Fritsch & Carlson: centred secants, zero at extrema, then limited to
+    //	the circle of radius 3 of the monotone region on every interval
+    for (int k = 0; k < m; ++k) {
+      double prev = 0.0;
+      for (int i = 0; i < n - 1; ++i) {
+        const double s = (y(i + 1, k) - y(i, k)) / (knots[i + 1] - knots[i]);
+        if (i == 0)
+          res(0, k) = s;
+        else
+          res(i, k) = prev * s > 0.0 ? 0.5 * (prev + s) : 0.0;
+        prev = s;
+      }
+      res(n - 1, k) = prev;
+
+      for (int i = 0; i < n - 1; ++i) {
+        const double s = (y(i + 1, k) - y(i, k)) / (knots[i + 1] - knots[i]);
+        if (s == 0.0) {
+          res(i, k) = res(i + 1, k) = 0.0;
+          continue;
+        }
+        const double a = res(i, k) / s;
+        const double b = res(i + 1, k) / s;
+        const double r = a * a + b * b;
+        if (r > 9.0) {
+          const double tau = 3.0 / std::sqrt(r);
+          res(i, k) = tau * a * s;
+          res(i + 1, k) = tau * b * s;
+        }
+      }
+    }
+    return;
+  }
+
+  //	spline slopes, continuous curvature at the inner knots
+  //	  h_i d_i-1 + 2 (h_i-1 + h_i) d_i + h_i-1 d_i+1
+  //	    = 3 (h_i s_i-1 + h_i-1 s_i)
+  //	with 2 d_0 + d_1 = 3 s_0 at natural ends
+  Tridiagonal<double> a(n);
+  const bool clamped = type == InterpolationType::ClampedCubic;
+  a.lower(0) = 0.0;
+  a.diag(0) = clamped ? 1.0 : 2.0;
+  a.upper(0) = clamped ? 0.0 : 1.0;
+  a.lower(n - 1) = clamped ? 0.0 : 1.0;
+  a.diag(n - 1) = clamped ? 1.0 : 2.0;
+  a.upper(n - 1) = 0.0;
+  for (int i = 1; i < n - 1; ++i) {
+    const double hm = knots[i] - knots[i - 1];
+    const double hp = knots[i + 1] - knots[i];
+    a.lower(i) = hp;
+    a.diag(i) = 2.0 * (hm + hp);
+    a.upper(i) = hm;
+    for (int k = 0; k < m; ++k)
+      res(i, k) = 3.0 * (hp * (y(i, k) - y(i - 1, k)) / hm +
+                         hm * (y(i + 1, k) - y(i, k)) / hp);
+  }
+  const double h0 = knots[1] - knots[0];
+  const double h1 = knots[n - 1] - knots[n - 2];
+  for (int k = 0; k < m; ++k) {
+    res(0, k) = clamped ? leftSlope : 3.0 * (y(1, k) - y(0, k)) / h0;
+    res(n - 1, k) =
+        clamped ? rightSlope : 3.0 * (y(n - 1, k) - y(n - 2, k)) / h1;
+  }
+
+  //	all columns against the same factors
+  a.factorize();
+  a.solve(res);
+}
+
+void transpose(const mMatrix<double>& a, mMatrix<double>& res) {
+  res.resize(a.cols(), a.rows());
+  for (int i = 0; i < a.rows(); ++i)
+    for (int j = 0; j < a.cols(); ++j) res(j, i) = a(i, j);
+}
+
+}  // namespace
+
+Interpolator1d::Interpolator1d(const mVector<double>& x,
+                               const mVector<double>& y,
+                               InterpolationType type, double leftSlope,
+                               double rightSlope)
+    : myKnots(x), myUniform(uniform(x)) {
+  const int n = x.size();
+  if (n == 0) return;
+
+  //	a single knot is one flat interval
+  myCoeffs.assign(4 * max(n - 1, 1), 0.0);
+  myCoeffs[0] = y[0];
+  if (n == 1) return;
+
+  if (type == InterpolationType::Linear) {
+    for (int j = 0; j < n - 1; ++j) {
+      myCoeffs[4 * j] = y[j];
+      myCoeffs[4 * j + 1] = (y[j + 1] - y[j]) / (x[j + 1] - x[j]);
+    }
+    return;
+  }
+
+  mMatrix<double> yy(n, 1), d;
+  for (int j = 0; j < n; ++j) yy(j, 0) = y[j];
+  slopes(x, yy, type, leftSlope, rightSlope, d);
+  for (int j = 0; j < n - 1; ++j)
+    hermite(y[j], y[j + 1], d(j, 0), d(j + 1, 0), x[j + 1] - x[j],
+            &myCoeffs[4 * j]);
+}
+
+int Interpolator1d::locate(double x) const {
+  return ::locate(myKnots, myUniform, x);
+}
+
+double Interpolator1d::value(double x) const {
+  if (empty()) return 0.0;
+  x = max(myKnots[0], min(myKnots[size() - 1], x));
+  const int j = locate(x);
+  const double* c = coefficients(j);
+  const double u = x - myKnots[j];
+
+  //	done
+  return c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+}
+
+double Interpolator1d::derivative(double x) const {
+  if (empty() || x < myKnots[0] || x > myKnots[size() - 1]) return 0.0;
+  const int j = locate(x);
+  const double* c = coefficients(j);
+  const double u = x - myKnots[j];
+
+  //	done
+  return c[1] + u * (2.0 * c[2] + 3.0 * u * c[3]);
+}
+
+void Interpolator1d::values(const mVector<double>& x,
+                            mVector<double>& res) const {
+  const int m = x.size();
+  res.assign(m, 0.0);
+  if (empty()) return;
+
+  vector<int> js;
+  intervals(myKnots, myUniform, x, js);
+
+  const double lo = myKnots[0];
+  const double hi = myKnots[size() - 1];
+  for (int i = 0; i < m; ++i) {
+    const double* c = coefficients(js[i]);
+    const double u = max(lo, min(hi, x[i])) - myKnots[js[i]];
+    res[i] = c[0] + u * (c[1] + u * (c[2] + u * c[3]));
+  }
+}
+
+void Interpolator1d::derivatives(const mVector<double>& x,
+                                 mVector<double>& res) const {
+  const int m = x.size();
+  res.assign(m, 0.0);
+  if (empty()) return;
+
+  vector<int> js;
+  intervals(myKnots, myUniform, x, js);
+
+  const double lo = myKnots[0];
+  const double hi = myKnots[size() - 1];
+  for (int i = 0; i < m; ++i) {
+    if (x[i] < lo || x[i] > hi) continue;
+    const double* c = coefficients(js[i]);
+    const double u = x[i] - myKnots[js[i]];
+    res[i] = c[1] + u * (2.0 * c[2] + 3.0 * u * c[3]);
+  }
+}
+
+Interpolator2d::Interpolator2d(const mVector<double>& x,
+                               const mVector<double>& y,
+                               const mMatrix<double>& z,
+                               InterpolationType type)
+    : myX(x), myY(y), myUniformX(uniform(x)), myUniformY(uniform(y)) {
+  const int n = x.size();
+  const int m = y.size();
+  if (n == 0 || m == 0) return;
+
+  //	a single knot in a direction is one cell flat in that direction
+  const int cx = max(n - 1, 1);
+  const int cy = max(m - 1, 1);
+  myCells = cy;
+  myCoeffs.assign(16 * cx * cy, 0.0);
+
+  //	slopes along x, along y and the cross derivatives as the slopes
+  //	along y of the slopes along x
+  mMatrix<double> fx, fy, fxy, t, s;
+  const bool linear = type == InterpolationType::Linear;
+  if (!linear) {
+    slopes(x, z, type, 0.0, 0.0, fx);
+    transpose(z, t);
+    slopes(y, t, type, 0.0, 0.0, s);
+    transpose(s, fy);
+    transpose(fx, t);
+    slopes(y, t, type, 0.0, 0.0, s);
+    transpose(s, fxy);
+  }
+
+  for (int i = 0; i < cx; ++i) {
+    const int i1 = min(i + 1, n - 1);
+    const double hx = i1 > i ? x[i1] - x[i] : 1.0;
+    for (int j = 0; j < cy; ++j) {
+      const int j1 = min(j + 1, m - 1);
+      const double hy = j1 > j ? y[j1] - y[j] : 1.0;
+      double* c = &myCoeffs[16 * (i * cy + j)];
+
+      //	c[4 a + b] multiplies u^a v^b
+      if (linear) {
+        c[0] = z(i, j);
+        c[4] = (z(i1, j) - z(i, j)) / hx;
+        c[1] = (z(i, j1) - z(i, j)) / hy;
+        c[5] = (z(i1, j1) - z(i1, j) - z(i, j1) + z(i, j)) / (hx * hy);
+        continue;
+      }
+
+      //	cubics in u of the values and y slopes on both y knots, then
+      //	every coefficient in u as a cubic in v
+      double a0[4], a1[4], b0[4], b1[4];
+      hermite(z(i, j), z(i1, j), fx(i, j), fx(i1, j), hx, a0);
+      hermite(z(i, j1), z(i1, j1), fx(i, j1), fx(i1, j1), hx, a1);
+      hermite(fy(i, j), fy(i1, j), fxy(i, j), fxy(i1, j), hx, b0);
+      hermite(fy(i, j1), fy(i1, j1), fxy(i, j1), fxy(i1, j1), hx, b1);
+      for (int a = 0; a < 4; ++a)
+        hermite(a0[a], a1[a], b0[a], b1[a], hy, c + 4 * a);
+    }
+  }
+}
+
+double Interpolator2d::cell(int i, int j, double u, double v) const {
+  const double* c = &myCoeffs[16 * (i * myCells + j)];
+  double res = 0.0;
+  for (int a = 3; a >= 0; --a) {
+    const double* ca = c + 4 * a;
+    res = res * u + (ca[0] + v * (ca[1] + v * (ca[2] + v * ca[3])));
+  }
+
+  //	done
+  return res;
+}
+
+double Interpolator2d::value(double x, double y) const {
+  if (empty()) return 0.0;
+  x = max(myX[0], min(myX[myX.size() - 1], x));
+  y = max(myY[0], min(myY[myY.size() - 1], y));
+  const int i = locate(myX, myUniformX, x);
+  const int j = locate(myY, myUniformY, y);
+
+  //	done
+  return cell(i, j, x - myX[i], y - myY[j]);
+}
+
+void Interpolator2d::values(const mVector<double>& x, const mVector<double>& y,
+                            mVector<double>& res) const {
+  const int m = min(x.size(), y.size());
+  res.assign(m, 0.0);
+  if (empty()) return;
+
+  vector<int> is, js;
+  intervals(myX, myUniformX, x, is);
+  intervals(myY, myUniformY, y, js);
+
+  const double xLo = myX[0], xHi = myX[myX.size() - 1];
+  const double yLo = myY[0], yHi = myY[myY.size() - 1];
+  for (int k = 0; k < m; ++k) {
+    const int i = is[k];
+    const int j = js[k];
+    res[k] = cell(i, j, max(xLo, min(xHi, x[k])) - myX[i],
+                  max(yLo, min(yHi, y[k])) - myY[j]);
+  }
+}
+
+void Interpolator2d::grid(const mVector<double>& x, const mVector<double>& y,
+                          mMatrix<double>& res) const {
+  const int nx = x.size();
+  const int ny = y.size();
+  res.resize(nx, ny, 0.0);
+  res = 0.0;
+  if (empty()) return;
+
+  vector<int> is, js;
+  intervals(myX, myUniformX, x, is);
+  intervals(myY, myUniformY, y, js);
+
+  //	local v of every column once
+  const double yLo = myY[0], yHi = myY[myY.size() - 1];
+  vector<double> vs(ny);
+  for (int l = 0; l < ny; ++l) vs[l] = max(yLo, min(yHi, y[l])) - myY[js[l]];
+
+  //	every row collapses its cells to cubics in v first
+  const double xLo = myX[0], xHi = myX[myX.size() - 1];
+  vector<double> w(4 * myCells);
+  for (int k = 0; k < nx; ++k) {
+    const int i = is[k];
+    const double u = max(xLo, min(xHi, x[k])) - myX[i];
+    for (int j = 0; j < myCells; ++j) {
+      const double* c = &myCoeffs[16 * (i * myCells + j)];
+      for (int b = 0; b < 4; ++b)
+        w[4 * j + b] =
+            c[b] + u * (c[4 + b] + u * (c[8 + b] + u * c[12 + b]));
+    }
+
+    double* r = &res(k, 0);
+    for (int l = 0; l < ny; ++l) {
+      const double* c = &w[4 * js[l]];
+      const double v = vs[l];
+      r[l] = c[0] + v * (c[1] + v * (c[2] + v * c[3]));
+    }
+  }
+}
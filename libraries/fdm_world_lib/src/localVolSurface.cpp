@@ -0,0 +1,245 @@
+#include "localVolSurface.hpp"
+
+#include <algorithm>
+
+LocalVolSurface::LocalVolSurface(const mVector<double>& times,
+                                 const mVector<double>& strikes,
+                                 const mMatrix<double>& vols)
+    : myTimes(times),
+      myStrikes(strikes),
+      myInputTimes(vols.rows()),
+      myInputStrikes(vols.cols()) {
+  //	a single knot is duplicated, the spline is then flat in that direction
+  const int nt = max(times.size(), 2);
+  const int nk = max(strikes.size(), 2);
+  if (times.size() == 1) myTimes = mVector<double>(2, times[0] + 1.0);
+  if (strikes.size() == 1) myStrikes = mVector<double>(2, strikes[0] + 1.0);
+  myTimes[0] = times[0];
+  myStrikes[0] = strikes[0];
+
+  myVols.resize(nk, nt);
+  for (int j = 0; j < nk; ++j)
+    for (int k = 0; k < nt; ++k)
+      myVols(j, k) = vols(min(k, vols.rows() - 1), min(j, vols.cols() - 1));
+
+  splineMatrix(myStrikes, myStrikeMatrix);
+  splineCurvatures(myStrikes, myStrikeMatrix, myVols, myVolCurvatures);
+
+  splineMatrix(myTimes, myTimeMatrix);
+}
+
+LocalVolSurface LocalVolSurface::flat(double volatility) {
+  return LocalVolSurface(mVector<double>(1, 0.0), mVector<double>(1, 0.0),
+                         mMatrix<double>(1, 1, volatility));
+}
+
+int LocalVolSurface::locate(const mVector<double>& knots, double x) {
+  const int n = knots.size();
+  const auto& p = knots.data();
+  const int j = (int)(std::upper_bound(p.begin(), p.end(), x) - p.begin()) - 1;
+
+  //	done
+  return max(0, min(j, n - 2));
+}
+
+void LocalVolSurface::splineMatrix(const mVector<double>& knots,
+                                   Tridiagonal<double>& res) {
+  const int n = knots.size();
+  res.resize(n);
+
+  //	natural ends: zero curvature
+  res.lower(0) = res.upper(0) = 0.0;
+  res.diag(0) = 1.0;
+  res.lower(n - 1) = res.upper(n - 1) = 0.0;
+  res.diag(n - 1) = 1.0;
+
+  for (int i = 1; i < n - 1; ++i) {
+    const double hm = knots[i] - knots[i - 1];
+    const double hp = knots[i + 1] - knots[i];
+    res.lower(i) = hm;
+    res.diag(i) = 2.0 * (hm + hp);
+    res.upper(i) = hp;
+  }
+
+  res.factorize();
+}
+
+void LocalVolSurface::splineCurvatures(const mVector<double>& knots,
+                                       const Tridiagonal<double>& matrix,
+                                       const mMatrix<double>& y,
+                                       mMatrix<double>& res) {
+  const int n = y.rows();
+  const int m = y.cols();
+  res.resize(n, m);
+
+  for (int k = 0; k < m; ++k) res(0, k) = res(n - 1, k) = 0.0;
+  for (int i = 1; i < n - 1; ++i) {
+    const double hm = knots[i] - knots[i - 1];
+    const double hp = knots[i + 1] - knots[i];
+    for (int k = 0; k < m; ++k)
+      res(i, k) = 6.0 * ((y(i + 1, k) - y(i, k)) / hp -
+                         (y(i, k) - y(i - 1, k)) / hm);
+  }
+
+  //	all splines against the same factors
+  matrix.solve(res);
+}
+
+void LocalVolSurface::splineRhsAdjoint(const mVector<double>& knots,
+                                       const mMatrix<double>& rBar,
+                                       mMatrix<double>& yBar) {
+  const int n = rBar.rows();
+  const int m = rBar.cols();
+  for (int i = 1; i < n - 1; ++i) {
+    const double hm = 6.0 / (knots[i] - knots[i - 1]);
+    const double hp = 6.0 / (knots[i + 1] - knots[i]);
+    for (int k = 0; k < m; ++k) {
+      const double r = rBar(i, k);
+      yBar(i + 1, k) += hp * r;
+      yBar(i, k) -= (hp + hm) * r;
+      yBar(i - 1, k) += hm * r;
+    }
+  }
+}
+
+void LocalVolSurface::splineWeights(const mVector<double>& knots, int j,
+                                    double x, double* weights) {
+  const double h = knots[j + 1] - knots[j];
+  const double a = max(0.0, min(1.0, (knots[j + 1] - x) / h));
+  const double b = 1.0 - a;
+  weights[0] = a;
+  weights[1] = b;
+  weights[2] = (a * a * a - a) * h * h / 6.0;
+  weights[3] = (b * b * b - b) * h * h / 6.0;
+}
+
+void LocalVolSurface::rowValues(double x, mVector<double>& res) const {
+  const int nt = myTimes.size();
+  res.resize(nt);
+
+  double w[4];
+  const int j = locate(myStrikes, x);
+  splineWeights(myStrikes, j, x, w);
+  for (int k = 0; k < nt; ++k)
+    res[k] = w[0] * myVols(j, k) + w[1] * myVols(j + 1, k) +
+             w[2] * myVolCurvatures(j, k) + w[3] * myVolCurvatures(j + 1, k);
+}
+
+double LocalVolSurface::volatility(double t, double x) const {
+  const int nt = myTimes.size();
+  mVector<double> row;
+  rowValues(x, row);
+
+  mMatrix<double> y(nt, 1), c;
+  for (int k = 0; k < nt; ++k) y(k, 0) = row[k];
+  splineCurvatures(myTimes, myTimeMatrix, y, c);
+
+  double w[4];
+  const int k = locate(myTimes, t);
+  splineWeights(myTimes, k, t, w);
+
+  //	done
+  return w[0] * y(k, 0) + w[1] * y(k + 1, 0) + w[2] * c(k, 0) +
+         w[3] * c(k + 1, 0);
+}
+
+void LocalVolSurface::setPoints(const mVector<double>& x) {
+  const int nt = myTimes.size();
+  const int n = x.size();
+  myPoints = x;
+  myNodeVols.resize(nt, n);
+
+  double w[4];
+  for (int i = 0; i < n; ++i) {
+    const int j = locate(myStrikes, x[i]);
+    splineWeights(myStrikes, j, x[i], w);
+    for (int k = 0; k < nt; ++k)
+      myNodeVols(k, i) =
+          w[0] * myVols(j, k) + w[1] * myVols(j + 1, k) +
+          w[2] * myVolCurvatures(j, k) + w[3] * myVolCurvatures(j + 1, k);
+  }
+
+  //	time splines of all nodes in one multi column solve
+  splineCurvatures(myTimes, myTimeMatrix, myNodeVols, myNodeCurvatures);
+
+  myNodeVolsBar.resize(nt, n, 0.0);
+  myNodeCurvaturesBar.resize(nt, n, 0.0);
+  for (int k = 0; k < nt; ++k)
+    for (int i = 0; i < n; ++i)
+      myNodeVolsBar(k, i) = myNodeCurvaturesBar(k, i) = 0.0;
+}
+
+void LocalVolSurface::volatilities(double t, mVector<double>& res) const {
+  const int n = myNodeVols.cols();
+  res.resize(n);
+
+  double w[4];
+  const int k = locate(myTimes, t);
+  splineWeights(myTimes, k, t, w);
+
+  const double* v0 = &myNodeVols(k, 0);
+  const double* v1 = &myNodeVols(k + 1, 0);
+  const double* c0 = &myNodeCurvatures(k, 0);
+  const double* c1 = &myNodeCurvatures(k + 1, 0);
+  for (int i = 0; i < n; ++i)
+    res[i] = w[0] * v0[i] + w[1] * v1[i] + w[2] * c0[i] + w[3] * c1[i];
+}
+
+void LocalVolSurface::volatilitiesAdjoint(double t,
+                                          const mVector<double>& gradient) {
+  const int n = myNodeVols.cols();
+
+  double w[4];
+  const int k = locate(myTimes, t);
+  splineWeights(myTimes, k, t, w);
+
+  double* v0 = &myNodeVolsBar(k, 0);
+  double* v1 = &myNodeVolsBar(k + 1, 0);
+  double* c0 = &myNodeCurvaturesBar(k, 0);
+  double* c1 = &myNodeCurvaturesBar(k + 1, 0);
+  for (int i = 0; i < n; ++i) {
+    const double g = gradient[i];
+    v0[i] += w[0] * g;
+    v1[i] += w[1] * g;
+    c0[i] += w[2] * g;
+    c1[i] += w[3] * g;
+  }
+}
+
+void LocalVolSurface::gradient(mMatrix<double>& res) const {
+  const int nt = myTimes.size();
+  const int nk = myStrikes.size();
+  const int n = myNodeVols.cols();
+
+  //	through the time splines of the nodes
+  mMatrix<double> vBar = myNodeVolsBar;
+  mMatrix<double> rBar = myNodeCurvaturesBar;
+  myTimeMatrix.solveTranspose(rBar);
+  splineRhsAdjoint(myTimes, rBar, vBar);
+
+  //	through the strike splines sampled on the nodes
+  mMatrix<double> volBar(nk, nt, 0.0), curvBar(nk, nt, 0.0);
+  double w[4];
+  for (int i = 0; i < n; ++i) {
+    const int j = locate(myStrikes, myPoints[i]);
+    splineWeights(myStrikes, j, myPoints[i], w);
+    for (int k = 0; k < nt; ++k) {
+      const double g = vBar(k, i);
+      volBar(j, k) += w[0] * g;
+      volBar(j + 1, k) += w[1] * g;
+      curvBar(j, k) += w[2] * g;
+      curvBar(j + 1, k) += w[3] * g;
+    }
+  }
+  myStrikeMatrix.solveTranspose(curvBar);
+  splineRhsAdjoint(myStrikes, curvBar, volBar);
+
+  //	duplicated single knots fold back onto the input
+  res.resize(myInputTimes, myInputStrikes, 0.0);
+  for (int k = 0; k < myInputTimes; ++k)
+    for (int j = 0; j < myInputStrikes; ++j) res(k, j) = 0.0;
+  for (int j = 0; j < nk; ++j)
+    for (int k = 0; k < nt; ++k)
+      res(min(k, myInputTimes - 1), min(j, myInputStrikes - 1)) +=
+          volBar(j, k);
+}
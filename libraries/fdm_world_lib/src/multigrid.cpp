@@ -0,0 +1,564 @@
+#include "multigrid.hpp"
+
+#include <cmath>
+#include <utility>
+
+#include "mMatrixAlgebra.hpp"
+
+namespace {
+
+//	fine node under coarse node k, the coarse nodes are every other fine
+//	node and the last one
+int fineNode(int k, int size, bool coarsen) {
+  if (!coarsen) return k;
+  return k == size / 2 ? size - 1 : 2 * k;
+}
+
+//	coarse nodes and weights of P on fine node i, 1 or 2 of them
+int prolongationWeights(int i, int size, bool coarsen, int* nodes,
+                        double* weights) {
+  if (!coarsen) {
+    nodes[0] = i;
+    weights[0] = 1.0;
+    return 1;
+  }
+  if (i == size - 1) {
+    nodes[0] = size / 2;
+    weights[0] = 1.0;
+    return 1;
+  }
+  if (i % 2 == 0) {
+    nodes[0] = i / 2;
+    weights[0] = 1.0;
+    return 1;
+  }
+  nodes[0] = (i - 1) / 2;
+  nodes[1] = (i + 1) / 2;
+  weights[0] = weights[1] = 0.5;
+  return 2;
+}
+
+//	fine nodes and weights of P^T on coarse node k, up to 3 of them
+int restrictionWeights(int k, int size, bool coarsen, int* nodes,
+                       double* weights) {
+  if (!coarsen) {
+    nodes[0] = k;
+    weights[0] = 1.0;
+    return 1;
+  }
+  const int c = fineNode(k, size, coarsen);
+  int count = 0, p[2];
+  double w[2];
+  for (int i = max(c - 1, 0); i <= min(c + 1, size - 1); ++i) {
+    const int np = prolongationWeights(i, size, coarsen, p, w);
+    for (int a = 0; a < np; ++a) {
+      if (p[a] != k) continue;
+      nodes[count] = i;
+      weights[count++] = w[a];
+    }
+  }
+  return count;
+}
+
+//	nan as soon as an entry is, so that a diverged cycle does not pass
+double maxNorm(const mMatrix<double>& u) {
+  double res = 0.0;
+  for (int k = 0; k < u.size(); ++k) {
+    if (std::isnan(u[k])) return u[k];
+    res = max(res, std::abs(u[k]));
+  }
+  return res;
+}
+
+double dot(const mMatrix<double>& a, const mMatrix<double>& b) {
+  double res = 0.0;
+  for (int k = 0; k < a.size(); ++k) res += a[k] * b[k];
+  return res;
+}
+
+//	dense matrix of a stencil over the nodes i * ny + j
+void denseMatrix(const vector<mMatrix<double>>& stencil, int nx, int ny,
+                 mMatrix<double>& res) {
+  const int n = nx * ny;
+  res.resize(n, n, 0.0);
+  res = 0.0;
+  for (int i = 0; i < nx; ++i)
+    for (int j = 0; j < ny; ++j)
+      for (int a = 0; a < 3; ++a)
+        for (int b = 0; b < 3; ++b) {
+          const int ii = i + a - 1;
+          const int jj = j + b - 1;
+          if (ii < 0 || ii >= nx || jj < 0 || jj >= ny) continue;
+          res(i * ny + j, ii * ny + jj) += stencil[3 * a + b](i, j);
+        }
+}
+
+}  // namespace
+
+Multigrid2d::Multigrid2d(const FdmOperator2d& op,
+                         const MultigridSettings& settings,
+                         const function<void(FdmOperator2d&)>& rebuild)
+    : myOp(&op), mySettings(settings), myRebuild(rebuild) {}
+
+void Multigrid2d::setup(double thetaDt) {
+  myThetaDt = thetaDt;
+  mySingular = false;
+  myLevels.clear();
+
+  //	M = I - thetaDt A on the grid
+  myLevels.emplace_back();
+  Level& fine = myLevels.back();
+  fine.nx = myOp->xSize();
+  fine.ny = myOp->ySize();
+  fine.x = myOp->x();
+  fine.y = myOp->y();
+  myOp->stencil(fine.stencil);
+  for (mMatrix<double>& s : fine.stencil)
+    for (int k = 0; k < s.size(); ++k) s[k] *= -thetaDt;
+  for (int k = 0; k < fine.stencil[4].size(); ++k) fine.stencil[4][k] += 1.0;
+
+  //	halve while a direction has 4 nodes or more
+  while (true) {
+    Level& level = myLevels.back();
+    level.coarsenX = level.nx >= 4;
+    level.coarsenY = level.ny >= 4;
+    if (!level.coarsenX && !level.coarsenY) break;
+
+    Level coarse;
+    coarse.nx = level.coarsenX ? level.nx / 2 + 1 : level.nx;
+    coarse.ny = level.coarsenY ? level.ny / 2 + 1 : level.ny;
+    if (myRebuild)
+      rediscretise(level, coarse);
+    else
+      galerkin(level, coarse);
+
+    //	identity rows on the sides, where the correction is zero
+    for (int I = 0; I < coarse.nx; ++I)
+      for (int J = 0; J < coarse.ny; ++J) {
+        if (!side(coarse, I, J)) continue;
+        for (int s = 0; s < 9; ++s) coarse.stencil[s](I, J) = 0.0;
+        coarse.stencil[4](I, J) = 1.0;
+      }
+    myLevels.push_back(std::move(coarse));
+  }
+
+  for (Level& level : myLevels) {
+    level.f.resize(level.nx, level.ny, 0.0);
+    level.u.resize(level.nx, level.ny, 0.0);
+    level.r.resize(level.nx, level.ny, 0.0);
+    level.cp.resize(level.nx, level.ny, 0.0);
+    level.dp.resize(level.nx, level.ny, 0.0);
+  }
+
+  Level& coarsest = myLevels.back();
+  if (coarsest.nx * coarsest.ny <= 1024) {
+    denseMatrix(coarsest.stencil, coarsest.nx, coarsest.ny, coarsest.lu);
+
+    //	a zero pivot falls back to the extra sweeps
+    if (!mMatrixAlgebra::lu(coarsest.lu, coarsest.pivots)) {
+      coarsest.lu = mMatrix<double>();
+      coarsest.pivots.clear();
+      mySingular = true;
+    }
+  }
+}
+
+void Multigrid2d::galerkin(const Level& fine, Level& coarse) {
+  const int nx = coarse.nx;
+  const int ny = coarse.ny;
+  coarse.stencil.resize(9);
+  for (mMatrix<double>& s : coarse.stencil) {
+    s.resize(nx, ny, 0.0);
+    s = 0.0;
+  }
+
+  //	(P^T M P)(I, J) = sum over the fine f under I of P^T(I, f) sum over
+  //	the stencil neighbours g of f of M(f, g) P(g, J), J within one of I
+  //	P has no rows or columns on the sides
+  int rx[3], ry[3], px[2], py[2];
+  double wrx[3], wry[3], wpx[2], wpy[2];
+  for (int I = 0; I < nx; ++I) {
+    const int nrx = restrictionWeights(I, fine.nx, fine.coarsenX, rx, wrx);
+    for (int J = 0; J < ny; ++J) {
+      if (side(coarse, I, J)) continue;
+      const int nry = restrictionWeights(J, fine.ny, fine.coarsenY, ry, wry);
+      for (int a = 0; a < nrx; ++a)
+        for (int b = 0; b < nry; ++b) {
+          const int fi = rx[a];
+          const int fj = ry[b];
+          if (side(fine, fi, fj)) continue;
+          const double r = wrx[a] * wry[b];
+          for (int s = 0; s < 9; ++s) {
+            const double m = fine.stencil[s](fi, fj);
+            if (m == 0.0) continue;
+            const int gi = fi + s / 3 - 1;
+            const int gj = fj + s % 3 - 1;
+            if (side(fine, gi, gj)) continue;
+            const int npx =
+                prolongationWeights(gi, fine.nx, fine.coarsenX, px, wpx);
+            const int npy =
+                prolongationWeights(gj, fine.ny, fine.coarsenY, py, wpy);
+            for (int c = 0; c < npx; ++c)
+              for (int d = 0; d < npy; ++d) {
+                if (side(coarse, px[c], py[d])) continue;
+                coarse.stencil[3 * (px[c] - I + 1) + py[d] - J + 1](I, J) +=
+                    r * m * wpx[c] * wpy[d];
+              }
+          }
+        }
+    }
+  }
+}
+
+void Multigrid2d::rediscretise(const Level& fine, Level& coarse) const {
+  auto halve = [](const FdmGrid& x, bool coarsen) {
+    if (!coarsen) return x;
+    mVector<double> points(x.size() / 2 + 1);
+    for (int i = 0; i < points.size(); ++i)
+      points[i] = x[fineNode(i, x.size(), coarsen)];
+    return FdmGrid(points);
+  };
+  coarse.x = halve(fine.x, fine.coarsenX);
+  coarse.y = halve(fine.y, fine.coarsenY);
+  coarse.scale = fine.scale * (fine.coarsenX ? 2.0 : 1.0) *
+                 (fine.coarsenY ? 2.0 : 1.0);
+
+  FdmOperator2d op(coarse.x, coarse.y);
+  myRebuild(op);
+  op.stencil(coarse.stencil);
+  for (mMatrix<double>& s : coarse.stencil)
+    for (int k = 0; k < s.size(); ++k) s[k] *= -myThetaDt * coarse.scale;
+  for (int k = 0; k < coarse.stencil[4].size(); ++k)
+    coarse.stencil[4][k] += coarse.scale;
+}
+
+void Multigrid2d::residual(const Level& level, const mMatrix<double>& f,
+                           const mMatrix<double>& u, mMatrix<double>& r) {
+  const int nx = level.nx;
+  const int ny = level.ny;
+  for (int i = 0; i < nx; ++i) {
+    double* ri = &r(i, 0);
+    if (f.empty()) {
+      for (int j = 0; j < ny; ++j) ri[j] = 0.0;
+    } else {
+      const double* fi = &f(i, 0);
+      for (int j = 0; j < ny; ++j) ri[j] = fi[j];
+    }
+
+    for (int a = 0; a < 3; ++a) {
+      const int ii = i + a - 1;
+      if (ii < 0 || ii >= nx) continue;
+      const double* uu = &u(ii, 0);
+      for (int b = 0; b < 3; ++b) {
+        const double* s = &level.stencil[3 * a + b](i, 0);
+        const int dj = b - 1;
+        const int jEnd = b == 2 ? ny - 1 : ny;
+        for (int j = b == 0 ? 1 : 0; j < jEnd; ++j) ri[j] -= s[j] * uu[j + dj];
+      }
+    }
+  }
+}
+
+void Multigrid2d::smoothX(Level& level, const mMatrix<double>& f,
+                          mMatrix<double>& u) {
+  const int nx = level.nx;
+  const int ny = level.ny;
+  const vector<mMatrix<double>>& s = level.stencil;
+
+  //	all the columns of a colour at once, row by row
+  for (int colour = 0; colour < 2; ++colour) {
+    for (int i = 0; i < nx; ++i) {
+      double* cp = &level.cp(i, 0);
+      double* dp = &level.dp(i, 0);
+      const double* cm = i > 0 ? &level.cp(i - 1, 0) : nullptr;
+      const double* dm = i > 0 ? &level.dp(i - 1, 0) : nullptr;
+      for (int j = colour; j < ny; j += 2) {
+        //	neighbours on the columns j - 1 and j + 1
+        double rhs = f(i, j);
+        for (int a = 0; a < 3; ++a) {
+          const int ii = i + a - 1;
+          if (ii < 0 || ii >= nx) continue;
+          if (j > 0) rhs -= s[3 * a](i, j) * u(ii, j - 1);
+          if (j < ny - 1) rhs -= s[3 * a + 2](i, j) * u(ii, j + 1);
+        }
+        const double l = i > 0 ? s[1](i, j) : 0.0;
+        const double den = s[4](i, j) - (cm ? l * cm[j] : 0.0);
+        cp[j] = s[7](i, j) / den;
+        dp[j] = (rhs - (dm ? l * dm[j] : 0.0)) / den;
+      }
+    }
+    for (int j = colour; j < ny; j += 2) u(nx - 1, j) = level.dp(nx - 1, j);
+    for (int i = nx - 2; i >= 0; --i) {
+      const double* cp = &level.cp(i, 0);
+      const double* dp = &level.dp(i, 0);
+      const double* up = &u(i + 1, 0);
+      double* uc = &u(i, 0);
+      for (int j = colour; j < ny; j += 2) uc[j] = dp[j] - cp[j] * up[j];
+    }
+  }
+}
+
+void Multigrid2d::smoothY(Level& level, const mMatrix<double>& f,
+                          mMatrix<double>& u) {
+  const int nx = level.nx;
+  const int ny = level.ny;
+  const vector<mMatrix<double>>& s = level.stencil;
+
+  for (int colour = 0; colour < 2; ++colour) {
+    for (int i = colour; i < nx; i += 2) {
+      //	neighbours on the rows i - 1 and i + 1
+      double* rhs = &level.r(i, 0);
+      const double* fi = &f(i, 0);
+      for (int j = 0; j < ny; ++j) rhs[j] = fi[j];
+      for (int a = 0; a < 3; a += 2) {
+        const int ii = i + a - 1;
+        if (ii < 0 || ii >= nx) continue;
+        const double* uu = &u(ii, 0);
+        for (int b = 0; b < 3; ++b) {
+          const double* w = &s[3 * a + b](i, 0);
+          const int dj = b - 1;
+          const int jEnd = b == 2 ? ny - 1 : ny;
+          for (int j = b == 0 ? 1 : 0; j < jEnd; ++j)
+            rhs[j] -= w[j] * uu[j + dj];
+        }
+      }
+
+      //	Thomas along the row
+      const double* l = &s[3](i, 0);
+      const double* d = &s[4](i, 0);
+      const double* h = &s[5](i, 0);
+      double* cp = &level.cp(i, 0);
+      double* uc = &u(i, 0);
+      cp[0] = h[0] / d[0];
+      uc[0] = rhs[0] / d[0];
+      for (int j = 1; j < ny; ++j) {
+        const double den = d[j] - l[j] * cp[j - 1];
+        cp[j] = h[j] / den;
+        uc[j] = (rhs[j] - l[j] * uc[j - 1]) / den;
+      }
+      for (int j = ny - 2; j >= 0; --j) uc[j] -= cp[j] * uc[j + 1];
+    }
+  }
+}
+
+void Multigrid2d::restriction(const Level& fine, const Level& coarse,
+                              const mMatrix<double>& r, mMatrix<double>& res) {
+  const int nx = coarse.nx;
+  const int ny = coarse.ny;
+  int rx[3], ry[3];
+  double wx[3], wy[3];
+  for (int I = 0; I < nx; ++I) {
+    const int nrx = restrictionWeights(I, fine.nx, fine.coarsenX, rx, wx);
+    for (int J = 0; J < ny; ++J) {
+      const int nry = restrictionWeights(J, fine.ny, fine.coarsenY, ry, wy);
+      double sum = 0.0;
+      if (!side(coarse, I, J))
+        for (int a = 0; a < nrx; ++a)
+          for (int b = 0; b < nry; ++b)
+            if (!side(fine, rx[a], ry[b]))
+              sum += wx[a] * wy[b] * r(rx[a], ry[b]);
+      res(I, J) = sum;
+    }
+  }
+}
+
+void Multigrid2d::prolongate(const Level& fine, const Level& coarse,
+                             const mMatrix<double>& e, mMatrix<double>& u) {
+  int px[2], py[2];
+  double wx[2], wy[2];
+  for (int i = 0; i < fine.nx; ++i) {
+    const int npx = prolongationWeights(i, fine.nx, fine.coarsenX, px, wx);
+    for (int j = 0; j < fine.ny; ++j) {
+      if (side(fine, i, j)) continue;
+      const int npy = prolongationWeights(j, fine.ny, fine.coarsenY, py, wy);
+      double sum = 0.0;
+      for (int a = 0; a < npx; ++a)
+        for (int b = 0; b < npy; ++b)
+          if (!side(coarse, px[a], py[b]))
+            sum += wx[a] * wy[b] * e(px[a], py[b]);
+      u(i, j) += sum;
+    }
+  }
+}
+
+void Multigrid2d::smooth(Level& level, bool pre) {
+  if (pre) {
+    smoothX(level, level.f, level.u);
+    smoothY(level, level.f, level.u);
+  } else {
+    smoothY(level, level.f, level.u);
+    smoothX(level, level.f, level.u);
+  }
+}
+
+void Multigrid2d::cycle(int k) {
+  Level& level = myLevels[k];
+
+  //	coarsest
+  if (k == levels() - 1) {
+    if (level.lu.empty()) {
+      for (int n = 0; n < 8; ++n) smooth(level, true);
+      return;
+    }
+    mMatrix<double> x(level.nx * level.ny, 1);
+    for (int n = 0; n < x.size(); ++n) x[n] = level.f[n];
+    mMatrixAlgebra::luSolve(level.lu, level.pivots, x);
+    for (int n = 0; n < x.size(); ++n) level.u[n] = x[n];
+    return;
+  }
+
+  for (int n = 0; n < mySettings.preSmooth; ++n) smooth(level, true);
+
+  //	coarse correction from zero
+  residual(level, level.f, level.u, level.r);
+  Level& coarse = myLevels[k + 1];
+  restriction(level, coarse, level.r, coarse.f);
+  coarse.u = 0.0;
+  const int visits = mySettings.cycle == MultigridCycle::W ? 2 : 1;
+  for (int n = 0; n < visits; ++n) cycle(k + 1);
+  prolongate(level, coarse, coarse.u, level.u);
+
+  for (int n = 0; n < mySettings.postSmooth; ++n) smooth(level, false);
+}
+
+void Multigrid2d::cycle(const mMatrix<double>& f, mMatrix<double>& u) {
+  Level& fine = myLevels[0];
+  for (int n = 0; n < f.size(); ++n) fine.f[n] = f[n];
+  for (int n = 0; n < u.size(); ++n) fine.u[n] = u[n];
+  cycle(0);
+  for (int n = 0; n < u.size(); ++n) u[n] = fine.u[n];
+}
+
+int Multigrid2d::solve(const mMatrix<double>& f, mMatrix<double>& u) {
+  Level& fine = myLevels[0];
+  const double scale = max(maxNorm(f), 1.0e-300);
+
+  int iterations = 0;
+  residual(fine, f, u, fine.r);
+  myResidual = maxNorm(fine.r) / scale;
+  while (myResidual > mySettings.tolerance &&
+         iterations < mySettings.maxIterations) {
+    cycle(f, u);
+    residual(fine, f, u, fine.r);
+    myResidual = maxNorm(fine.r) / scale;
+    ++iterations;
+  }
+
+  //	done
+  return iterations;
+}
+
+void Multigrid2d::apply(const mMatrix<double>& u,
+                        mMatrix<double>& res) const {
+  const Level& fine = myLevels[0];
+  res.resize(fine.nx, fine.ny, 0.0);
+  residual(fine, mMatrix<double>(), u, res);
+  for (int n = 0; n < res.size(); ++n) res[n] = -res[n];
+}
+
+int Multigrid2d::bicgstab(const mMatrix<double>& f, mMatrix<double>& u) {
+  Level& fine = myLevels[0];
+  const int n = u.size();
+  const double scale = max(maxNorm(f), 1.0e-300);
+  for (mMatrix<double>* v : {&myR, &myRHat, &myP, &myV, &myS, &myT, &myY,
+                             &myZ}) {
+    v->resize(fine.nx, fine.ny, 0.0);
+    *v = 0.0;
+  }
+
+  //	K x: one cycle from zero
+  auto precondition = [&](const mMatrix<double>& x, mMatrix<double>& res) {
+    res = 0.0;
+    cycle(x, res);
+  };
+
+  residual(fine, f, u, myR);
+  myRHat = myR;
+  double rho = 1.0, alpha = 1.0, omega = 1.0;
+  myResidual = maxNorm(myR) / scale;
+
+  int iterations = 0;
+  while (myResidual > mySettings.tolerance &&
+         iterations < mySettings.maxIterations) {
+    ++iterations;
+    const double rhoNew = dot(myRHat, myR);
+    const double beta = rhoNew / rho * alpha / omega;
+    rho = rhoNew;
+    for (int k = 0; k < n; ++k)
+      myP[k] = myR[k] + beta * (myP[k] - omega * myV[k]);
+
+    precondition(myP, myY);
+    apply(myY, myV);
+    alpha = rho / dot(myRHat, myV);
+    for (int k = 0; k < n; ++k) myS[k] = myR[k] - alpha * myV[k];
+    if (maxNorm(myS) / scale <= mySettings.tolerance) {
+      for (int k = 0; k < n; ++k) u[k] += alpha * myY[k];
+      myResidual = maxNorm(myS) / scale;
+      break;
+    }
+
+    precondition(myS, myZ);
+    apply(myZ, myT);
+    omega = dot(myT, myS) / dot(myT, myT);
+    for (int k = 0; k < n; ++k) {
+      u[k] += alpha * myY[k] + omega * myZ[k];
+      myR[k] = myS[k] - omega * myT[k];
+    }
+    myResidual = maxNorm(myR) / scale;
+  }
+
+  //	done
+  return iterations;
+}
+
+ImplicitSolver2d::ImplicitSolver2d(
+    const FdmOperator2d& op, double theta, bool krylov,
+    const MultigridSettings& settings,
+    const function<void(FdmOperator2d&)>& rebuild)
+    : myOp(&op),
+      myTheta(theta),
+      myKrylov(krylov),
+      myMultigrid(op, settings, rebuild) {}
+
+void ImplicitSolver2d::step(mMatrix<double>& u, double dt, double theta) {
+  const double thetaDt = theta * dt;
+  if (!mySetup || myMultigrid.thetaDt() != thetaDt) {
+    myMultigrid.setup(thetaDt);
+    mySetup = true;
+  }
+
+  //	explicit part u + (1 - theta) dt A u
+  const int nx = u.rows();
+  const int ny = u.cols();
+  myRhs.resize(nx, ny, 0.0);
+  myA0.resize(nx, ny, 0.0);
+  myA1.resize(nx, ny, 0.0);
+  myA2.resize(nx, ny, 0.0);
+  const double w = (1.0 - theta) * dt;
+  if (w != 0.0) {
+    myOp->applyMixed(u, myA0);
+    myOp->applyX(u, myA1);
+    myOp->applyY(u, myA2);
+  }
+  for (int k = 0; k < u.size(); ++k)
+    myRhs[k] = w != 0.0 ? u[k] + w * (myA0[k] + myA1[k] + myA2[k]) : u[k];
+
+  //	implicit part from u as initial guess
+  myIterations += myKrylov ? myMultigrid.bicgstab(myRhs, u)
+                           : myMultigrid.solve(myRhs, u);
+}
+
+void ImplicitSolver2d::step(mMatrix<double>& u, double dt) {
+  step(u, dt, myTheta);
+}
+
+void ImplicitSolver2d::rollback(mMatrix<double>& u, double expiry,
+                                int timeSteps, int dampingSteps) {
+  const double dt = expiry / timeSteps;
+  dampingSteps = min(dampingSteps, timeSteps);
+
+  //	implicit half steps
+  for (int n = 0; n < 2 * dampingSteps; ++n) step(u, 0.5 * dt, 1.0);
+
+  for (int n = dampingSteps; n < timeSteps; ++n) step(u, dt, myTheta);
+}
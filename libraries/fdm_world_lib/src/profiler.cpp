@@ -0,0 +1,52 @@
+#include "profiler.hpp"
+
+#include <cstdio>
+
+int Profiler::find(const string& section) const {
+  for (int k = 0; k < (int)myNames.size(); ++k)
+    if (myNames[k] == section) return k;
+  return -1;
+}
+
+void Profiler::add(const string& section, double seconds) {
+  int k = find(section);
+  if (k < 0) {
+    myNames.push_back(section);
+    mySeconds.push_back(0.0);
+    myCalls.push_back(0);
+    k = (int)myNames.size() - 1;
+  }
+  mySeconds[k] += seconds;
+  ++myCalls[k];
+}
+
+double Profiler::seconds(const string& section) const {
+  const int k = find(section);
+  return k < 0 ? 0.0 : mySeconds[k];
+}
+
+int Profiler::calls(const string& section) const {
+  const int k = find(section);
+  return k < 0 ? 0 : myCalls[k];
+}
+
+void Profiler::reset() {
+  myNames.clear();
+  mySeconds.clear();
+  myCalls.clear();
+}
+
+string Profiler::report() const {
+  string res;
+  char line[128];
+  for (int k = 0; k < (int)myNames.size(); ++k) {
+    const double ms = 1.0e3 * mySeconds[k];
+    std::snprintf(line, sizeof(line), "%-16s %10.3f ms %8d calls %10.4f ms\n",
+                  myNames[k].c_str(), ms, myCalls[k],
+                  myCalls[k] ? ms / myCalls[k] : 0.0);
+    res += line;
+  }
+
+  //	done
+  return res;
+}
@@ -0,0 +1,147 @@
+#include "revolve.hpp"
+
+#include <cstdio>
+
+Revolve::Revolve(int steps, int budget) {
+  myStats.steps = max(steps, 0);
+  myStats.budget = max(budget, 1);
+
+  const int free = myStats.budget - 1;
+  myStats.repetitions = repetitions(myStats.steps, free);
+
+  //	dry run for the counts
+  if (myStats.steps > 0) {
+    myStats.stores = firstBranch(nullptr, nullptr);
+    run(0, myStats.steps, 0, free, true, false, nullptr, nullptr, nullptr,
+        nullptr, myStats);
+  }
+}
+
+double Revolve::reversible(int free, int repetitions) {
+  //	C(free + r + 1, free + 1) as a product, exact while it fits a double
+  const int k = min(free + 1, repetitions);
+  double res = 1.0;
+  for (int i = 1; i <= k; ++i)
+    res = res * (free + repetitions + 2 - i) / i;
+
+  //	done
+  return res;
+}
+
+int Revolve::repetitions(int n, int free) {
+  int r = 0;
+  while (reversible(free, r) < n) ++r;
+
+  //	done
+  return r;
+}
+
+int Revolve::split(int n, int free) {
+  //	with r the repetitions n needs, the left part can take at most
+  //	C(free + r, free + 1) steps with one repetition less, and the right
+  //	part with one checkpoint less is filled up to what r - 1 repetitions
+  //	reverse, which minimises the total recomputation (Griewank and Walther
+  //	2000)
+  const int r = repetitions(n, free);
+  const double left = reversible(free, r - 1);
+  const double right = reversible(free - 1, r - 1);
+  const int l = (int)min(left, max(1.0, n - right));
+
+  //	done
+  return max(1, min(l, n - 1));
+}
+
+void Revolve::run(int a, int b, int slot, int free, bool spine,
+                  bool current, const function<void(int)>* store,
+                  const function<void(int)>* restore,
+                  const function<void(int, int)>* advance,
+                  const function<void(int)>* reverse,
+                  RevolveStats& stats) const {
+  const int n = b - a;
+
+  //	no checkpoint left: from the state of a for every step
+  if (n == 1 || free == 0) {
+    for (int k = b - 1; k >= a; --k) {
+      if (!current) {
+        ++stats.restores;
+        if (restore) (*restore)(slot);
+      }
+      current = false;
+      if (k > a) {
+        stats.advances += k - a;
+        if (advance) (*advance)(a, k);
+      }
+      if (reverse) (*reverse)(k);
+    }
+    return;
+  }
+
+  const int m = a + split(n, free);
+
+  //	on the first branch the forward sweep has stored m already
+  if (!spine) {
+    if (!current) {
+      ++stats.restores;
+      if (restore) (*restore)(slot);
+    }
+    ++stats.stores;
+    stats.advances += m - a;
+    if (advance) (*advance)(a, m);
+    if (store) (*store)(slot + 1);
+  }
+
+  run(m, b, slot + 1, free - 1, spine, !spine, store, restore, advance,
+      reverse, stats);
+  run(a, m, slot, free, false, false, store, restore, advance, reverse,
+      stats);
+}
+
+int Revolve::firstBranch(const function<void(int)>* store,
+                         const function<void(int, int)>* advance) const {
+  const int n = steps();
+  int a = 0;
+  int slot = 0;
+  int free = budget() - 1;
+
+  //	the split points of the first branch of run() down to its last part
+  if (store) (*store)(slot);
+  while (n - a > 1 && free > 0) {
+    const int m = a + split(n - a, free);
+    if (advance) (*advance)(a, m);
+    if (store) (*store)(++slot);
+    a = m;
+    --free;
+  }
+  if (advance) (*advance)(a, n);
+
+  //	done
+  return slot + 1;
+}
+
+void Revolve::forward(const function<void(int)>& store,
+                      const function<void(int, int)>& advance) const {
+  if (steps() > 0) firstBranch(&store, &advance);
+}
+
+void Revolve::reverse(const function<void(int)>& store,
+                      const function<void(int)>& restore,
+                      const function<void(int, int)>& advance,
+                      const function<void(int)>& reverse) const {
+  if (steps() == 0) return;
+  RevolveStats stats;
+  run(0, steps(), 0, budget() - 1, true, false, &store, &restore, &advance,
+      &reverse, stats);
+}
+
+string Revolve::report() const {
+  char line[160];
+  std::snprintf(line, sizeof(line),
+                "%d steps, %d states, %d repetitions, %d recomputed steps "
+                "(%.2f per step), %d stores, %d restores",
+                myStats.steps, myStats.budget, myStats.repetitions,
+                myStats.advances, myStats.overhead(), myStats.stores,
+                myStats.restores);
+
+  //	done
+  return line;
+}
@@ -0,0 +1,130 @@
+#include "sliceSolver.hpp"
+
+#include <cmath>
+#include <utility>
+
+#include "constants.hpp"
+
+SliceSolver::SliceSolver(const FdmOperator1d& op, double theta,
+                         ThreadPool* pool)
+    : myOp(&op), myTheta(theta), myPool(pool) {
+  const int threads = myPool ? myPool->numThreads() : 1;
+  myRows.resize(threads, op.size());
+}
+
+void SliceSolver::factorize(double thetaDt) {
+  if (myImplicit.factorized() && myThetaDt == thetaDt &&
+      myVersion == myOp->version())
+    return;
+
+  myOp->implicitMatrix(thetaDt, myImplicit);
+  myThetaDt = thetaDt;
+  myVersion = myOp->version();
+}
+
+void SliceSolver::parallelFor(int size,
+                              const function<void(int, int, int)>& func) {
+  if (myPool)
+    myPool->parallelFor(size, func);
+  else
+    func(0, 0, size);
+}
+
+void SliceSolver::step(mMatrix<double>& u, double dt, double theta) {
+  factorize(theta * dt);
+
+  const int n = u.cols();
+  const Tridiagonal<double>& L = myOp->matrix();
+  const double w = (1.0 - theta) * dt;
+
+  parallelFor(u.rows(), [&](int thread, int begin, int end) {
+    double* r = &myRows(thread, 0);
+    for (int j = begin; j < end; ++j) {
+      //	explicit part into the thread row, implicit solve in place
+      double* v = &u(j, 0);
+      r[0] = (1.0 + w * L.diag(0)) * v[0] + w * L.upper(0) * v[min(1, n - 1)];
+      for (int i = 1; i < n - 1; ++i)
+        r[i] = w * L.lower(i) * v[i - 1] + (1.0 + w * L.diag(i)) * v[i] +
+               w * L.upper(i) * v[i + 1];
+      if (n > 1)
+        r[n - 1] = w * L.lower(n - 1) * v[n - 2] +
+                   (1.0 + w * L.diag(n - 1)) * v[n - 1];
+      for (int i = 0; i < n; ++i) v[i] = r[i];
+      myImplicit.solve(u(j));
+    }
+  });
+}
+
+void SliceSolver::fix(const FdmGrid& a, int k, const FdmFixing& update,
+                      mMatrix<double>& u) {
+  const FdmGrid& x = myOp->x();
+  const int n = u.cols();
+  myFixed.resize(u.rows(), n);
+
+  //	every target row reads the old rows around the updated state
+  parallelFor(u.rows(), [&](int, int begin, int end) {
+    double w[4];
+    int order;
+    for (int j = begin; j < end; ++j) {
+      double* res = &myFixed(j, 0);
+      for (int i = 0; i < n; ++i) {
+        const double state =
+            max(a.front(), min(a.back(), update(k, a[j], x[i])));
+        const int j0 = a.lagrangeWeights(state, w, order);
+        double v = 0.0;
+        for (int l = 0; l < order; ++l) v += w[l] * u(j0 + l, i);
+        res[i] = v;
+      }
+    }
+  });
+
+  std::swap(u, myFixed);
+}
+
+void SliceSolver::rollback(mMatrix<double>& u, const FdmGrid& a,
+                           double expiry, int timeSteps, int dampingSteps,
+                           const mVector<double>& fixings,
+                           const FdmFixing& update) {
+  mVector<double> mandatory(fixings.size() + 1, expiry);
+  for (int k = 0; k < fixings.size(); ++k) mandatory[k] = fixings[k];
+  const FdmTimeGrid times =
+      FdmTimeGrid::make(mandatory, timeSteps, myTheta, 0);
+
+  //	fixings from the last one backwards
+  int next = fixings.size() - 1;
+  auto fixAt = [&](double t) {
+    const double tol = Constants::epsilon() * max(1.0, t);
+    while (next >= 0 && fixings[next] >= t - tol) {
+      if (std::fabs(fixings[next] - t) <= tol) fix(a, next, update, u);
+      --next;
+    }
+  };
+
+  const int steps = times.steps();
+  fixAt(times.time(steps));
+  for (int k = steps - 1; k >= 0; --k) {
+    const double dt = times.dt(k);
+    if (steps - 1 - k < dampingSteps) {
+      step(u, 0.5 * dt, 1.0);
+      step(u, 0.5 * dt, 1.0);
+    } else {
+      step(u, dt, myTheta);
+    }
+    fixAt(times.time(k));
+  }
+}
+
+double SliceSolver::valueAt(const FdmGrid& a, const FdmGrid& x,
+                            const mMatrix<double>& u, double a0, double x0) {
+  double wa[4], wx[4];
+  int na, nx;
+  const int j0 = a.lagrangeWeights(a0, wa, na);
+  const int i0 = x.lagrangeWeights(x0, wx, nx);
+
+  double res = 0.0;
+  for (int l = 0; l < na; ++l)
+    for (int m = 0; m < nx; ++m) res += wa[l] * wx[m] * u(j0 + l, i0 + m);
+
+  //	done
+  return res;
+}
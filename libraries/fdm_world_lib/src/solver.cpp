@@ -1,5 +1,11 @@
 #include "solver.hpp"
 
+#include <chrono>
+#include <cmath>
+
+#include "constants.hpp"
+#include "mMatrixAlgebra.hpp"
+
 bool Solver::newtonRaphson(SolverObjective& obj, double& x, int& numIter,
                            double& epsilon, string* error) {
   int i{};
@@ -17,4 +23,159 @@ bool Solver::newtonRaphson(SolverObjective& obj, double& x, int& numIter,
   epsilon = obj.value(x);
 
   return true;
-}
\ No newline at end of file
+}
+
+namespace {
+
+//	x clamped to the bounds of the settings
+void clamp(const LevenbergMarquardtSettings& settings, mVector<double>& x) {
+  for (int j = 0; j < x.size(); ++j) {
+    if (!settings.lower.empty()) x[j] = max(x[j], settings.lower[j]);
+    if (!settings.upper.empty()) x[j] = min(x[j], settings.upper[j]);
+  }
+}
+
+double halfSquare(const mVector<double>& r) {
+  double res = 0.0;
+  for (int i = 0; i < r.size(); ++i) res += r[i] * r[i];
+
+  //	done
+  return 0.5 * res;
+}
+
+}  // namespace
+
+bool Solver::levenbergMarquardt(LeastSquaresObjective& obj, mVector<double>& x,
+                                const LevenbergMarquardtSettings& settings,
+                                LevenbergMarquardtReport* report) {
+  const auto start = std::chrono::steady_clock::now();
+  const int n = x.size();
+  const double tol = settings.tolerance;
+  clamp(settings, x);
+
+  mVector<double> r, rTrial;
+  obj.values(x, r);
+  const int m = r.size();
+  double cost = halfSquare(r);
+  int evaluations = 1;
+
+  //	per thread point and residuals of the finite differences
+  const int threads = settings.pool ? settings.pool->numThreads() : 1;
+  vector<mVector<double>> xs(threads), rs(threads);
+
+  mMatrix<double> jac, a(n, n), l(n, n), dx(n, 1);
+  mVector<double> g(n), xTrial(n);
+  double lambda = settings.lambda, nu = 2.0;
+  bool converged = false, stalled = false;
+  int iter = 0;
+
+  while (iter < settings.maxIterations && !converged && !stalled) {
+    ++iter;
+
+    //	jacobian, analytic or one finite difference per column
+    jac.resize(m, n);
+    if (!obj.jacobian(x, jac)) {
+      auto columns = [&](int thread, int begin, int end) {
+        mVector<double>& xt = xs[thread];
+        mVector<double>& rt = rs[thread];
+        xt = x;
+        for (int j = begin; j < end; ++j) {
+          double h = settings.bump * max(std::fabs(x[j]), 1.0);
+          if (!settings.upper.empty() && x[j] + h > settings.upper[j]) h = -h;
+          xt[j] = x[j] + h;
+          obj.values(xt, rt);
+          xt[j] = x[j];
+          for (int i = 0; i < m; ++i) jac(i, j) = (rt[i] - r[i]) / h;
+        }
+      };
+      if (settings.pool)
+        settings.pool->parallelFor(n, columns);
+      else
+        columns(0, 0, n);
+      evaluations += n;
+    }
+
+    //	J^T J (lower half) and J^T r
+    a = 0.0;
+    g = 0.0;
+    for (int i = 0; i < m; ++i) {
+      const double* ji = &jac(i, 0);
+      for (int p = 0; p < n; ++p) {
+        g[p] += ji[p] * r[i];
+        double* ap = &a(p, 0);
+        for (int q = 0; q <= p; ++q) ap[q] += ji[p] * ji[q];
+      }
+    }
+    for (int p = 0; p < n; ++p)
+      for (int q = 0; q < p; ++q) a(q, p) = a(p, q);
+
+    double gMax = 0.0;
+    for (int p = 0; p < n; ++p) gMax = max(gMax, std::fabs(g[p]));
+    if (gMax <= tol || cost == 0.0) {
+      converged = true;
+      break;
+    }
+
+    //	damped steps until the cost decreases
+    while (true) {
+      l = a;
+      for (int p = 0; p < n; ++p)
+        l(p, p) += lambda * max(a(p, p), Constants::dblPrecision());
+
+      if (mMatrixAlgebra::cholesky(l)) {
+        for (int p = 0; p < n; ++p) dx(p, 0) = -g[p];
+        mMatrixAlgebra::choleskySolve(l, dx);
+        for (int p = 0; p < n; ++p) xTrial[p] = x[p] + dx(p, 0);
+        clamp(settings, xTrial);
+        obj.values(xTrial, rTrial);
+        ++evaluations;
+        const double trial = halfSquare(rTrial);
+
+        //	gain against the quadratic model on the clamped step s
+        double predicted = 0.0, step = 0.0, size = 0.0;
+        for (int p = 0; p < n; ++p) {
+          const double sp = xTrial[p] - x[p];
+          double as = 0.0;
+          for (int q = 0; q < n; ++q) as += a(p, q) * (xTrial[q] - x[q]);
+          predicted -= sp * (g[p] + 0.5 * as);
+          step += sp * sp;
+          size += x[p] * x[p];
+        }
+        const double rho = (cost - trial) / predicted;
+
+        if (std::isfinite(trial) && predicted > 0.0 && rho > 0.0) {
+          x = xTrial;
+          std::swap(r, rTrial);
+          cost = trial;
+          const double c = 2.0 * rho - 1.0;
+          lambda *= max(1.0 / 3.0, 1.0 - c * c * c);
+          nu = 2.0;
+          converged = std::sqrt(step) <= tol * (std::sqrt(size) + tol);
+          break;
+        }
+      }
+
+      lambda *= nu;
+      nu *= 2.0;
+      if (lambda > 1.0 / Constants::dblPrecision()) {
+        stalled = true;
+        break;
+      }
+    }
+  }
+
+  if (report) {
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    report->iterations = iter;
+    report->evaluations = evaluations;
+    report->cost = cost;
+    report->lambda = lambda;
+    report->seconds = elapsed.count();
+    report->secondsPerIteration = iter ? elapsed.count() / iter : 0.0;
+    report->converged = converged;
+  }
+
+  //	done
+  return converged;
+}
@@ -0,0 +1,63 @@
+#include "sparseGrid.hpp"
+
+#include <atomic>
+
+namespace {
+
+//	every l >= 0 with |l| = sum in dim directions, appended to res
+void compositions(int dim, int sum, double coefficient, vector<int>& levels,
+                  vector<SparseGridTerm>& res) {
+  const int d = (int)levels.size();
+  if (d == dim - 1) {
+    levels.push_back(sum);
+    res.push_back(SparseGridTerm{levels, coefficient});
+    levels.pop_back();
+    return;
+  }
+  for (int l = sum; l >= 0; --l) {
+    levels.push_back(l);
+    compositions(dim, sum - l, coefficient, levels, res);
+    levels.pop_back();
+  }
+}
+
+}  // namespace
+
+void SparseGrid::terms(int dim, int level, vector<SparseGridTerm>& res) {
+  res.clear();
+  if (dim <= 0) return;
+
+  //	diagonals |l| = n - q, the binomial built up along q
+  vector<int> levels;
+  double binomial = 1.0;
+  for (int q = 0; q < dim && q <= level; ++q) {
+    compositions(dim, level - q, q % 2 ? -binomial : binomial, levels, res);
+    binomial = binomial * (dim - 1 - q) / (q + 1);
+  }
+}
+
+double SparseGrid::combine(int dim, int level,
+                           const function<double(const vector<int>&)>& solve,
+                           ThreadPool* pool, mVector<double>* values) {
+  vector<SparseGridTerm> grids;
+  terms(dim, level, grids);
+  const int n = (int)grids.size();
+  mVector<double> res(n, 0.0);
+
+  //	dynamic schedule, the sub-grids differ in cost
+  std::atomic<int> next{0};
+  auto run = [&](int, int, int) {
+    for (int k = next++; k < n; k = next++) res[k] = solve(grids[k].levels);
+  };
+  if (pool)
+    pool->parallelFor(pool->numThreads(), run);
+  else
+    run(0, 0, n);
+
+  double sum = 0.0;
+  for (int k = 0; k < n; ++k) sum += grids[k].coefficient * res[k];
+  if (values) *values = std::move(res);
+
+  //	done
+  return sum;
+}
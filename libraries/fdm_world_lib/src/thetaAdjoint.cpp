@@ -0,0 +1,119 @@
+#include "thetaAdjoint.hpp"
+
+#include <cmath>
+
+namespace {
+
+int defaultBudget(int steps, int budget) {
+  if (budget > 0) return budget;
+  return max(2, (int)std::ceil(2.0 * std::sqrt((double)steps)));
+}
+
+}  // namespace
+
+ThetaAdjoint::ThetaAdjoint(FdmOperator1d& op, const mVector<double>& dts,
+                           const mVector<double>& thetas,
+                           const function<void(int)>& refresh, int budget)
+    : myOp(&op),
+      myDts(dts),
+      myThetas(thetas),
+      myRefresh(refresh),
+      myRevolve(dts.size(), defaultBudget(dts.size(), budget)) {
+  myCheckpoints.resize(myRevolve.budget(), op.size());
+}
+
+void ThetaAdjoint::factorize(double thetaDt) {
+  if (myImplicit.factorized() && myThetaDt == thetaDt &&
+      myVersion == myOp->version())
+    return;
+
+  myOp->implicitMatrix(thetaDt, myImplicit);
+  myThetaDt = thetaDt;
+  myVersion = myOp->version();
+}
+
+void ThetaAdjoint::step(int k, const double* v, double* y) {
+  myRefresh(k);
+  const double dt = myDts[k];
+  const double theta = myThetas[k];
+  factorize(theta * dt);
+
+  const int n = myOp->size();
+  const Tridiagonal<double>& L = myOp->matrix();
+  const double w = (1.0 - theta) * dt;
+  for (int i = 0; i < n; ++i) {
+    double r = (1.0 + w * L.diag(i)) * v[i];
+    if (i > 0) r += w * L.lower(i) * v[i - 1];
+    if (i < n - 1) r += w * L.upper(i) * v[i + 1];
+    y[i] = r;
+  }
+  myImplicit.solve(mVectorView<double>(y, n));
+}
+
+void ThetaAdjoint::advance(mVector<double>& u, int from, int to) {
+  myNext.resize(u.size());
+  for (int k = from; k < to; ++k) {
+    step(k, &u[0], &myNext[0]);
+    std::swap(u, myNext);
+  }
+}
+
+void ThetaAdjoint::rollback(mVector<double>& u) {
+  const int n = u.size();
+  myRevolve.forward(
+      [&](int slot) {
+        for (int i = 0; i < n; ++i) myCheckpoints(slot, i) = u[i];
+      },
+      [&](int from, int to) { advance(u, from, to); });
+}
+
+void ThetaAdjoint::adjoint(mVector<double>& lambda,
+                           const FdmStepGradient& gradient) {
+  const int n = lambda.size();
+  myState.resize(n);
+  myNext.resize(n);
+  myMu.resize(n);
+  myZ.resize(n);
+  myDz.resize(n);
+  myTmp.resize(n);
+  mVector<double> scaleBar(n, 0.0);
+
+  //	the current state is the one before step k: record the step into
+  //	myNext and reverse it
+  auto reverse = [&](int k) {
+    const double* v = &myState[0];
+    const double* y = &myNext[0];
+    step(k, v, &myNext[0]);
+
+    const double dt = myDts[k];
+    const double theta = myThetas[k];
+
+    //	mu = B^-T lambda
+    for (int i = 0; i < n; ++i) myMu[i] = lambda[i];
+    myImplicit.solveTranspose(myMu);
+
+    //	d(lambda . y) = mu . dL z with z = theta dt y + (1 - theta) dt v
+    double discountBar = 0.0;
+    for (int i = 0; i < n; ++i) {
+      myZ[i] = theta * dt * y[i] + (1.0 - theta) * dt * v[i];
+      if (!myOp->frozen(i)) discountBar -= myMu[i] * myZ[i];
+    }
+    myOp->applyDiffusion(myZ, myDz);
+    for (int i = 0; i < n; ++i) scaleBar[i] = myMu[i] * myDz[i];
+    gradient(k, scaleBar, discountBar);
+
+    //	lambda = E^T mu
+    myOp->matrix().applyTranspose(myMu, myTmp);
+    const double w = (1.0 - theta) * dt;
+    for (int i = 0; i < n; ++i) lambda[i] = myMu[i] + w * myTmp[i];
+  };
+
+  myRevolve.reverse(
+      [&](int slot) {
+        for (int i = 0; i < n; ++i) myCheckpoints(slot, i) = myState[i];
+      },
+      [&](int slot) {
+        for (int i = 0; i < n; ++i) myState[i] = myCheckpoints(slot, i);
+      },
+      [&](int from, int to) { advance(myState, from, to); }, reverse);
+}
@@ -0,0 +1,124 @@
+#include "thetaScheme.hpp"
+
+#include <utility>
+
+ThetaSolver::ThetaSolver(const FdmOperator1d& op, double theta)
+    : myOp(&op), myTheta(theta) {}
+
+void ThetaSolver::factorize(double thetaDt) {
+  if (myImplicit.factorized() && myThetaDt == thetaDt &&
+      myVersion == myOp->version())
+    return;
+
+  myOp->implicitMatrix(thetaDt, myImplicit);
+  myThetaDt = thetaDt;
+  myVersion = myOp->version();
+}
+
+void ThetaSolver::step(mMatrix<double>& u, double dt, double theta) {
+  factorize(theta * dt);
+
+  //	explicit part M u + (1 - theta) dt L u, one pass over the rows
+  const int n = u.rows();
+  const int m = u.cols();
+  const Tridiagonal<double>& L = myOp->matrix();
+  const Tridiagonal<double>& M = myOp->mass();
+  const double w = (1.0 - theta) * dt;
+  myRhs.resize(n, m);
+  for (int i = 0; i < n; ++i) {
+    const double l = i > 0 ? M.lower(i) + w * L.lower(i) : 0.0;
+    const double d = M.diag(i) + w * L.diag(i);
+    const double h = i < n - 1 ? M.upper(i) + w * L.upper(i) : 0.0;
+    const double* um = &u(max(i - 1, 0), 0);
+    const double* uc = &u(i, 0);
+    const double* up = &u(min(i + 1, n - 1), 0);
+    double* r = &myRhs(i, 0);
+    for (int k = 0; k < m; ++k) r[k] = l * um[k] + d * uc[k] + h * up[k];
+  }
+
+  //	implicit part, all columns against the same factors
+  myImplicit.solve(myRhs);
+  std::swap(u, myRhs);
+}
+
+void ThetaSolver::step(mMatrix<double>& u, double dt) { step(u, dt, myTheta); }
+
+void ThetaSolver::rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                           int dampingSteps) {
+  const double dt = expiry / timeSteps;
+  dampingSteps = min(dampingSteps, timeSteps);
+
+  //	implicit half steps
+  for (int n = 0; n < 2 * dampingSteps; ++n) step(u, 0.5 * dt, 1.0);
+
+  for (int n = dampingSteps; n < timeSteps; ++n) step(u, dt, myTheta);
+}
+
+void ThetaSolver::rollback(mMatrix<double>& u, double expiry, int timeSteps,
+                           int dampingSteps,
+                           const FdmEventSchedule& events) {
+  //	calendar nodes on expiry and every event date before it
+  const mVector<double> dates = events.times();
+  vector<double> stops{expiry};
+  for (int k = 0; k < dates.size(); ++k)
+    if (dates[k] > 0.0 && dates[k] < expiry) stops.push_back(dates[k]);
+  mVector<double> mandatory(stops.size(), 0.0);
+  for (int k = 0; k < (int)stops.size(); ++k) mandatory[k] = stops[k];
+  const FdmTimeGrid times =
+      FdmTimeGrid::make(mandatory, timeSteps, myTheta, 0);
+
+  const FdmGrid& x = myOp->x();
+  const int steps = times.steps();
+  int damping = dampingSteps;
+  if (events.apply(times.time(steps), x, u, myEventScratch))
+    damping = dampingSteps;
+
+  for (int k = steps - 1; k >= 0; --k) {
+    const double dt = times.dt(k);
+    if (damping > 0) {
+      step(u, 0.5 * dt, 1.0);
+      step(u, 0.5 * dt, 1.0);
+      --damping;
+    } else {
+      step(u, dt, myTheta);
+    }
+    if (events.apply(times.time(k), x, u, myEventScratch))
+      damping = dampingSteps;
+  }
+}
+
+void ThetaSolver::rollback(mMatrix<double>& u, const FdmTimeGrid& times,
+                           int lastNode) {
+  for (int k = lastNode - 1; k >= 0; --k)
+    step(u, times.dt(k), times.theta(k));
+}
+
+void ThetaSolver::greeks(const FdmOperator1d& op, const mMatrix<double>& u,
+                         double x0, FdmGreeks& res) {
+  double w[4], d1[4], d2[4];
+  int order;
+  const int i0 = op.x().lagrangeWeights(x0, w, d1, d2, order);
+
+  const int n = u.rows();
+  const int m = u.cols();
+  res.value.assign(m, 0.0);
+  res.delta.assign(m, 0.0);
+  res.gamma.assign(m, 0.0);
+  res.theta.assign(m, 0.0);
+
+  const Tridiagonal<double>& L = op.matrix();
+  for (int k = 0; k < order; ++k) {
+    const int i = i0 + k;
+    const double* um = &u(max(i - 1, 0), 0);
+    const double* uc = &u(i, 0);
+    const double* up = &u(min(i + 1, n - 1), 0);
+    const double l = i > 0 ? L.lower(i) : 0.0;
+    const double h = i < n - 1 ? L.upper(i) : 0.0;
+    for (int j = 0; j < m; ++j) {
+      res.value[j] += w[k] * uc[j];
+      res.delta[j] += d1[k] * uc[j];
+      res.gamma[j] += d2[k] * uc[j];
+      res.theta[j] -= w[k] * (l * um[j] + L.diag(i) * uc[j] + h * up[j]);
+    }
+  }
+}
@@ -0,0 +1,81 @@
+#include "threadPool.hpp"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(int numThreads) {
+  if (numThreads <= 0)
+    numThreads = std::max(1, (int)std::thread::hardware_concurrency());
+
+  myWorkers.reserve(numThreads - 1);
+  for (int t = 1; t < numThreads; ++t)
+    myWorkers.emplace_back(&ThreadPool::workerLoop, this, t);
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myStop = true;
+  }
+  myStart.notify_all();
+  for (auto& w : myWorkers) w.join();
+}
+
+void ThreadPool::chunk(int size, int numThreads, int align, int thread,
+                       int& begin, int& end) {
+  //	equal chunks rounded up to the alignment
+  int per = (size + numThreads - 1) / numThreads;
+  per = ((per + align - 1) / align) * align;
+  begin = std::min(thread * per, size);
+  end = std::min(begin + per, size);
+}
+
+void ThreadPool::runChunk(int thread) {
+  int begin, end;
+  chunk(mySize, numThreads(), myAlign, thread, begin, end);
+  if (begin < end) (*myJob)(thread, begin, end);
+}
+
+void ThreadPool::parallelFor(int size,
+                             const function<void(int, int, int)>& func,
+                             int align) {
+  if (myWorkers.empty() || size <= align) {
+    if (size > 0) func(0, 0, size);
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(myMutex);
+    myJob = &func;
+    mySize = size;
+    myAlign = align;
+    myPending = (int)myWorkers.size();
+    ++myGeneration;
+  }
+  myStart.notify_all();
+
+  //	calling thread takes the first chunk
+  runChunk(0);
+
+  std::unique_lock<std::mutex> lock(myMutex);
+  myDone.wait(lock, [this] { return myPending == 0; });
+  myJob = nullptr;
+}
+
+void ThreadPool::workerLoop(int thread) {
+  long seen = 0;
+  for (;;) {
+    {
+      std::unique_lock<std::mutex> lock(myMutex);
+      myStart.wait(lock, [&] { return myStop || myGeneration != seen; });
+      if (myStop) return;
+      seen = myGeneration;
+    }
+
+    runChunk(thread);
+
+    {
+      std::lock_guard<std::mutex> lock(myMutex);
+      if (--myPending == 0) myDone.notify_one();
+    }
+  }
+}